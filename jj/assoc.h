@@ -0,0 +1,135 @@
+#ifndef jjassoc_h
+#define jjassoc_h
+
+#include <stddef.h>
+
+namespace jj {
+
+class Assoc {
+public:
+  class Left;
+  class Right;
+  class Rights;
+  class Lefts;
+
+  /* link record, in the ring of its Left and in the ring of its Right */
+  class Link {
+    friend class Assoc;
+    friend class Assoc::Rights;
+    friend class Assoc::Lefts;
+
+    Link*   _lnext;       /* ring of _left; next free while pooled */
+    Link*   _lprev;
+    Link*   _rnext;       /* ring of _right */
+    Link*   _rprev;
+    Left*   _left;
+    Right*  _right;
+  };
+
+  class Left {
+    friend class Assoc;
+    friend class Assoc::Rights;
+
+    Link*   _links;
+    int     _num;
+
+  public:
+    Left(){_links=NULL; _num=0;}
+  };
+
+  class Right {
+    friend class Assoc;
+    friend class Assoc::Lefts;
+
+    Link*   _links;
+    int     _num;
+
+  public:
+    Right(){_links=NULL; _num=0;}
+  };
+
+private:
+  struct Chunk;
+
+  Link*     _free;        /* pooled links */
+  Chunk*    _chunks;
+  long      _num;
+
+  Link*     alloc   ();
+
+public:
+            Assoc   ();
+  virtual  ~Assoc   ();
+
+  Link*     link        (Left* l, Right* r);
+  void      unlink      (Link* k);
+  int       unlink_left (Left* l);
+  int       unlink_right(Right* r);
+  Link*     sel         (Left* l, Right* r);
+  int       num_left    (Left* l);
+  int       num_right   (Right* r);
+  long      num         ();
+  static Left*  left    (Link* k){ return k ? k->_left  : NULL; }
+  static Right* right   (Link* k){ return k ? k->_right : NULL; }
+
+  /* links of a Left; the current one may be unlinked while iterating */
+  class Rights {
+    Link*   _next;
+    Link*   _last;
+    Link*   _curr;
+  public:
+            Rights      (){ _next=_last=_curr=NULL; }
+    void    start       (Left* l){ _next=l ? l->_links : NULL; _last=_next ? _next->_lprev : NULL; _curr=NULL; }
+    Link*   link        () const { return _curr; }
+    Right*  operator++  ();
+  };
+
+  /* links of a Right; the current one may be unlinked while iterating */
+  class Lefts {
+    Link*   _next;
+    Link*   _last;
+    Link*   _curr;
+  public:
+            Lefts       (){ _next=_last=_curr=NULL; }
+    void    start       (Right* r){ _next=r ? r->_links : NULL; _last=_next ? _next->_rprev : NULL; _curr=NULL; }
+    Link*   link        () const { return _curr; }
+    Left*   operator++  ();
+  };
+};
+
+}; // jj
+
+#define jjAssoc(id, _Left, _Right) \
+class id##_class : public jj::Assoc {  \
+  static _Left*  lcast(jj::Assoc::Left* l)  { return static_cast<_Left* >(static_cast<id##_##Left* >(l)); } \
+  static _Right* rcast(jj::Assoc::Right* r) { return static_cast<_Right* >(static_cast<id##_##Right* >(r)); } \
+                                        \
+public: \
+  Link*       link        (_Left *l, _Right *r) { return jj::Assoc::link((id##_##Left *)l, (id##_##Right *)r); } \
+  void        unlink      (Link *k)             { jj::Assoc::unlink(k); } \
+  int         unlink_left (_Left *l)            { return jj::Assoc::unlink_left((id##_##Left *)l); } \
+  int         unlink_right(_Right *r)           { return jj::Assoc::unlink_right((id##_##Right *)r); } \
+  Link*       sel         (_Left *l, _Right *r) { return jj::Assoc::sel((id##_##Left *)l, (id##_##Right *)r); } \
+  int         num_left    (_Left *l)            { return jj::Assoc::num_left((id##_##Left *)l); } \
+  int         num_right   (_Right *r)           { return jj::Assoc::num_right((id##_##Right *)r); } \
+  _Left*      left        (Link *k)             { return lcast(jj::Assoc::left(k)); } \
+  _Right*     right       (Link *k)             { return rcast(jj::Assoc::right(k)); } \
+                                                                            \
+  class Rights : public jj::Assoc::Rights {  \
+  public: \
+              Rights()            {} \
+              Rights(_Left* l)    { start(l); } \
+    void      start(_Left* l)     { jj::Assoc::Rights::start((id##_##Left *)l); } \
+    _Right*   operator++()        { return rcast(jj::Assoc::Rights::operator++()); } \
+  };  \
+  class Lefts : public jj::Assoc::Lefts {  \
+  public: \
+              Lefts()             {} \
+              Lefts(_Right* r)    { start(r); } \
+    void      start(_Right* r)    { jj::Assoc::Lefts::start((id##_##Right *)r); } \
+    _Left*    operator++()        { return lcast(jj::Assoc::Lefts::operator++()); } \
+  };  \
+};    \
+extern id##_class id;
+
+#endif /* jj/assoc.h */
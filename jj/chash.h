@@ -0,0 +1,105 @@
+#ifndef jjchash_h
+#define jjchash_h
+
+#include <stddef.h>
+#include <atomic>
+#include <mutex>
+
+namespace jj {
+
+class CHash {
+public:
+  class Entry;
+  class Iter;
+
+  class Entry {
+    friend class CHash;
+    friend class CHash::Iter;
+
+    std::atomic<Entry*> _next;
+    std::atomic<int>    _hash;      /* hash_base() cached at add(); sel() reads it unlocked */
+
+  public:
+    Entry(){_next=NULL; _hash=0;}
+  };
+
+  /* one stripe of the holder; see CHash document */
+  class Table;
+  class alignas(64) Shard {
+    friend class CHash;
+    friend class CHash::Iter;
+
+    std::atomic<unsigned> _seq;     /* odd while writer is updating */
+    std::mutex            _lock;    /* serializes writers */
+    std::atomic<Table*>   _table;
+    std::atomic<int>      _num;
+    Table*                _old;     /* retired tables, freed at ~Holder */
+
+  public:
+    Shard();
+   ~Shard();
+  };
+
+  class Holder {
+    friend class CHash;
+    friend class CHash::Iter;
+
+    int       _bits;        /* log2(shard number) */
+    Shard*    _shard;
+
+  public:
+    void      init(int bits);
+
+    Holder();
+    Holder(int bits);
+   ~Holder();
+  };
+
+private:
+  virtual int hash_base (Entry* e)              = 0;
+  virtual int cmp_base  (Entry* e1, Entry* e2)  = 0;
+  Shard*      shard     (Holder* h, int hash);
+  void        expand    (Shard* s, int new_size);
+
+public:
+  void        add       (Holder* h, Entry* e);
+  void        del       (Holder* h, Entry* e);
+  Entry*      sel       (Holder* h, Entry* key);
+  int         num       (Holder* h);
+
+  class Iter {
+    Holder*   _h;
+    int       _sx,
+              _ix;
+    Entry*    _beg,
+         *    _nxt;  /* status of list */
+  public:
+    void      start(Holder*);
+    Entry*    operator++();
+  };
+};
+
+}; // jj
+
+#define jjCHash(id, _Holder, _Entry) \
+class id##_class : public jj::CHash {  \
+  int         hash_base (Entry *); \
+  int         cmp_base  (Entry *, Entry *);  \
+                                        \
+public: \
+  void        add(_Holder *h, _Entry *e)  { jj::CHash::add((id##_##Holder *)h, (id##_##Entry *)e); } \
+  void        del(_Holder *h, _Entry *e)  { jj::CHash::del((id##_##Holder *)h, (id##_##Entry *)e); } \
+  _Entry*     sel(_Holder *h, _Entry *key){ return static_cast<_Entry* >(static_cast<id##_##Entry* >(jj::CHash::sel((id##_##Holder *)h, (id##_##Entry *)key))); } \
+  int         num(_Holder *h){ return jj::CHash::num((id##_##Holder *)h); }  \
+                                                                            \
+  class Iter : public jj::CHash::Iter {  \
+  public: \
+              Iter()            : jj::CHash::Iter() {} \
+              Iter(_Holder* h)  { jj::CHash::Iter::start((id##_##Holder *)h); } \
+    void      start(_Holder* h) { jj::CHash::Iter::start((id##_##Holder *)h); } \
+    _Entry*   operator++()      { return static_cast<_Entry *>(static_cast<id##_##Entry *>(jj::CHash::Iter::operator++())); } \
+  };  \
+};    \
+extern id##_class id;
+
+#endif /* jj/chash.h */
@@ -0,0 +1,90 @@
+#ifndef jjepoch_h
+#define jjepoch_h
+
+#include <stddef.h>
+#include <atomic>
+#include <mutex>
+
+namespace jj {
+
+class Epoch {
+public:
+  class Guard;
+
+  class Node {
+    friend class Epoch;
+
+    Node*           _next;    /* in limbo list of the epoch at retire() */
+
+  public:
+    Node(){_next=NULL;}
+  };
+
+  /* per-thread reader announcement; 0 means 'not in critical section' */
+  class alignas(64) Slot {
+    friend class Epoch;
+
+    std::atomic<unsigned long>  _epoch;
+    int                         _nest;
+
+  public:
+    Slot(){_epoch=0; _nest=0;}
+  };
+
+  class Domain {
+    friend class Epoch;
+
+    std::atomic<unsigned long>  _global;
+    Slot*                       _slot;
+    std::mutex                  _lock;      /* for retire() side */
+    Node*                       _limbo[3];  /* retired nodes by epoch%3 */
+    int                         _num,       /* retired, not reclaimed yet */
+                                _batch;     /* retired since last advance */
+
+  public:
+    Domain();
+   ~Domain();
+  };
+
+private:
+  virtual void  reclaim_base(Node* n)   = 0;
+  bool          advance   (Domain* d, Node** freed);
+  void          free_list (Node* n);
+
+public:
+  void          enter     (Domain* d);
+  void          leave     (Domain* d);
+  void          retire    (Domain* d, Node* n);
+  int           reclaim   (Domain* d);
+  void          synchronize(Domain* d);
+  int           num       (Domain* d);
+
+  class Guard {
+    Epoch*    _e;
+    Domain*   _d;
+  public:
+              Guard(Epoch* e, Domain* d){ _e=e; _d=d; _e->enter(_d); }
+             ~Guard()                   { _e->leave(_d); }
+              Guard(const Guard&)       = delete;
+    Guard&    operator=(const Guard&)   = delete;
+  };
+};
+
+}; // jj
+
+#define jjEpoch(id, _Domain, _Node) \
+class id##_class : public jj::Epoch {  \
+  void        reclaim_base(Node *); \
+                                        \
+public: \
+  void        enter(_Domain *d)             { jj::Epoch::enter((id##_##Domain *)d); } \
+  void        leave(_Domain *d)             { jj::Epoch::leave((id##_##Domain *)d); } \
+  void        retire(_Domain *d, _Node *n)  { jj::Epoch::retire((id##_##Domain *)d, (id##_##Node *)n); } \
+  int         reclaim(_Domain *d)           { return jj::Epoch::reclaim((id##_##Domain *)d); } \
+  void        synchronize(_Domain *d)       { jj::Epoch::synchronize((id##_##Domain *)d); } \
+  int         num(_Domain *d)               { return jj::Epoch::num((id##_##Domain *)d); } \
+  jj::Epoch::Guard guard(_Domain *d)        { return jj::Epoch::Guard(this, (id##_##Domain *)d); } \
+};    \
+extern id##_class id;
+
+#endif /* jj/epoch.h */
@@ -0,0 +1,69 @@
+#ifndef jjheap_h
+#define jjheap_h
+
+#include <stddef.h>
+
+namespace jj {
+
+class Heap {
+public:
+  class Entry {
+    friend class Heap;
+
+    Entry*  _child;       /* leftmost child */
+    Entry*  _next;        /* right sibling */
+    Entry*  _prev;        /* left sibling, parent if leftmost, self if root;
+                             NULL while not added */
+  public:
+    Entry(){_child=_next=_prev=NULL;}
+  };
+
+  class Holder {
+    friend class Heap;
+
+    Entry*  _root;
+    int     _num;
+
+  public:
+    Holder(){_root=NULL; _num=0;}
+  };
+
+private:
+  virtual int   cmp_base  (Entry* e1, Entry* e2) = 0;
+  Entry*        link      (Entry* a, Entry* b);
+  Entry*        combine   (Entry* first);
+  void          cut       (Entry* e);
+
+public:
+  void    add     (Holder* h, Entry* e);
+  void    del     (Holder* h, Entry* e);
+  Entry*  top     (Holder* h);
+  Entry*  pop     (Holder* h);
+  void    decrease(Holder* h, Entry* e);
+  void    update  (Holder* h, Entry* e);
+  void    meld    (Holder* h, Holder* from);
+  int     num     (Holder* h);
+  bool    added   (Entry* e){ return e && e->_prev != NULL; }
+};
+
+}; // jj
+
+#define jjHeap(id, _Holder, _Entry) \
+class id##_class : public jj::Heap {  \
+  int         cmp_base  (Entry *, Entry *);  \
+  static _Entry* cast(jj::Heap::Entry* e) { return static_cast<_Entry* >(static_cast<id##_##Entry* >(e)); } \
+                                        \
+public: \
+  void        add     (_Holder *h, _Entry *e) { jj::Heap::add((id##_##Holder *)h, (id##_##Entry *)e); } \
+  void        del     (_Holder *h, _Entry *e) { jj::Heap::del((id##_##Holder *)h, (id##_##Entry *)e); } \
+  _Entry*     top     (_Holder *h)            { return cast(jj::Heap::top((id##_##Holder *)h)); } \
+  _Entry*     pop     (_Holder *h)            { return cast(jj::Heap::pop((id##_##Holder *)h)); } \
+  void        decrease(_Holder *h, _Entry *e) { jj::Heap::decrease((id##_##Holder *)h, (id##_##Entry *)e); } \
+  void        update  (_Holder *h, _Entry *e) { jj::Heap::update((id##_##Holder *)h, (id##_##Entry *)e); } \
+  void        meld    (_Holder *h, _Holder *from) { jj::Heap::meld((id##_##Holder *)h, (id##_##Holder *)from); } \
+  int         num     (_Holder *h)            { return jj::Heap::num((id##_##Holder *)h); } \
+  bool        added   (_Entry *e)             { return jj::Heap::added((id##_##Entry *)e); } \
+};    \
+extern id##_class id;
+
+#endif /* jj/heap.h */
@@ -0,0 +1,76 @@
+#ifndef jjlhash_h
+#define jjlhash_h
+
+#include <stddef.h>
+#include "jj/pattern.h"
+
+namespace jj {
+
+class LHash {
+public:
+  class Entry : public Hash::Entry, public DCollect::Child {
+  };
+
+  /* ring is in insertion order, from the oldest (first) to the newest */
+  class Holder : public Hash::Holder, public DCollect::Parent {
+  public:
+    Holder(){}
+    Holder(int size) : Hash::Holder(size) {}
+  };
+
+private:
+  friend class HashBy<LHash>;
+  HashBy<LHash> _index;       /* by hash_base(), cmp_base() below */
+  DCollect      _ring;
+
+  virtual int   hash_base (Entry* e)              = 0;
+  virtual int   cmp_base  (Entry* e1, Entry* e2)  = 0;
+
+public:
+          LHash   () : _index(this) {}
+
+  void    add     (Holder* h, Entry* e);
+  void    del     (Holder* h, Entry* e);
+  Entry*  sel     (Holder* h, Entry* key);
+  Entry*  first   (Holder* h);
+  Entry*  last    (Holder* h);
+  Entry*  pop     (Holder* h);
+  int     num     (Holder* h);
+
+  /* in insertion order */
+  class Iter {
+    DCollect::Iter  _i;
+  public:
+    void    start     (Holder* h){ _i.start(h); }
+    Entry*  operator++(){ return static_cast<Entry*>(++_i); }
+  };
+};
+
+}; // jj
+
+#define jjLHash(id, _Holder, _Entry) \
+class id##_class : public jj::LHash {  \
+  int         hash_base (Entry *); \
+  int         cmp_base  (Entry *, Entry *);  \
+  static _Entry* cast(jj::LHash::Entry* e) { return static_cast<_Entry* >(static_cast<id##_##Entry* >(e)); } \
+                                        \
+public: \
+  void        add   (_Holder *h, _Entry *e)   { jj::LHash::add((id##_##Holder *)h, (id##_##Entry *)e); } \
+  void        del   (_Holder *h, _Entry *e)   { jj::LHash::del((id##_##Holder *)h, (id##_##Entry *)e); } \
+  _Entry*     sel   (_Holder *h, _Entry *key) { return cast(jj::LHash::sel((id##_##Holder *)h, (id##_##Entry *)key)); } \
+  _Entry*     first (_Holder *h)              { return cast(jj::LHash::first((id##_##Holder *)h)); } \
+  _Entry*     last  (_Holder *h)              { return cast(jj::LHash::last((id##_##Holder *)h)); } \
+  _Entry*     pop   (_Holder *h)              { return cast(jj::LHash::pop((id##_##Holder *)h)); } \
+  int         num   (_Holder *h)              { return jj::LHash::num((id##_##Holder *)h); } \
+                                                                            \
+  class Iter : public jj::LHash::Iter {  \
+  public: \
+              Iter()            {} \
+              Iter(_Holder* h)  { start(h); } \
+    void      start(_Holder* h) { jj::LHash::Iter::start((id##_##Holder *)h); } \
+    _Entry*   operator++()      { return cast(jj::LHash::Iter::operator++()); } \
+  };  \
+};    \
+extern id##_class id;
+
+#endif /* jj/lhash.h */
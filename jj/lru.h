@@ -0,0 +1,111 @@
+#ifndef jjlru_h
+#define jjlru_h
+
+#include <stddef.h>
+#include "jj/pattern.h"
+
+namespace jj {
+
+class LRU {
+public:
+  class Entry : public Hash::Entry, public DCollect::Child {
+    friend class LRU;
+
+    long    _cost;
+
+  public:
+    Entry(){_cost=0;}
+  };
+
+  /* list is from the least recently used (first) to the most (last) */
+  class Cache : public Hash::Holder, public DCollect::Parent {
+    friend class LRU;
+
+    long    _capacity;    /* max of sum of cost; 0: no limit */
+    long    _cost;
+    long    _hits,
+            _misses,
+            _evictions;
+
+  public:
+    Cache();
+    Cache(long capacity);
+  };
+
+private:
+  friend class HashBy<LRU>;
+  HashBy<LRU> _index;         /* by hash_base(), cmp_base() below */
+  DCollect    _list;
+
+  virtual int   hash_base (Entry* e)              = 0;
+  virtual int   cmp_base  (Entry* e1, Entry* e2)  = 0;
+  virtual void  evict_base(Cache* c, Entry* e)    = 0;
+  void          shrink    (Cache* c, Entry* keep);
+
+public:
+          LRU     () : _index(this) {}
+
+  void    add     (Cache* c, Entry* e, long cost=1);
+  void    del     (Cache* c, Entry* e);
+  Entry*  sel     (Cache* c, Entry* key);
+  Entry*  peek    (Cache* c, Entry* key);
+  void    touch   (Cache* c, Entry* e);
+  Entry*  evict   (Cache* c);
+  Entry*  oldest  (Cache* c);
+  Entry*  newest  (Cache* c);
+  void    capacity(Cache* c, long capacity);
+  long    capacity(Cache* c);
+  long    cost    (Cache* c);
+  int     num     (Cache* c);
+  long    hits    (Cache* c);
+  long    misses  (Cache* c);
+  long    evictions(Cache* c);
+  void    reset_stat(Cache* c);
+
+  /* from the least recently used to the most */
+  class Iter {
+    DCollect::Iter  _i;
+  public:
+    void    start     (Cache* c){ _i.start(c); }
+    Entry*  operator++(){ return static_cast<Entry*>(++_i); }
+  };
+};
+
+}; // jj
+
+#define jjLRU(id, _Cache, _Entry) \
+class id##_class : public jj::LRU {  \
+  int         hash_base (Entry *); \
+  int         cmp_base  (Entry *, Entry *);  \
+  void        evict_base(Cache *, Entry *);  \
+  static _Entry* cast(jj::LRU::Entry* e) { return static_cast<_Entry* >(static_cast<id##_##Entry* >(e)); } \
+                                        \
+public: \
+  void        add   (_Cache *c, _Entry *e, long cost=1) { jj::LRU::add((id##_##Cache *)c, (id##_##Entry *)e, cost); } \
+  void        del   (_Cache *c, _Entry *e)  { jj::LRU::del((id##_##Cache *)c, (id##_##Entry *)e); } \
+  _Entry*     sel   (_Cache *c, _Entry *key){ return cast(jj::LRU::sel((id##_##Cache *)c, (id##_##Entry *)key)); } \
+  _Entry*     peek  (_Cache *c, _Entry *key){ return cast(jj::LRU::peek((id##_##Cache *)c, (id##_##Entry *)key)); } \
+  void        touch (_Cache *c, _Entry *e)  { jj::LRU::touch((id##_##Cache *)c, (id##_##Entry *)e); } \
+  _Entry*     evict (_Cache *c)             { return cast(jj::LRU::evict((id##_##Cache *)c)); } \
+  _Entry*     oldest(_Cache *c)             { return cast(jj::LRU::oldest((id##_##Cache *)c)); } \
+  _Entry*     newest(_Cache *c)             { return cast(jj::LRU::newest((id##_##Cache *)c)); } \
+  void        capacity(_Cache *c, long cap) { jj::LRU::capacity((id##_##Cache *)c, cap); } \
+  long        capacity(_Cache *c)           { return jj::LRU::capacity((id##_##Cache *)c); } \
+  long        cost  (_Cache *c)             { return jj::LRU::cost((id##_##Cache *)c); } \
+  int         num   (_Cache *c)             { return jj::LRU::num((id##_##Cache *)c); } \
+  long        hits  (_Cache *c)             { return jj::LRU::hits((id##_##Cache *)c); } \
+  long        misses(_Cache *c)             { return jj::LRU::misses((id##_##Cache *)c); } \
+  long        evictions(_Cache *c)          { return jj::LRU::evictions((id##_##Cache *)c); } \
+  void        reset_stat(_Cache *c)         { jj::LRU::reset_stat((id##_##Cache *)c); } \
+                                                                            \
+  class Iter : public jj::LRU::Iter {  \
+  public: \
+              Iter()            {} \
+              Iter(_Cache* c)   { start(c); } \
+    void      start(_Cache* c)  { jj::LRU::Iter::start((id##_##Cache *)c); } \
+    _Entry*   operator++()      { return cast(jj::LRU::Iter::operator++()); } \
+  };  \
+};    \
+extern id##_class id;
+
+#endif /* jj/lru.h */
@@ -0,0 +1,105 @@
+#ifndef jjparallel_h
+#define jjparallel_h
+
+#include <stddef.h>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include "jj/pattern.h"
+
+namespace jj {
+
+class Parallel {
+public:
+  /* options of bfs() over Graph */
+  enum { top_down = 1, bottom_up = 2, direction_optimizing = 3 };
+
+  class Barrier {
+    std::atomic<int>      _count;
+    std::atomic<unsigned> _gen;
+    int                   _num;
+  public:
+          Barrier (int n){ _count=0; _gen=0; _num=n; }
+    void  wait    ();
+  };
+
+private:
+  /* fold(): a node waiting for results of subtrees run by other tasks */
+  class Frame {
+  public:
+    Aggregate::Parent*  _node;
+    Frame*              _up;
+    std::atomic<int>    _pending;
+    std::atomic<long>   _acc;
+  };
+
+  class Task {
+  public:
+    Aggregate::Parent*  _node;
+    Frame*              _up;
+  };
+
+  class alignas(64) Worker {
+  public:
+    std::mutex          _lock;
+    std::deque<Task>    _tasks;     /* owner uses back, thieves front */
+  };
+
+  int         _threads;
+  unsigned    _stamp;         /* run id of the last Graph bfs() */
+  int         _levels;        /* levels of the last bfs() */
+  int         _alpha,         /* direction switch heuristic; see bfs() */
+              _beta;
+
+  /* shared while one bfs() runs */
+  std::vector<void*>                _frontier;
+  std::vector<std::vector<void*> >  _next;      /* per thread */
+  std::vector<long>                 _next_edges;
+  std::atomic<long>                 _cursor;
+
+  /* shared while one fold() runs */
+  Worker*                           _worker;
+  std::atomic<int>                  _idle;
+  std::atomic<bool>                 _done;
+  long                              _result;
+  int                               _cutoff;
+
+  template<class F> void run(F f);
+  void    top_down_step   (Graph* g, int tid, int level);
+  void    bottom_up_step  (Graph* g, Graph::Node** all, int n, int tid, int level);
+  void    tree_step       (Aggregate* a, int tid, int level);
+  bool    claim           (Graph::Node* n, int level);
+  void    fold_task       (Aggregate* a, int tid, Task t);
+  void    deliver         (Frame* f, long v);
+  bool    get_task        (int tid, Task* t);
+
+protected:
+  /* called once for each reached node, concurrently from the threads */
+  virtual void  visit_base (Aggregate::Parent* , int ){}
+  virtual void  visit_base (Graph::Node* , int ){}
+
+  /* fold(): pre_base() before and post_base() after the children; returns
+     the value of the subtree from reduce_base()-ed values of children */
+  virtual void  pre_base    (Aggregate::Parent* ){}
+  virtual long  post_base   (Aggregate::Parent* , long children){ return children; }
+  virtual long  reduce_base (long a, long b){ return a + b; }
+
+public:
+          Parallel    (int threads=0);
+  virtual ~Parallel   (){}
+  int     threads     ()  { return _threads; }
+  int     levels      ()  { return _levels; }
+  void    tune        (int alpha, int beta){ _alpha = alpha; _beta = beta; }
+
+  int     bfs   (Aggregate* a, Aggregate::Parent* root);
+  int     bfs   (Graph* g, Graph::Node* src, Graph::Node** all=NULL, int n=0,
+                 int mode=direction_optimizing);
+  int     level (Graph::Node* n);
+
+  long    fold  (Aggregate* a, Aggregate::Parent* root, int cutoff=0);
+};
+
+}; // jj
+
+#endif /* jj/parallel.h */
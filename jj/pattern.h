@@ -1,18 +1,30 @@
 #ifndef jjpattern_h
 #define jjpattern_h
 
+#include <stddef.h>
+#include <iterator>
+#include <type_traits>
+
 namespace jj {
 
+class CSR;           //forward
+class Parallel;
+
 class Aggregate {
 public:
   class Parent;      //forward
   class Iter;
+  class iterator;
 
   class Child {
     friend class Aggregate;
     friend class Aggregate::Iter;
+    friend class Aggregate::iterator;
+    friend class CSR;
+    friend class Parallel;
 
     Child*  _next;
+    Child*  _prev;    /* for O(1) del() and move() */
     Parent* _parent;
 
   public:
@@ -22,6 +34,9 @@ public:
   class Parent {
     friend class Aggregate;
     friend class Aggregate::Iter;
+    friend class Aggregate::iterator;
+    friend class CSR;
+    friend class Parallel;
 
     Child*  _tail;
     int     _num;
@@ -30,6 +45,12 @@ public:
     Parent();
   };
 
+private:
+  unsigned long _ver;   /* changed by add() and del() on any tree of the
+                           pattern; for indexes */
+
+public:
+          Aggregate (){ _ver=0; }
   void    add   (Parent* p, Child* c);
   Child*  child (Parent* p);
   Child*  last  (Parent* p);
@@ -37,16 +58,106 @@ public:
   Parent* parent(Child*  c);
   Child*  next  (Child*  c);
   int     num   (Parent* p);
+  void    move  (Child*  c, Parent* p);
+  int     move_all(Parent* from, Parent* to);
+  unsigned long version() { return _ver; }
+
+  /* the other part of the same node when used as tree, i.e.
+     jjAggregate(id, Node, Node); NULL otherwise */
+  virtual Parent* as_parent (Child*  c){ return NULL; }
+  virtual Child*  as_child  (Parent* p){ return NULL; }
 
   class Iter {
     Child*  _curr;
     Child*  _last;
+    Child*  _ahead;   /* runner for prefetch() */
+    int     _dist;
   public:
             Iter        ();
-            Iter        (Parent* p){ start(p); }
+            Iter        (Parent* p){ _dist=0; start(p); }
     void    start       (Parent* p);
+    void    prefetch    (int distance);
     Child*  operator++  ();
+    int     fetch       (Child** buf, int n);
+  };
+
+  /* STL compatible forward iterator; end() is NULL */
+  class iterator {
+    Child*  _curr;
+    Child*  _last;
+  public:
+            iterator    (Child* c=NULL, Child* l=NULL){ _curr=c; _last=l; }
+    Child*  get         () const  { return _curr; }
+    void    step        ()        { _curr = (_curr == _last) ? NULL : _curr->_next; }
+    bool    operator==  (const iterator& i) const { return _curr == i._curr; }
+    bool    operator!=  (const iterator& i) const { return _curr != i._curr; }
+  };
+
+  iterator  begin (Parent* p){ return (p && p->_tail) ? iterator(p->_tail->_next, p->_tail) : iterator(); }
+  iterator  end   (Parent*  ){ return iterator(); }
+
+  /* whole tree walk of jjAggregate(id, Node, Node) from root without
+     recursion; depth() is of the node got last (root is 0) */
+  class PreIter {
+    Aggregate*  _a;
+    Parent*     _root;
+    Parent*     _curr;
+    int         _depth,     /* of _curr */
+                _got;       /* of the node got last */
+  public:
+            PreIter     (){ _a=NULL; _root=_curr=NULL; _depth=_got=0; }
+            PreIter     (Aggregate* a, Parent* root){ start(a, root); }
+    void    start       (Aggregate* a, Parent* root);
+    Parent* operator++  ();
+    int     depth       (){ return _got; }
   };
+
+  class PostIter {
+    Aggregate*  _a;
+    Parent*     _root;
+    Parent*     _curr;
+    int         _depth,
+                _got;
+  public:
+            PostIter    (){ _a=NULL; _root=_curr=NULL; _depth=_got=0; }
+            PostIter    (Aggregate* a, Parent* root){ start(a, root); }
+    void    start       (Aggregate* a, Parent* root);
+    Parent* operator++  ();
+    int     depth       (){ return _got; }
+  };
+
+  /* breadth first; keeps the nodes of about one level */
+  class LevelIter {
+    Aggregate*  _a;
+    Parent**    _q;
+    int         _head, _num, _cap,
+                _level_end, /* _q index where the next level starts */
+                _depth;
+  public:
+            LevelIter   (){ _a=NULL; _q=NULL; _head=_num=_cap=_level_end=_depth=0; }
+            LevelIter   (Aggregate* a, Parent* root){ _q=NULL; _cap=0; start(a, root); }
+           ~LevelIter   ();
+            LevelIter   (const LevelIter&) = delete;
+    LevelIter& operator=(const LevelIter&) = delete;
+    void    start       (Aggregate* a, Parent* root);
+    Parent* operator++  ();
+    int     depth       (){ return _depth; }
+  };
+};
+
+/* Aggregate::as_parent()/as_child() by jjAggregate; P, C are id_Parent,
+   id_Child and T is the child class */
+template<class P, class C, class T,
+         bool = std::is_base_of<P, T>::value && std::is_base_of<C, T>::value>
+struct TreeCast {
+  static Aggregate::Parent* as_parent(Aggregate::Child*  ){ return NULL; }
+  static Aggregate::Child*  as_child (Aggregate::Parent* ){ return NULL; }
+};
+
+template<class P, class C, class T>
+struct TreeCast<P, C, T, true> {
+  static Aggregate::Parent* as_parent(Aggregate::Child*  c){ return c ? static_cast<P*>(static_cast<T*>(static_cast<C*>(c))) : NULL; }
+  static Aggregate::Child*  as_child (Aggregate::Parent* p){ return p ? static_cast<C*>(static_cast<T*>(static_cast<P*>(p))) : NULL; }
 };
 
 
@@ -54,10 +165,12 @@ class Collect {
 public:
   class Parent;      //forward
   class Iter;
+  class iterator;
 
   class Child {
     friend class Collect;
     friend class Collect::Iter;
+    friend class Collect::iterator;
 
     Child*  _next;
 
@@ -68,6 +181,7 @@ public:
   class Parent {
     friend class Collect;
     friend class Collect::Iter;
+    friend class Collect::iterator;
 
     Child*  _tail;
     int     _num;
@@ -83,25 +197,58 @@ public:
   Child*  next  (Child*  c);
   int     num   (Parent* p);
 
+private:
+  /* del() in O(1) for the patterns that know the parent of a child */
+  friend class LHash;
+  friend class LRU;
+  friend class TimerWheel;
+  void    unlink(Parent* p, Child* c);
+
+public:
   class Iter {
     Child*  _curr;
     Child*  _last;
+    Child*  _ahead;   /* runner for prefetch() */
+    int     _dist;
+    Parent* _parent;  /* for del() */
+    Child*  _got;     /* got last (NULL: del()-ed) */
+    Child*  _prev;    /*   and the one before it */
   public:
             Iter        ();
-            Iter        (Parent* p){ start(p); }
+            Iter        (Parent* p){ _dist=0; start(p); }
     void    start       (Parent* p);
+    void    prefetch    (int distance);
     Child*  operator++  ();
+    int     fetch       (Child** buf, int n);
+    void    del         ();
   };
+
+  /* STL compatible forward iterator; end() is NULL */
+  class iterator {
+    Child*  _curr;
+    Child*  _last;
+  public:
+            iterator    (Child* c=NULL, Child* l=NULL){ _curr=c; _last=l; }
+    Child*  get         () const  { return _curr; }
+    void    step        ()        { _curr = (_curr == _last) ? NULL : _curr->_next; }
+    bool    operator==  (const iterator& i) const { return _curr == i._curr; }
+    bool    operator!=  (const iterator& i) const { return _curr != i._curr; }
+  };
+
+  iterator  begin (Parent* p){ return (p && p->_tail) ? iterator(p->_tail->_next, p->_tail) : iterator(); }
+  iterator  end   (Parent*  ){ return iterator(); }
 };
 
 class DCollect {
 public:
   class Parent;      //forward
   class Iter;
+  class iterator;
 
   class Child {
     friend class DCollect;
     friend class DCollect::Iter;
+    friend class DCollect::iterator;
 
     Child*  _next;
     Child*  _prev;
@@ -113,6 +260,7 @@ public:
   class Parent {
     friend class DCollect;
     friend class DCollect::Iter;
+    friend class DCollect::iterator;
 
     Child*  _tail;
     int     _num;
@@ -129,23 +277,52 @@ public:
   Child*  prev  (Child*  c);
   int     num   (Parent* p);
 
+private:
+  /* del() in O(1) for the patterns that know the parent of a child */
+  friend class LHash;
+  friend class LRU;
+  friend class TimerWheel;
+  void    unlink(Parent* p, Child* c);
+
+public:
   class Iter {
     Child*  _curr;
     Child*  _last;
+    Child*  _ahead;   /* runner for prefetch() */
+    int     _dist;
   public:
             Iter        ();
-            Iter        (Parent* p){ start(p); }
+            Iter        (Parent* p){ _dist=0; start(p); }
     void    start       (Parent* p);
     void    start       (Child*  c, Child* c2);
+    void    prefetch    (int distance);
     Child*  operator++  ();
     Child*  operator--  ();
+    int     fetch       (Child** buf, int n);
   };
+
+  /* STL compatible bidirectional iterator; end() is NULL */
+  class iterator {
+    Child*  _curr;
+    Child*  _last;
+  public:
+            iterator    (Child* c=NULL, Child* l=NULL){ _curr=c; _last=l; }
+    Child*  get         () const  { return _curr; }
+    void    step        ()        { _curr = (_curr == _last) ? NULL : _curr->_next; }
+    void    back        ()        { _curr = (_curr == NULL) ? _last : _curr->_prev; }
+    bool    operator==  (const iterator& i) const { return _curr == i._curr; }
+    bool    operator!=  (const iterator& i) const { return _curr != i._curr; }
+  };
+
+  iterator  begin (Parent* p){ return (p && p->_tail) ? iterator(p->_tail->_next, p->_tail) : iterator(); }
+  iterator  end   (Parent* p){ return iterator(NULL, p ? p->_tail : NULL); }
 };
 
 
 class Hash {
 public:
   class Entry;
+  class iterator;
   class Holder {
     friend class Hash;
     friend class Iter;
@@ -154,6 +331,12 @@ public:
 
     int       _size,        /* array size */
               _num;         /* element number */
+    unsigned  _gen;         /* changed by expand() and a move to the front;
+                               Iter takes its slot again then */
+    bool      _bloom;       /* sel() asks _filter first */
+    int       _fblocks;     /* number of 64 byte blocks of _filter */
+    unsigned char*
+              _filter;      /* counting Bloom filter of 4 bit counters */
     Entry**   _tail;
 
     void      init(int size);
@@ -166,17 +349,26 @@ public:
   class Entry {
     friend class Hash;
     friend class Iter;
+    friend class Hash::iterator;
 
     Entry*  _next;
+    int     _hash;    /* hash_base() cached at add() */
 
   public:
-    Entry(){_next=NULL;}
+    Entry(){_next=NULL; _hash=0;}
   };
 
+  class Iter;
+
 private:
   virtual int hash_base (Entry* e)              = 0;
   virtual int cmp_base  (Entry* e1, Entry* e2)  = 0;
   void        expand    (Holder* h, int new_size);
+  void        insert    (Holder* h, Entry* e);
+  Entry*      find      (Holder* h, Entry* key, bool mtf);
+  static void bloom_alloc(Holder* h);
+  static void bloom_count(Holder* h, int hash, int d);
+  static bool bloom_maybe(Holder* h, int hash);
 
 public:
 
@@ -184,27 +376,210 @@ public:
   void        add       (Holder* h, Entry* e);
   void        del       (Holder* h, Entry* e);
   Entry*      sel       (Holder* h, Entry* e);
+  Entry*      sel_mtf   (Holder* h, Entry* e);
+  void        sel_all   (Holder* h, Entry* key, Iter* i);
+  int         count     (Holder* h, Entry* key);
   void        put_stat  (Holder* h);
   void        put_stat2 (Holder* h);
   int         num       (Holder* h);
+  void        filter    (Holder* h, bool on);
+  bool        filter    (Holder* h);
+  bool        maybe     (Holder* h, Entry* key);
 
+  /* all entries in bucket order, or the equal ones to a key by sel_all() */
   class Iter {
+    friend class Hash;
     Holder*   _h;
-    int       _ix;
+    int       _ix,   /* slot of the array of _size, */
+              _size, /*   the size at the 1st slot, */
+              _k;    /*   and sub-slot of _ix in the array grown since */
+    unsigned  _gen;  /* _h->_gen when the slot was taken */
     Entry*    _beg,
          *    _nxt;  /* status of list */
+    Entry*    _got,  /* got last by operator++() (NULL: del()-ed) */
+         *    _prev; /*   and the one before it in the slot */
+    Hash*     _hash; /* for sel_all(): pattern to cmp_base() with, */
+    Entry*    _key;  /*   key to compare (NULL: all), */
+    int       _hk;   /*   and its hash */
+    bool      take();
+    bool      advance();
+    Entry*    step();
+    void      stop();
   public:
+              Iter(){ _h=NULL; _ix=_size=_k=0; _gen=0; _beg=_nxt=_got=_prev=NULL; _hash=NULL; _key=NULL; _hk=0; }
     void      start(Holder*);
     Entry*    operator++();
+    void      del();
   };
+
+  /* STL compatible forward iterator in bucket order; end() is NULL.
+     Takes no lock: invalidated by an add() that expand()s */
+  class iterator {
+    Holder*   _h;
+    int       _ix;
+    Entry*    _beg,
+         *    _curr;
+    void      slot() {
+      while( _h && _ix < _h->_size ){
+        if( (_beg = _h->_tail[_ix++]) ){ _curr = _beg->_next; return; }
+      }
+      _beg = _curr = NULL;
+    }
+  public:
+              iterator    ()          { _h=NULL; _ix=0; _beg=_curr=NULL; }
+              iterator    (Holder* h) { _h=h;    _ix=0; slot(); }
+    Entry*    get         () const    { return _curr; }
+    void      step        ()          { if(_curr == _beg) slot(); else _curr = _curr->_next; }
+    bool      operator==  (const iterator& i) const { return _curr == i._curr; }
+    bool      operator!=  (const iterator& i) const { return _curr != i._curr; }
+  };
+
+  iterator    begin     (Holder* h) { return iterator(h); }
+  iterator    end       (Holder*  ) { return iterator(); }
+};
+
+/* Hash inside a pattern P (LHash, LRU) which forwards hash_base() and
+   cmp_base() to those of P by P::Entry; P befriends it */
+template<class P>
+class HashBy : public Hash {
+  P*    _p;
+  int   hash_base (Hash::Entry* e){ return _p->hash_base(static_cast<typename P::Entry*>(e)); }
+  int   cmp_base  (Hash::Entry* e1, Hash::Entry* e2){
+    return _p->cmp_base(static_cast<typename P::Entry*>(e1), static_cast<typename P::Entry*>(e2));
+  }
+public:
+        HashBy    (P* p){ _p = p; }
 };
 
 
 /*----------------------------------------------------------------------
 jjGraph Interface
+----------------------------------------------------------------------*/
+class Graph {
+public:
+  class Node;        //forward
+  class OutIter;
+  class InIter;
+  class iterator;
+
+  class Edge {
+    friend class Graph;
+    friend class CSR;
+    friend class Graph::OutIter;
+    friend class Graph::InIter;
+    friend class Graph::iterator;
+
+    Node*   _from;
+    Node*   _to;
+    Edge*   _out_next;    /* ring of _from's out-edges */
+    Edge*   _out_prev;
+    Edge*   _in_next;     /* ring of _to's in-edges */
+    Edge*   _in_prev;
+
+  public:
+    Edge();
+  };
 
-TODO
+  class Node {
+    friend class Graph;
+    friend class Graph::OutIter;
+    friend class Graph::InIter;
+    friend class CSR;
+    friend class Parallel;
+
+    Edge*   _out;         /* tail of out-edge ring */
+    Edge*   _in;          /* tail of in-edge ring */
+    int     _out_num,
+            _in_num,
+            _ix;          /* index in the last CSR::freeze() */
+    unsigned long long
+            _bfs;         /* run << 32 | level of the last Parallel::bfs() */
+
+  public:
+    Node();
+  };
+
+  void    add     (Node* from, Node* to, Edge* e);
+  void    del     (Edge* e);
+  void    isolate (Node* n);
+  Node*   from    (Edge* e);
+  Node*   to      (Edge* e);
+  Edge*   out     (Node* n);
+  Edge*   in      (Node* n);
+  Edge*   next_out(Edge* e);
+  Edge*   next_in (Edge* e);
+  int     num_out (Node* n);
+  int     num_in  (Node* n);
+
+  class OutIter {
+    Edge*   _curr;
+    Edge*   _last;
+  public:
+            OutIter     ();
+            OutIter     (Node* n){ start(n); }
+    void    start       (Node* n);
+    Edge*   operator++  ();
+  };
+
+  class InIter {
+    Edge*   _curr;
+    Edge*   _last;
+  public:
+            InIter      ();
+            InIter      (Node* n){ start(n); }
+    void    start       (Node* n);
+    Edge*   operator++  ();
+  };
+
+  /* STL compatible forward iterator over out- or in-edges; end() is NULL */
+  class iterator {
+    Edge*   _curr;
+    Edge*   _last;
+    bool    _in;
+  public:
+            iterator    (Edge* e=NULL, Edge* l=NULL, bool in=false){ _curr=e; _last=l; _in=in; }
+    Edge*   get         () const  { return _curr; }
+    void    step        ()        { _curr = (_curr == _last) ? NULL : (_in ? _curr->_in_next : _curr->_out_next); }
+    bool    operator==  (const iterator& i) const { return _curr == i._curr; }
+    bool    operator!=  (const iterator& i) const { return _curr != i._curr; }
+  };
+
+  iterator  out_begin (Node* n){ return (n && n->_out) ? iterator(n->_out->_out_next, n->_out, false) : iterator(); }
+  iterator  in_begin  (Node* n){ return (n && n->_in ) ? iterator(n->_in->_in_next,   n->_in,  true ) : iterator(); }
+  iterator  end       (Node*  ){ return iterator(); }
+};
+
+/*----------------------------------------------------------------------
+CSR (compressed sparse row) snapshot of Graph or Aggregate tree
 ----------------------------------------------------------------------*/
+class CSR {
+  int     _num;         /* node number */
+  int*    _off;         /* [_num+1]; edges of i are _dst[_off[i].._off[i+1]) */
+  int*    _dst;         /* [_off[_num]] */
+  int*    _parent;      /* [_num] for tree; NULL for graph */
+  void**  _node;        /* [_num] index -> Aggregate::Parent* or Graph::Node* */
+
+public:
+          CSR         ();
+         ~CSR         ();
+  void    clear       ();
+  void    freeze      (Aggregate* a, Aggregate::Parent* root);
+  void    freeze      (Graph* g, Graph::Node** nodes, int n);
+  void**  prepare     (int n);
+  void    freeze      (Graph* g);
+
+  int     num         ()      { return _num; }
+  int     edges       ()      { return _num ? _off[_num] : 0; }
+  int     degree      (int i) { return _off[i+1] - _off[i]; }
+  const int*  adj     (int i) { return _dst + _off[i]; }
+  int     parent      (int i) { return _parent ? _parent[i] : -1; }
+  void*   node        (int i) { return _node[i]; }
+
+  int     bfs         (int src, int* dist);
+  void    pagerank    (double* rank, int iter, double damping);
+  void    subtree_sum (const long* val, long* sum);
+};
+
 
 /* convenient hash functions */
 int hash_str(const char *);
@@ -216,6 +591,8 @@ int hash_str(const char *);
 #define jjAggregate(id, _Parent, _Child)    \
 class id##_class :  public jj::Aggregate {  \
 public:                                     \
+  typedef id##_##Parent parent_part;       \
+  typedef id##_##Child  child_part;        \
   void      add   (_Parent* p, _Child* c){ jj::Aggregate::add((id##_##Parent *)p, (id##_##Child *)c); }  \
   _Child*   child (_Parent* p)  { return static_cast<_Child* >(static_cast<id##_##Child* >(jj::Aggregate::child((id##_##Parent *)p))); }  \
   _Child*   last  (_Parent* p)  { return static_cast<_Child* >(static_cast<id##_##Child* >(jj::Aggregate::last((id##_##Parent *)p))); }   \
@@ -223,6 +600,12 @@ public:                                     \
   _Parent*  parent(_Child* c)   { return static_cast<_Parent*>(static_cast<id##_##Parent*>(jj::Aggregate::parent((id##_##Child *)c))); }  \
   _Child*   next  (_Child* c)   { return static_cast<_Child* >(static_cast<id##_##Child* >(jj::Aggregate::next((id##_##Child *)c))); }    \
   int       num   (_Parent* p)  { return jj::Aggregate::num((id##_##Parent *)p); }  \
+  void      move  (_Child* c, _Parent* p) { jj::Aggregate::move((id##_##Child *)c, (id##_##Parent *)p); }  \
+  int       move_all(_Parent* from, _Parent* to) { return jj::Aggregate::move_all((id##_##Parent *)from, (id##_##Parent *)to); }  \
+  jj::Aggregate::Parent* as_parent(jj::Aggregate::Child* c) { return jj::TreeCast<id##_##Parent, id##_##Child, _Child>::as_parent(c); } \
+  jj::Aggregate::Child*  as_child (jj::Aggregate::Parent* p){ return jj::TreeCast<id##_##Parent, id##_##Child, _Child>::as_child(p); }  \
+  void      freeze(jj::CSR* s, _Parent* root) { s->freeze(this, (id##_##Parent *)root); } \
+  _Parent*  node  (jj::CSR* s, int i) { return static_cast<_Parent* >(static_cast<id##_##Parent* >((jj::Aggregate::Parent *)s->node(i))); } \
                                             \
   class Iter : public jj::Aggregate::Iter { \
   public:                                   \
@@ -230,6 +613,61 @@ public:                                     \
             Iter(_Parent* p) : jj::Aggregate::Iter((id##_##Parent *)p)  {}  \
     void    start(_Parent* p) { jj::Aggregate::Iter::start((id##_##Parent *)p); } \
     _Child* operator++()      { return static_cast<_Child* >(static_cast<id##_##Child*>(jj::Aggregate::Iter::operator++())); }      \
+    int     fetch(_Child** buf, int n) {  \
+      jj::Aggregate::Child* t[64];             \
+      int     k = 0, m;                     \
+      while( k < n && (m = jj::Aggregate::Iter::fetch(t, n-k < 64 ? n-k : 64)) > 0 ){  \
+        for(int j=0; j < m; j++) buf[k++] = static_cast<_Child* >(static_cast<id##_##Child*>(t[j])); \
+      }                                     \
+      return k;                             \
+    }                                       \
+  };  \
+                                            \
+  class iterator : public jj::Aggregate::iterator { \
+  public:                                   \
+    typedef std::input_iterator_tag iterator_category; /* operator*() is by value */ \
+    typedef std::forward_iterator_tag iterator_concept;  /* C++20 */ \
+    typedef _Child*   value_type;          \
+    typedef ptrdiff_t difference_type;      \
+    typedef _Child**  pointer;             \
+    typedef _Child*   reference;           \
+              iterator()  {}                \
+              iterator(const jj::Aggregate::iterator& i) : jj::Aggregate::iterator(i) {} \
+    _Child*   operator*() const { return static_cast<_Child* >(static_cast<id##_##Child*>(get())); } \
+    iterator& operator++()      { step(); return *this; } \
+    iterator  operator++(int)   { iterator i = *this; step(); return i; } \
+  };  \
+  class Range {                             \
+    iterator  _beg, _end;                   \
+  public:                                   \
+              Range(iterator b, iterator e) : _beg(b), _end(e) {} \
+    iterator  begin() const { return _beg; } \
+    iterator  end()   const { return _end; } \
+  };  \
+  iterator  begin (_Parent* p)  { return jj::Aggregate::begin((id##_##Parent *)p); } \
+  iterator  end   (_Parent* p)  { return jj::Aggregate::end((id##_##Parent *)p); }   \
+  Range     range (_Parent* p)  { return Range(begin(p), end(p)); } \
+                                            \
+  class PreIter : public jj::Aggregate::PreIter { \
+  public:                                   \
+              PreIter() {}                  \
+              PreIter(jj::Aggregate* a, _Parent* root) : jj::Aggregate::PreIter(a, (id##_##Parent *)root) {} \
+    void      start(jj::Aggregate* a, _Parent* root) { jj::Aggregate::PreIter::start(a, (id##_##Parent *)root); } \
+    _Parent*  operator++() { return static_cast<_Parent* >(static_cast<id##_##Parent*>(jj::Aggregate::PreIter::operator++())); } \
+  };  \
+  class PostIter : public jj::Aggregate::PostIter { \
+  public:                                   \
+              PostIter() {}                 \
+              PostIter(jj::Aggregate* a, _Parent* root) : jj::Aggregate::PostIter(a, (id##_##Parent *)root) {} \
+    void      start(jj::Aggregate* a, _Parent* root) { jj::Aggregate::PostIter::start(a, (id##_##Parent *)root); } \
+    _Parent*  operator++() { return static_cast<_Parent* >(static_cast<id##_##Parent*>(jj::Aggregate::PostIter::operator++())); } \
+  };  \
+  class LevelIter : public jj::Aggregate::LevelIter { \
+  public:                                   \
+              LevelIter() {}                \
+              LevelIter(jj::Aggregate* a, _Parent* root) : jj::Aggregate::LevelIter(a, (id##_##Parent *)root) {} \
+    void      start(jj::Aggregate* a, _Parent* root) { jj::Aggregate::LevelIter::start(a, (id##_##Parent *)root); } \
+    _Parent*  operator++() { return static_cast<_Parent* >(static_cast<id##_##Parent*>(jj::Aggregate::LevelIter::operator++())); } \
   };  \
 };    \
 extern id##_class id;
@@ -250,7 +688,40 @@ public:                                     \
             Iter(_Parent* p) : jj::Collect::Iter((id##_##Parent *)p)  {}  \
     void    start(_Parent* p) { jj::Collect::Iter::start((id##_##Parent *)p); } \
     _Child* operator++()      { return static_cast<_Child* >(static_cast<id##_##Child*>(jj::Collect::Iter::operator++())); }      \
+    int     fetch(_Child** buf, int n) {  \
+      jj::Collect::Child* t[64];             \
+      int     k = 0, m;                     \
+      while( k < n && (m = jj::Collect::Iter::fetch(t, n-k < 64 ? n-k : 64)) > 0 ){  \
+        for(int j=0; j < m; j++) buf[k++] = static_cast<_Child* >(static_cast<id##_##Child*>(t[j])); \
+      }                                     \
+      return k;                             \
+    }                                       \
+  };  \
+                                            \
+  class iterator : public jj::Collect::iterator { \
+  public:                                   \
+    typedef std::input_iterator_tag iterator_category; /* operator*() is by value */ \
+    typedef std::forward_iterator_tag iterator_concept;  /* C++20 */ \
+    typedef _Child*   value_type;          \
+    typedef ptrdiff_t difference_type;      \
+    typedef _Child**  pointer;             \
+    typedef _Child*   reference;           \
+              iterator()  {}                \
+              iterator(const jj::Collect::iterator& i) : jj::Collect::iterator(i) {} \
+    _Child*   operator*() const { return static_cast<_Child* >(static_cast<id##_##Child*>(get())); } \
+    iterator& operator++()      { step(); return *this; } \
+    iterator  operator++(int)   { iterator i = *this; step(); return i; } \
   };  \
+  class Range {                             \
+    iterator  _beg, _end;                   \
+  public:                                   \
+              Range(iterator b, iterator e) : _beg(b), _end(e) {} \
+    iterator  begin() const { return _beg; } \
+    iterator  end()   const { return _end; } \
+  };  \
+  iterator  begin (_Parent* p)  { return jj::Collect::begin((id##_##Parent *)p); } \
+  iterator  end   (_Parent* p)  { return jj::Collect::end((id##_##Parent *)p); }   \
+  Range     range (_Parent* p)  { return Range(begin(p), end(p)); } \
 };    \
 extern id##_class id;
 
@@ -272,8 +743,43 @@ public:                                     \
     void    start(_Parent* p) { jj::DCollect::Iter::start((id##_##Parent *)p); } \
     void    start(_Child* c, _Child* c2)  { jj::DCollect::Iter::start((id##_##Child *)c, (id##_##Child *)c2); } \
     _Child* operator++()      { return static_cast<_Child* >(static_cast<id##_##Child*>(jj::DCollect::Iter::operator++())); }      \
+    int     fetch(_Child** buf, int n) {  \
+      jj::DCollect::Child* t[64];             \
+      int     k = 0, m;                     \
+      while( k < n && (m = jj::DCollect::Iter::fetch(t, n-k < 64 ? n-k : 64)) > 0 ){  \
+        for(int j=0; j < m; j++) buf[k++] = static_cast<_Child* >(static_cast<id##_##Child*>(t[j])); \
+      }                                     \
+      return k;                             \
+    }                                       \
     _Child* operator--()      { return static_cast<_Child* >(static_cast<id##_##Child*>(jj::DCollect::Iter::operator--())); }      \
   };  \
+                                            \
+  class iterator : public jj::DCollect::iterator { \
+  public:                                   \
+    typedef std::input_iterator_tag iterator_category; /* operator*() is by value */ \
+    typedef std::bidirectional_iterator_tag iterator_concept;  /* C++20 */ \
+    typedef _Child*   value_type;          \
+    typedef ptrdiff_t difference_type;      \
+    typedef _Child**  pointer;             \
+    typedef _Child*   reference;           \
+              iterator()  {}                \
+              iterator(const jj::DCollect::iterator& i) : jj::DCollect::iterator(i) {} \
+    _Child*   operator*() const { return static_cast<_Child* >(static_cast<id##_##Child*>(get())); } \
+    iterator& operator++()      { step(); return *this; } \
+    iterator  operator++(int)   { iterator i = *this; step(); return i; } \
+    iterator& operator--()      { back(); return *this; } \
+    iterator  operator--(int)   { iterator i = *this; back(); return i; } \
+  };  \
+  class Range {                             \
+    iterator  _beg, _end;                   \
+  public:                                   \
+              Range(iterator b, iterator e) : _beg(b), _end(e) {} \
+    iterator  begin() const { return _beg; } \
+    iterator  end()   const { return _end; } \
+  };  \
+  iterator  begin (_Parent* p)  { return jj::DCollect::begin((id##_##Parent *)p); } \
+  iterator  end   (_Parent* p)  { return jj::DCollect::end((id##_##Parent *)p); }   \
+  Range     range (_Parent* p)  { return Range(begin(p), end(p)); } \
 };    \
 extern id##_class id;
 
@@ -288,9 +794,14 @@ public: \
   void        add(_Holder *h, _Entry *e)  { jj::Hash::add((id##_##Holder *)h, (id##_##Entry *)e); } \
   void        del(_Holder *h, _Entry *e)  { jj::Hash::del((id##_##Holder *)h, (id##_##Entry *)e); } \
   _Entry*     sel(_Holder *h, _Entry *key){ return static_cast<_Entry* >(static_cast<id##_##Entry* >(jj::Hash::sel((id##_##Holder *)h, (id##_##Entry *)key))); } \
+  _Entry*     sel_mtf(_Holder *h, _Entry *key){ return static_cast<_Entry* >(static_cast<id##_##Entry* >(jj::Hash::sel_mtf((id##_##Holder *)h, (id##_##Entry *)key))); } \
   void        put_stat(Holder* h)         { jj::Hash::put_stat((id##_##Holder *)h); }  \
   void        put_stat2(Holder* h)        { jj::Hash::put_stat((id##_##Holder *)h); }  \
   int         num(_Holder *h){ return jj::Hash::num((id##_##Holder *)h); }  \
+  int         count(_Holder *h, _Entry *key){ return jj::Hash::count((id##_##Holder *)h, (id##_##Entry *)key); } \
+  void        filter(_Holder *h, bool on) { jj::Hash::filter((id##_##Holder *)h, on); } \
+  bool        filter(_Holder *h)          { return jj::Hash::filter((id##_##Holder *)h); } \
+  bool        maybe(_Holder *h, _Entry *key){ return jj::Hash::maybe((id##_##Holder *)h, (id##_##Entry *)key); } \
                                                                             \
   class Iter : public jj::Hash::Iter {  \
   public: \
@@ -299,6 +810,94 @@ public: \
     void      start(_Holder* h) { jj::Hash::Iter::start((id##_##Holder *)h); } \
     Entry*    operator++()      { return static_cast<_Entry *>(static_cast<id##_##Entry *>(jj::Hash::Iter::operator++())); } \
   };  \
+  void        sel_all(_Holder *h, _Entry *key, Iter* i){ jj::Hash::sel_all((id##_##Holder *)h, (id##_##Entry *)key, i); } \
+                                            \
+  class iterator : public jj::Hash::iterator { \
+  public:                                   \
+    typedef std::input_iterator_tag iterator_category; /* operator*() is by value */ \
+    typedef std::forward_iterator_tag iterator_concept;  /* C++20 */ \
+    typedef _Entry*   value_type;          \
+    typedef ptrdiff_t difference_type;      \
+    typedef _Entry**  pointer;             \
+    typedef _Entry*   reference;           \
+              iterator()  {}                \
+              iterator(const jj::Hash::iterator& i) : jj::Hash::iterator(i) {} \
+    _Entry*   operator*() const { return static_cast<_Entry* >(static_cast<id##_##Entry*>(get())); } \
+    iterator& operator++()      { step(); return *this; } \
+    iterator  operator++(int)   { iterator i = *this; step(); return i; } \
+  };  \
+  class Range {                             \
+    iterator  _beg, _end;                   \
+  public:                                   \
+              Range(iterator b, iterator e) : _beg(b), _end(e) {} \
+    iterator  begin() const { return _beg; } \
+    iterator  end()   const { return _end; } \
+  };  \
+  iterator  begin (_Holder* p)  { return jj::Hash::begin((id##_##Holder *)p); } \
+  iterator  end   (_Holder* p)  { return jj::Hash::end((id##_##Holder *)p); }   \
+  Range     range (_Holder* p)  { return Range(begin(p), end(p)); } \
+};    \
+extern id##_class id;
+
+#define jjGraph(id, _Node, _Edge)           \
+class id##_class :  public jj::Graph {      \
+public:                                     \
+  void      add     (_Node* f, _Node* t, _Edge* e){ jj::Graph::add((id##_##Node *)f, (id##_##Node *)t, (id##_##Edge *)e); }  \
+  void      del     (_Edge* e)  { jj::Graph::del((id##_##Edge *)e); }  \
+  void      isolate (_Node* n)  { jj::Graph::isolate((id##_##Node *)n); }  \
+  _Node*    from    (_Edge* e)  { return static_cast<_Node* >(static_cast<id##_##Node* >(jj::Graph::from((id##_##Edge *)e))); }  \
+  _Node*    to      (_Edge* e)  { return static_cast<_Node* >(static_cast<id##_##Node* >(jj::Graph::to((id##_##Edge *)e))); }    \
+  _Edge*    out     (_Node* n)  { return static_cast<_Edge* >(static_cast<id##_##Edge* >(jj::Graph::out((id##_##Node *)n))); }   \
+  _Edge*    in      (_Node* n)  { return static_cast<_Edge* >(static_cast<id##_##Edge* >(jj::Graph::in((id##_##Node *)n))); }    \
+  _Edge*    next_out(_Edge* e)  { return static_cast<_Edge* >(static_cast<id##_##Edge* >(jj::Graph::next_out((id##_##Edge *)e))); } \
+  _Edge*    next_in (_Edge* e)  { return static_cast<_Edge* >(static_cast<id##_##Edge* >(jj::Graph::next_in((id##_##Edge *)e))); }  \
+  int       num_out (_Node* n)  { return jj::Graph::num_out((id##_##Node *)n); }  \
+  int       num_in  (_Node* n)  { return jj::Graph::num_in((id##_##Node *)n); }   \
+  void      freeze  (jj::CSR* s, _Node** nodes, int n) { \
+    void**  t = s->prepare(n);              \
+    for(int i=0; i < n; i++) t[i] = static_cast<jj::Graph::Node* >((id##_##Node *)nodes[i]); \
+    s->freeze(this);                        \
+  }                                         \
+  _Node*    node    (jj::CSR* s, int i) { return static_cast<_Node* >(static_cast<id##_##Node* >((jj::Graph::Node *)s->node(i))); } \
+                                            \
+  class OutIter : public jj::Graph::OutIter { \
+  public:                                   \
+            OutIter()         : jj::Graph::OutIter()  {}  \
+            OutIter(_Node* n) : jj::Graph::OutIter((id##_##Node *)n)  {}  \
+    void    start(_Node* n)   { jj::Graph::OutIter::start((id##_##Node *)n); } \
+    _Edge*  operator++()      { return static_cast<_Edge* >(static_cast<id##_##Edge*>(jj::Graph::OutIter::operator++())); } \
+  };  \
+  class InIter : public jj::Graph::InIter { \
+  public:                                   \
+            InIter()          : jj::Graph::InIter()  {}  \
+            InIter(_Node* n)  : jj::Graph::InIter((id##_##Node *)n)  {}  \
+    void    start(_Node* n)   { jj::Graph::InIter::start((id##_##Node *)n); } \
+    _Edge*  operator++()      { return static_cast<_Edge* >(static_cast<id##_##Edge*>(jj::Graph::InIter::operator++())); } \
+  };  \
+                                            \
+  class iterator : public jj::Graph::iterator { \
+  public:                                   \
+    typedef std::input_iterator_tag iterator_category; /* operator*() is by value */ \
+    typedef std::forward_iterator_tag iterator_concept;  /* C++20 */ \
+    typedef _Edge*    value_type;           \
+    typedef ptrdiff_t difference_type;      \
+    typedef _Edge**   pointer;              \
+    typedef _Edge*    reference;            \
+              iterator()  {}                \
+              iterator(const jj::Graph::iterator& i) : jj::Graph::iterator(i) {} \
+    _Edge*    operator*() const { return static_cast<_Edge* >(static_cast<id##_##Edge*>(get())); } \
+    iterator& operator++()      { step(); return *this; } \
+    iterator  operator++(int)   { iterator i = *this; step(); return i; } \
+  };  \
+  class Range {                             \
+    iterator  _beg, _end;                   \
+  public:                                   \
+              Range(iterator b, iterator e) : _beg(b), _end(e) {} \
+    iterator  begin() const { return _beg; } \
+    iterator  end()   const { return _end; } \
+  };  \
+  Range     outs  (_Node* n)  { return Range(jj::Graph::out_begin((id##_##Node *)n), iterator()); } \
+  Range     ins   (_Node* n)  { return Range(jj::Graph::in_begin((id##_##Node *)n),  iterator()); } \
 };    \
 extern id##_class id;
 
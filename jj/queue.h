@@ -0,0 +1,49 @@
+#ifndef jjqueue_h
+#define jjqueue_h
+
+#include <stddef.h>
+#include <atomic>
+
+namespace jj {
+
+class Queue {
+public:
+  class Parent;      //forward
+
+  class Child {
+    friend class Queue;
+
+    std::atomic<Child*> _next;
+
+  public:
+    Child(){_next=NULL;}
+  };
+
+  class Parent {
+    friend class Queue;
+
+    std::atomic<Child*> _head;      /* last added; producers exchange it */
+    Child*              _tail;      /* next to get; consumer only */
+    Child               _stub;
+
+  public:
+    Parent();
+  };
+
+  void    add   (Parent* p, Child* c);
+  Child*  get   (Parent* p);
+  bool    empty (Parent* p);
+};
+
+}; // jj
+
+#define jjQueue(id, _Parent, _Child)        \
+class id##_class :  public jj::Queue {      \
+public:                                     \
+  void      add   (_Parent* p, _Child* c){ jj::Queue::add((id##_##Parent *)p, (id##_##Child *)c); }  \
+  _Child*   get   (_Parent* p)  { return static_cast<_Child* >(static_cast<id##_##Child* >(jj::Queue::get((id##_##Parent *)p))); }  \
+  bool      empty (_Parent* p)  { return jj::Queue::empty((id##_##Parent *)p); }  \
+};    \
+extern id##_class id;
+
+#endif /* jj/queue.h */
@@ -0,0 +1,134 @@
+#ifndef jjradix_h
+#define jjradix_h
+
+#include <stddef.h>
+#include <iterator>
+
+namespace jj {
+
+class Radix {
+public:
+  class Inner;       //forward; node of the tree, private to radix.cpp
+  class Entry;
+  class Iter;
+  class iterator;
+
+  class Entry {
+    friend class Radix;
+
+    Inner*  _parent;      /* NULL if root */
+    short   _byte;        /* key byte under _parent; -1 while not added */
+
+  public:
+    Entry(){_parent=NULL; _byte=-1;}
+  };
+
+  class Holder {
+    friend class Radix;
+
+    void*   _root;        /* Inner* or Entry* | 1 */
+    int     _num;
+
+  public:
+    Holder();
+   ~Holder();
+  };
+
+private:
+  virtual const char* key_base(Entry* e) = 0;
+  const unsigned char* key  (Entry* e){ return (const unsigned char*)key_base(e); }
+  void        split   (void** slot, Inner* parent, int byte, void* c,
+                       const unsigned char* ck, Entry* e, int at);
+  static Entry* next_in(Entry* e, void* top);
+
+public:
+  void          add   (Holder* h, Entry* e);
+  void          del   (Holder* h, Entry* e);
+  Entry*        sel   (Holder* h, const char* key);
+  static Entry* first (Holder* h);
+  static Entry* next  (Entry* e);
+  int           num   (Holder* h);
+  void          scan  (Holder* h, const char* prefix, Iter* i);
+
+  /* in key order; all, or of a prefix by scan() */
+  class Iter {
+    friend class Radix;
+    friend class Radix::iterator;
+    Entry*    _curr;
+    void*     _top;       /* subtree to walk; NULL: whole */
+  public:
+              Iter        (){ _curr=NULL; _top=NULL; }
+    void      start       (Holder* h){ _curr=Radix::first(h); _top=NULL; }
+    Entry*    operator++  ();
+  };
+
+  /* STL compatible forward iterator in key order; end() is NULL */
+  class iterator {
+    Entry*    _curr;
+    void*     _top;
+  public:
+              iterator    (Entry* e=NULL, void* top=NULL){ _curr=e; _top=top; }
+              iterator    (const Iter& i){ _curr=i._curr; _top=i._top; }
+    Entry*    get         () const  { return _curr; }
+    void      step        ()        { _curr = Radix::next_in(_curr, _top); }
+    bool      operator==  (const iterator& i) const { return _curr == i._curr; }
+    bool      operator!=  (const iterator& i) const { return _curr != i._curr; }
+  };
+};
+
+}; // jj
+
+#define jjRadix(id, _Holder, _Entry) \
+class id##_class : public jj::Radix {  \
+  const char* key_base  (Entry *);  \
+  static _Entry* cast(jj::Radix::Entry* e) { return static_cast<_Entry* >(static_cast<id##_##Entry* >(e)); } \
+                                        \
+public: \
+  void        add  (_Holder *h, _Entry *e)      { jj::Radix::add((id##_##Holder *)h, (id##_##Entry *)e); } \
+  void        del  (_Holder *h, _Entry *e)      { jj::Radix::del((id##_##Holder *)h, (id##_##Entry *)e); } \
+  _Entry*     sel  (_Holder *h, const char *key){ return cast(jj::Radix::sel((id##_##Holder *)h, key)); } \
+  _Entry*     first(_Holder *h)                 { return cast(jj::Radix::first((id##_##Holder *)h)); } \
+  _Entry*     next (_Entry *e)                  { return cast(jj::Radix::next((id##_##Entry *)e)); } \
+  int         num  (_Holder *h)                 { return jj::Radix::num((id##_##Holder *)h); }  \
+                                                                            \
+  class Iter : public jj::Radix::Iter {  \
+  public: \
+              Iter()            : jj::Radix::Iter() {} \
+              Iter(_Holder* h)  { start(h); } \
+    void      start(_Holder* h) { jj::Radix::Iter::start((id##_##Holder *)h); } \
+    _Entry*   operator++()      { return cast(jj::Radix::Iter::operator++()); } \
+  };  \
+  void        scan (_Holder *h, const char *prefix, Iter* i) { jj::Radix::scan((id##_##Holder *)h, prefix, i); } \
+                                            \
+  class iterator : public jj::Radix::iterator { \
+  public:                                   \
+    typedef std::input_iterator_tag iterator_category; /* operator*() is by value */ \
+    typedef std::forward_iterator_tag iterator_concept;  /* C++20 */ \
+    typedef _Entry*   value_type;          \
+    typedef ptrdiff_t difference_type;      \
+    typedef _Entry**  pointer;             \
+    typedef _Entry*   reference;           \
+              iterator()  {}                \
+              iterator(const jj::Radix::iterator& i) : jj::Radix::iterator(i) {} \
+    _Entry*   operator*() const { return cast(get()); } \
+    iterator& operator++()      { step(); return *this; } \
+    iterator  operator++(int)   { iterator i = *this; step(); return i; } \
+  };  \
+  class Range {                             \
+    iterator  _beg, _end;                   \
+  public:                                   \
+              Range(iterator b, iterator e) : _beg(b), _end(e) {} \
+    iterator  begin() const { return _beg; } \
+    iterator  end()   const { return _end; } \
+  };  \
+  iterator  begin (_Holder* h)  { return jj::Radix::iterator(jj::Radix::first((id##_##Holder *)h)); } \
+  iterator  end   (_Holder*  )  { return iterator(); }   \
+  Range     range (_Holder* h)  { return Range(begin(h), end(h)); } \
+  Range     range (_Holder* h, const char* prefix) { \
+    Iter i;                                 \
+    scan(h, prefix, &i);                    \
+    return Range(jj::Radix::iterator(i), iterator()); } \
+};    \
+extern id##_class id;
+
+#endif /* jj/radix.h */
@@ -0,0 +1,148 @@
+#ifndef jjrbtree_h
+#define jjrbtree_h
+
+#include <stddef.h>
+#include <iterator>
+
+namespace jj {
+
+class RBTree {
+public:
+  class Entry;
+  class Iter;
+  class iterator;
+
+  class Entry {
+    friend class RBTree;
+
+    Entry*  _left;
+    Entry*  _right;
+    Entry*  _parent;
+    int     _color;       /* red, black; none while not added */
+
+  public:
+    Entry(){_left=_right=_parent=NULL; _color=-1;}
+  };
+
+  class Holder {
+    friend class RBTree;
+
+    Entry*  _root;
+    int     _num;
+
+  public:
+    Holder();
+  };
+
+private:
+  virtual int cmp_base  (Entry* e1, Entry* e2)  = 0;
+  void        rotate_left (Holder* h, Entry* x);
+  void        rotate_right(Holder* h, Entry* x);
+  void        transplant  (Holder* h, Entry* u, Entry* v);
+  void        add_fixup   (Holder* h, Entry* e);
+  void        del_fixup   (Holder* h, Entry* x, Entry* xp);
+  int         check_sub   (Entry* e, Entry* lo, Entry* hi);
+
+public:
+  void          add         (Holder* h, Entry* e);
+  void          del         (Holder* h, Entry* e);
+  Entry*        sel         (Holder* h, Entry* key);
+  Entry*        lower_bound (Holder* h, Entry* key);
+  Entry*        upper_bound (Holder* h, Entry* key);
+  static Entry* first       (Holder* h);
+  static Entry* last        (Holder* h);
+  static Entry* next        (Entry* e);
+  static Entry* prev        (Entry* e);
+  int           num         (Holder* h);
+  int           check       (Holder* h);
+
+  /* in-order from 'from' until 'end' (NULL: to the last) */
+  class Iter {
+    Entry*    _curr;
+    Entry*    _end;
+  public:
+              Iter        (){ _curr=_end=NULL; }
+    void      start       (Entry* from, Entry* end=NULL){ _curr=from; _end=end; }
+    Entry*    operator++  ();
+  };
+
+  /* STL compatible bidirectional iterator in key order; end() is NULL,
+     and the holder is kept so that --end() is the last */
+  class iterator {
+    Entry*    _curr;
+    Holder*   _h;
+  public:
+              iterator    (Entry* e=NULL, Holder* h=NULL){ _curr=e; _h=h; }
+    Entry*    get         () const  { return _curr; }
+    void      step        ()        { _curr = RBTree::next(_curr); }
+    void      back        ()        { _curr = _curr ? RBTree::prev(_curr) : RBTree::last(_h); }
+    bool      operator==  (const iterator& i) const { return _curr == i._curr; }
+    bool      operator!=  (const iterator& i) const { return _curr != i._curr; }
+  };
+};
+
+}; // jj
+
+#define jjRBTree(id, _Holder, _Entry) \
+class id##_class : public jj::RBTree {  \
+  int         cmp_base  (Entry *, Entry *);  \
+  static _Entry* cast(jj::RBTree::Entry* e) { return static_cast<_Entry* >(static_cast<id##_##Entry* >(e)); } \
+                                        \
+public: \
+  void        add(_Holder *h, _Entry *e)  { jj::RBTree::add((id##_##Holder *)h, (id##_##Entry *)e); } \
+  void        del(_Holder *h, _Entry *e)  { jj::RBTree::del((id##_##Holder *)h, (id##_##Entry *)e); } \
+  _Entry*     sel(_Holder *h, _Entry *key){ return cast(jj::RBTree::sel((id##_##Holder *)h, (id##_##Entry *)key)); } \
+  _Entry*     lower_bound(_Holder *h, _Entry *key) { return cast(jj::RBTree::lower_bound((id##_##Holder *)h, (id##_##Entry *)key)); } \
+  _Entry*     upper_bound(_Holder *h, _Entry *key) { return cast(jj::RBTree::upper_bound((id##_##Holder *)h, (id##_##Entry *)key)); } \
+  _Entry*     first(_Holder *h)           { return cast(jj::RBTree::first((id##_##Holder *)h)); } \
+  _Entry*     last (_Holder *h)           { return cast(jj::RBTree::last((id##_##Holder *)h)); } \
+  _Entry*     next (_Entry *e)            { return cast(jj::RBTree::next((id##_##Entry *)e)); } \
+  _Entry*     prev (_Entry *e)            { return cast(jj::RBTree::prev((id##_##Entry *)e)); } \
+  int         num  (_Holder *h)           { return jj::RBTree::num((id##_##Holder *)h); }  \
+  int         check(_Holder *h)           { return jj::RBTree::check((id##_##Holder *)h); }  \
+                                                                            \
+  class Iter : public jj::RBTree::Iter {  \
+  public: \
+              Iter()            : jj::RBTree::Iter() {} \
+              Iter(_Holder* h)  { start(h); } \
+    void      start(_Holder* h) { jj::RBTree::Iter::start(jj::RBTree::first((id##_##Holder *)h)); } \
+    void      start(_Entry* from, _Entry* end=NULL) { jj::RBTree::Iter::start((id##_##Entry *)from, (id##_##Entry *)end); } \
+    _Entry*   operator++()      { return cast(jj::RBTree::Iter::operator++()); } \
+  };  \
+                                            \
+  class iterator : public jj::RBTree::iterator { \
+  public:                                   \
+    typedef std::input_iterator_tag iterator_category; /* operator*() is by value */ \
+    typedef std::bidirectional_iterator_tag iterator_concept;  /* C++20 */ \
+    typedef _Entry*   value_type;          \
+    typedef ptrdiff_t difference_type;      \
+    typedef _Entry**  pointer;             \
+    typedef _Entry*   reference;           \
+              iterator()  {}                \
+              iterator(const jj::RBTree::iterator& i) : jj::RBTree::iterator(i) {} \
+    _Entry*   operator*() const { return cast(get()); } \
+    iterator& operator++()      { step(); return *this; } \
+    iterator  operator++(int)   { iterator i = *this; step(); return i; } \
+    iterator& operator--()      { back(); return *this; } \
+    iterator  operator--(int)   { iterator i = *this; back(); return i; } \
+  };  \
+  class Range {                             \
+    iterator  _beg, _end;                   \
+  public:                                   \
+              Range(iterator b, iterator e) : _beg(b), _end(e) {} \
+    iterator  begin() const { return _beg; } \
+    iterator  end()   const { return _end; } \
+  };  \
+  iterator  begin (_Holder* h)  { return jj::RBTree::iterator(jj::RBTree::first((id##_##Holder *)h), (id##_##Holder *)h); } \
+  iterator  end   (_Holder* h)  { return jj::RBTree::iterator(NULL, (id##_##Holder *)h); }   \
+  Range     range (_Holder* h)  { return Range(begin(h), end(h)); } \
+  /* entries of lo <= key <= hi; empty if lo > hi */ \
+  Range     range (_Holder* h, _Entry* lo, _Entry* hi)  { \
+    jj::RBTree::Entry* b = jj::RBTree::lower_bound((id##_##Holder *)h, (id##_##Entry *)lo); \
+    if( b==NULL || cmp_base((id##_##Entry *)lo, (id##_##Entry *)hi) > 0 ) return Range(end(h), end(h)); \
+    return Range(jj::RBTree::iterator(b, (id##_##Holder *)h), \
+                 jj::RBTree::iterator(jj::RBTree::upper_bound((id##_##Holder *)h, (id##_##Entry *)hi), (id##_##Holder *)h)); } \
+};    \
+extern id##_class id;
+
+#endif /* jj/rbtree.h */
@@ -0,0 +1,82 @@
+#ifndef jjtimer_h
+#define jjtimer_h
+
+#include <stddef.h>
+#include "jj/pattern.h"
+
+namespace jj {
+
+class TimerWheel {
+public:
+  enum {
+    bits    = 6,                /* log2(slots per level) */
+    slots   = 1 << bits,
+    levels  = 6                 /* covers 2^36 ticks; farther are kept aside */
+  };
+
+  class Entry : public DCollect::Child {
+    friend class TimerWheel;
+
+    unsigned long       _when;
+    DCollect::Parent*   _slot;  /* ring of the wheel; NULL if not scheduled */
+
+  public:
+    Entry(){_when=0; _slot=NULL;}
+  };
+
+  class Wheel {
+    friend class TimerWheel;
+
+    DCollect::Parent    _slot[levels * slots];
+    DCollect::Parent    _due;   /* expired, not yet returned by advance() */
+    DCollect::Parent    _over;  /* beyond the top level */
+    unsigned long long  _occ[levels];   /* non-empty slots */
+    unsigned long       _now;
+    unsigned long       _omin;  /* lower bound of _when in _over */
+    int                 _num;
+
+  public:
+    Wheel();
+  };
+
+private:
+  DCollect  _ring;
+
+  void      place     (Wheel* w, Entry* e);
+  void      unlink    (Wheel* w, Entry* e);
+  bool      next_tick (Wheel* w, unsigned long* t, DCollect::Parent** p);
+  int       take      (Wheel* w, DCollect::Parent* p, Entry** buf, int n);
+
+public:
+  void          schedule(Wheel* w, Entry* e, unsigned long when);
+  void          cancel  (Wheel* w, Entry* e);
+  int           advance (Wheel* w, unsigned long now, Entry** buf, int n);
+  unsigned long now     (Wheel* w);
+  int           num     (Wheel* w);
+  bool          pending (Entry* e);
+  unsigned long when    (Entry* e);
+};
+
+}; // jj
+
+#define jjTimerWheel(id, _Wheel, _Entry) \
+class id##_class : public jj::TimerWheel {  \
+public: \
+  void          schedule(_Wheel *w, _Entry *e, unsigned long when) { jj::TimerWheel::schedule((id##_##Wheel *)w, (id##_##Entry *)e, when); } \
+  void          cancel  (_Wheel *w, _Entry *e)  { jj::TimerWheel::cancel((id##_##Wheel *)w, (id##_##Entry *)e); } \
+  int           advance (_Wheel *w, unsigned long now, _Entry** buf, int n) { \
+    jj::TimerWheel::Entry* t[64];           \
+    int     k = 0, m;                       \
+    while( k < n && (m = jj::TimerWheel::advance((id##_##Wheel *)w, now, t, n-k < 64 ? n-k : 64)) > 0 ){  \
+      for(int j=0; j < m; j++) buf[k++] = static_cast<_Entry* >(static_cast<id##_##Entry*>(t[j])); \
+    }                                       \
+    return k;                               \
+  }                                         \
+  unsigned long now     (_Wheel *w)         { return jj::TimerWheel::now((id##_##Wheel *)w); } \
+  int           num     (_Wheel *w)         { return jj::TimerWheel::num((id##_##Wheel *)w); } \
+  bool          pending (_Entry *e)         { return jj::TimerWheel::pending((id##_##Entry *)e); } \
+  unsigned long when    (_Entry *e)         { return jj::TimerWheel::when((id##_##Entry *)e); } \
+};    \
+extern id##_class id;
+
+#endif /* jj/timer.h */
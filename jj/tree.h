@@ -0,0 +1,149 @@
+#ifndef jjtree_h
+#define jjtree_h
+
+#include <stddef.h>
+#include "jj/pattern.h"
+
+namespace jj {
+
+/*----------------------------------------------------------------------
+Euler tour (DFS entry/exit number) index of Aggregate tree
+----------------------------------------------------------------------*/
+class Euler {
+public:
+  class Index;       //forward
+
+  class Entry {
+    friend class Euler;
+
+    int     _in;          /* DFS entry number */
+    int     _out;         /* _in + subtree size */
+
+  public:
+    Entry(){_in=_out=-1;}
+  };
+
+  /* Aggregate::Parent of tree -> Entry of the same object */
+  typedef Entry* (*Conv)(Aggregate::Parent*);
+
+  class Index {
+    friend class Euler;
+
+    Aggregate*          _tree;
+    Aggregate::Parent*  _root;
+    Conv                _conv;
+    unsigned long       _ver;     /* _tree->version() at build */
+    Entry**             _order;   /* DFS order */
+    int                 _num;
+    int                 _cap;
+    int                 _builds;
+
+  public:
+    Index();
+   ~Index();
+  };
+
+  void    build   (Index* x, Aggregate* tree, Aggregate::Parent* root, Conv conv);
+  bool    refresh (Index* x);
+  int     num     (Index* x);
+  int     builds  (Index* x);
+  Entry*  at      (Index* x, int i);
+  int     in      (Index* x, Entry* n);
+  int     out     (Index* x, Entry* n);
+  int     size    (Index* x, Entry* n);
+  bool    under   (Index* x, Entry* n, Entry* ancestor);
+  long    sum     (Index* x, Entry* n, const long* val);
+};
+
+/*----------------------------------------------------------------------
+Binary lifting (2^k-th ancestor) index of Aggregate tree
+----------------------------------------------------------------------*/
+class Lift {
+public:
+  class Index;       //forward
+
+  class Entry {
+    friend class Lift;
+
+    int     _ix;          /* number in the index */
+
+  public:
+    Entry(){_ix=-1;}
+  };
+
+  typedef Entry* (*Conv)(Aggregate::Parent*);
+
+  class Index {
+    friend class Lift;
+
+    Aggregate*          _tree;
+    Aggregate::Parent*  _root;
+    Conv                _conv;
+    unsigned long       _ver;     /* _tree->version() at build */
+    int                 _threads;
+    Entry**             _order;   /* pre-order */
+    int*                _depth;
+    int*                _up;      /* [_log][_num]; 2^k-th ancestor */
+    int                 _num;
+    int                 _cap;
+    int                 _log;
+    int                 _builds;
+
+  public:
+    Index();
+   ~Index();
+  };
+
+  void    build   (Index* x, Aggregate* tree, Aggregate::Parent* root, Conv conv,
+                   int threads=0);
+  bool    refresh (Index* x);
+  int     num     (Index* x);
+  int     builds  (Index* x);
+  int     depth   (Index* x, Entry* n);
+  Entry*  ancestor(Index* x, Entry* n, int k);
+  Entry*  lca     (Index* x, Entry* a, Entry* b);
+
+private:
+  int     ix      (Index* x, Entry* n);
+};
+
+}; // jj
+
+#define jjEuler(id, _Index, _Entry)         \
+class id##_class :  public jj::Euler {      \
+  template<class T> static jj::Euler::Entry* conv_(jj::Aggregate::Parent* p){ \
+    return (id##_##Entry *)static_cast<_Entry* >(static_cast<typename T::parent_part* >(p)); \
+  }                                         \
+public:                                     \
+  template<class T>                         \
+  void      build (_Index* x, T* tree, _Entry* root) { jj::Euler::build((id##_##Index *)x, tree, (typename T::parent_part *)root, &conv_<T>); } \
+  bool      refresh(_Index* x)          { return jj::Euler::refresh((id##_##Index *)x); } \
+  int       num   (_Index* x)           { return jj::Euler::num((id##_##Index *)x); } \
+  int       builds(_Index* x)           { return jj::Euler::builds((id##_##Index *)x); } \
+  _Entry*   at    (_Index* x, int i)    { return static_cast<_Entry* >(static_cast<id##_##Entry* >(jj::Euler::at((id##_##Index *)x, i))); } \
+  int       in    (_Index* x, _Entry* n){ return jj::Euler::in((id##_##Index *)x, (id##_##Entry *)n); } \
+  int       out   (_Index* x, _Entry* n){ return jj::Euler::out((id##_##Index *)x, (id##_##Entry *)n); } \
+  int       size  (_Index* x, _Entry* n){ return jj::Euler::size((id##_##Index *)x, (id##_##Entry *)n); } \
+  bool      under (_Index* x, _Entry* n, _Entry* a) { return jj::Euler::under((id##_##Index *)x, (id##_##Entry *)n, (id##_##Entry *)a); } \
+  long      sum   (_Index* x, _Entry* n, const long* val) { return jj::Euler::sum((id##_##Index *)x, (id##_##Entry *)n, val); } \
+};    \
+extern id##_class id;
+
+#define jjLift(id, _Index, _Entry)          \
+class id##_class :  public jj::Lift {       \
+  template<class T> static jj::Lift::Entry* conv_(jj::Aggregate::Parent* p){ \
+    return (id##_##Entry *)static_cast<_Entry* >(static_cast<typename T::parent_part* >(p)); \
+  }                                         \
+public:                                     \
+  template<class T>                         \
+  void      build (_Index* x, T* tree, _Entry* root, int threads=0) { jj::Lift::build((id##_##Index *)x, tree, (typename T::parent_part *)root, &conv_<T>, threads); } \
+  bool      refresh(_Index* x)          { return jj::Lift::refresh((id##_##Index *)x); } \
+  int       num   (_Index* x)           { return jj::Lift::num((id##_##Index *)x); } \
+  int       builds(_Index* x)           { return jj::Lift::builds((id##_##Index *)x); } \
+  int       depth (_Index* x, _Entry* n){ return jj::Lift::depth((id##_##Index *)x, (id##_##Entry *)n); } \
+  _Entry*   ancestor(_Index* x, _Entry* n, int k) { return static_cast<_Entry* >(static_cast<id##_##Entry* >(jj::Lift::ancestor((id##_##Index *)x, (id##_##Entry *)n, k))); } \
+  _Entry*   lca   (_Index* x, _Entry* a, _Entry* b) { return static_cast<_Entry* >(static_cast<id##_##Entry* >(jj::Lift::lca((id##_##Index *)x, (id##_##Entry *)a, (id##_##Entry *)b))); } \
+};    \
+extern id##_class id;
+
+#endif /* jj/tree.h */
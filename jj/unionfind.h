@@ -0,0 +1,78 @@
+#ifndef jjunionfind_h
+#define jjunionfind_h
+
+#include <stddef.h>
+
+namespace jj {
+
+class UnionFind {
+public:
+  class Iter;
+
+  class Entry {
+    friend class UnionFind;
+    friend class UnionFind::Iter;
+
+    Entry*  _parent;      /* self if root; NULL while not added */
+    Entry*  _next;        /* ring of the members of the set */
+    int     _size;        /* number of members; valid at root */
+
+  public:
+    Entry(){_parent=_next=NULL; _size=0;}
+  };
+
+  class Forest {
+    friend class UnionFind;
+
+    long    _num;
+    long    _sets;
+
+  public:
+    Forest(){_num=_sets=0;}
+  };
+
+  void      add   (Forest* f, Entry* e);
+  Entry*    find  (Entry* e);
+  bool      unite (Forest* f, Entry* a, Entry* b);
+  bool      same  (Entry* a, Entry* b);
+  int       size  (Entry* e);
+  long      num   (Forest* f);
+  long      sets  (Forest* f);
+
+  /* members of the set of an entry, from the entry around the ring */
+  class Iter {
+    Entry*  _curr;
+    Entry*  _first;
+  public:
+            Iter        (){ _curr=_first=NULL; }
+    void    start       (Entry* e){ _curr=_first=(e && e->_parent) ? e : NULL; }
+    Entry*  operator++  ();
+  };
+};
+
+}; // jj
+
+#define jjUnionFind(id, _Forest, _Entry) \
+class id##_class : public jj::UnionFind {  \
+  static _Entry* cast(jj::UnionFind::Entry* e) { return static_cast<_Entry* >(static_cast<id##_##Entry* >(e)); } \
+                                        \
+public: \
+  void        add   (_Forest *f, _Entry *e)           { jj::UnionFind::add((id##_##Forest *)f, (id##_##Entry *)e); } \
+  _Entry*     find  (_Entry *e)                       { return cast(jj::UnionFind::find((id##_##Entry *)e)); } \
+  bool        unite (_Forest *f, _Entry *a, _Entry *b){ return jj::UnionFind::unite((id##_##Forest *)f, (id##_##Entry *)a, (id##_##Entry *)b); } \
+  bool        same  (_Entry *a, _Entry *b)            { return jj::UnionFind::same((id##_##Entry *)a, (id##_##Entry *)b); } \
+  int         size  (_Entry *e)                       { return jj::UnionFind::size((id##_##Entry *)e); } \
+  long        num   (_Forest *f)                      { return jj::UnionFind::num((id##_##Forest *)f); } \
+  long        sets  (_Forest *f)                      { return jj::UnionFind::sets((id##_##Forest *)f); } \
+                                                                            \
+  class Iter : public jj::UnionFind::Iter {  \
+  public: \
+              Iter()            {} \
+              Iter(_Entry* e)   { start(e); } \
+    void      start(_Entry* e)  { jj::UnionFind::Iter::start((id##_##Entry *)e); } \
+    _Entry*   operator++()      { return cast(jj::UnionFind::Iter::operator++()); } \
+  };  \
+};    \
+extern id##_class id;
+
+#endif /* jj/unionfind.h */
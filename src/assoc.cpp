@@ -0,0 +1,255 @@
+/*!
+\file   assoc.cpp
+\brief  many-to-many association pattern by intrusive link records
+*/
+
+#include <stdlib.h>
+#include "jj/errno.h"
+#include "jj/assoc.h"
+
+
+namespace jj {
+
+static Errno      g_eh;
+
+enum Error {
+  assoc_no_memory   = 1
+};
+
+enum {
+  assoc_chunk       = 256       /* links allocated at once */
+};
+
+/* pool of links; never returned to the system until ~Assoc() */
+struct Assoc::Chunk {
+  Chunk*  next;
+  Link    link[assoc_chunk];
+};
+
+/*!
+\class  Assoc
+\brief  define many-to-many relation between Left and Right.
+
+Each pair of Left and Right is tied by a Link record, which sits in two
+rings at once: the ring of its Left and the ring of its Right.  So that:
+
+* link() is O(1); links are taken from a pool of the pattern, which grows
+  by chunks and is reused, instead of new/delete per link.
+* unlink() is O(1) from either side, by the link's own ring pointers.
+* unlink_left() / unlink_right() remove all links of one object in
+  O(its links), e.g. when a user or an item is deleted.
+* Rights iterates the Right objects of a Left, and Lefts the Left
+  objects of a Right.  The current link may be unlinked while iterating.
+
+link() does not check for the pair already linked; sel() finds it in
+O(min of both degrees).  Left and Right can be the same class, e.g.
+follower-followee relation of users.
+
+### Example
+
+    #include <jj/assoc.h>
+    #include "ex.b"
+
+    class User  : INHERIT_User  {...};
+    class Group : INHERIT_Group {...};
+
+    jjAssoc (members, User, Group);
+
+    members.link(&alice, &admin);
+    members.link(&alice, &staff);
+    members.link(&bob,   &staff);
+
+    members_class::Rights g(&alice);        // groups of alice
+    for(Group* p; (p = ++g); ) ...
+    members_class::Lefts  u(&staff);        // users of staff
+    for(User* p; (p = ++u); ) ...
+
+    members.unlink_left(&alice);            // alice leaves all
+
+See [assoc_test.cpp](../test/pattern/assoc_test.cpp) source as actual sample.
+*/
+
+/*!
+\class  Assoc::Left
+\brief  Left base class for jj::Assoc pattern.
+*/
+
+/*!
+\class  Assoc::Right
+\brief  Right base class for jj::Assoc pattern.
+*/
+
+/*!
+\class  Assoc::Link
+\brief  link record between a Left and a Right; allocated by jj::Assoc.
+*/
+
+Assoc::Assoc(){
+  _free   = NULL;
+  _chunks = NULL;
+  _num    = 0;
+}
+
+/* links still linked are freed too; unlink them before if in doubt */
+Assoc::~Assoc(){
+  while( _chunks ){
+    Chunk* c = _chunks->next;
+    free(_chunks);
+    _chunks = c;
+  }
+}
+
+/* take a link from the pool; grow it by a chunk if empty */
+Assoc::Link *Assoc::alloc(){
+  if( _free == NULL ){
+    Chunk* c = (Chunk*)malloc(sizeof(Chunk));
+    if( c == NULL ){
+      ::jj::raise(g_eh, assoc_no_memory);
+      return NULL;
+    }
+    c->next = _chunks;
+    _chunks = c;
+    for(int i=0; i < assoc_chunk; i++){
+      c->link[i]._lnext = _free;
+      _free = &c->link[i];
+    }
+  }
+  Link* k = _free;
+  _free   = k->_lnext;
+  return k;
+}
+
+/*! tie l and r by a new link; returns the link */
+Assoc::Link *Assoc::link(Left* l, Right* r){
+/* require */
+  if( l==NULL || r==NULL ) return NULL;
+
+  Link* k = alloc();
+  if( k == NULL ) return NULL;
+
+  k->_left  = l;
+  k->_right = r;
+  if( l->_links ){                        /* add as the last of l */
+    k->_lnext = l->_links;
+    k->_lprev = l->_links->_lprev;
+    k->_lprev->_lnext = k;
+    l->_links->_lprev = k;
+  }else
+    l->_links = k->_lnext = k->_lprev = k;
+  if( r->_links ){                        /* add as the last of r */
+    k->_rnext = r->_links;
+    k->_rprev = r->_links->_rprev;
+    k->_rprev->_rnext = k;
+    r->_links->_rprev = k;
+  }else
+    r->_links = k->_rnext = k->_rprev = k;
+  l->_num++;
+  r->_num++;
+  _num++;
+  return k;
+}
+
+/*! untie the link from both sides in O(1), and return it to the pool */
+void Assoc::unlink(Link* k){
+/* require */
+  if( k==NULL || k->_left==NULL ) return;
+
+  Left*   l = k->_left;
+  Right*  r = k->_right;
+
+  if( k->_lnext == k )
+    l->_links = NULL;
+  else{
+    k->_lprev->_lnext = k->_lnext;
+    k->_lnext->_lprev = k->_lprev;
+    if( l->_links == k ) l->_links = k->_lnext;
+  }
+  if( k->_rnext == k )
+    r->_links = NULL;
+  else{
+    k->_rprev->_rnext = k->_rnext;
+    k->_rnext->_rprev = k->_rprev;
+    if( r->_links == k ) r->_links = k->_rnext;
+  }
+  l->_num--;
+  r->_num--;
+  _num--;
+
+  k->_left  = NULL;
+  k->_right = NULL;
+  k->_lnext = _free;
+  _free     = k;
+}
+
+/*! untie all links of l; returns number of them */
+int Assoc::unlink_left(Left* l){
+  if( l==NULL ) return 0;
+  int n = 0;
+  while( l->_links ){
+    unlink(l->_links);
+    n++;
+  }
+  return n;
+}
+
+/*! untie all links of r; returns number of them */
+int Assoc::unlink_right(Right* r){
+  if( r==NULL ) return 0;
+  int n = 0;
+  while( r->_links ){
+    unlink(r->_links);
+    n++;
+  }
+  return n;
+}
+
+/*! find a link between l and r by the side of fewer links */
+Assoc::Link *Assoc::sel(Left* l, Right* r){
+  if( l==NULL || r==NULL || l->_links==NULL || r->_links==NULL ) return NULL;
+
+  if( l->_num <= r->_num ){
+    Link* k = l->_links;
+    do{
+      if( k->_right == r ) return k;
+    }while( (k = k->_lnext) != l->_links );
+  }else{
+    Link* k = r->_links;
+    do{
+      if( k->_left == l ) return k;
+    }while( (k = k->_rnext) != r->_links );
+  }
+  return NULL;
+}
+
+/*! get number of links of l */
+int Assoc::num_left(Left* l){
+  return l ? l->_num : 0;
+}
+
+/*! get number of links of r */
+int Assoc::num_right(Right* r){
+  return r ? r->_num : 0;
+}
+
+/*! get number of links in the pattern */
+long Assoc::num(){
+  return _num;
+}
+
+/*! get Right of the next link */
+Assoc::Right *Assoc::Rights::operator++(){
+  _curr = _next;
+  if( _curr == NULL ) return NULL;
+  _next = (_curr == _last) ? NULL : _curr->_lnext;
+  return _curr->_right;
+}
+
+/*! get Left of the next link */
+Assoc::Left *Assoc::Lefts::operator++(){
+  _curr = _next;
+  if( _curr == NULL ) return NULL;
+  _next = (_curr == _last) ? NULL : _curr->_rnext;
+  return _curr->_left;
+}
+
+}; // jj
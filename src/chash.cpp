@@ -0,0 +1,342 @@
+/*!
+\file   chash.cpp
+\brief  Concurrent (sharded) Hash pattern
+*/
+
+#include <stdlib.h>
+#include "jj/errno.h"
+#include "jj/chash.h"
+
+
+namespace jj {
+
+static Errno      g_eh;
+
+enum Error {
+  chash_del_internal_error  = 1
+};
+
+/*!
+\class  CHash
+\brief  define holder-element relation with hash-search, shared by threads.
+
+CHash is the same holder-entry relation as jj::Hash, but the holder can
+be used from many threads at the same time without any external lock.
+
+### Data structure
+
+The holder is striped into `2^bits` shards selected by the upper bits of
+the (mixed) hash value.  Each shard has its own bucket array (ring per
+bucket like jj::Hash), its own writer lock and a sequence counter:
+
+* writers (add(), del()) take the shard lock and make the sequence odd
+  while they relink entries, then even again.
+* readers (sel()) never take a lock.  They read the sequence, walk the
+  chain and retry only when the sequence has been changed meanwhile.
+
+Each shard is expanded independently when its own entries are twice as
+many as its array size.  The replaced array may still be read by sel() on
+other threads, so it is kept until the holder is destroyed (the total is
+less than twice of the final array).
+
+Entry returned by sel() is just a pointer; if other thread may del() and
+free it, protect the reader by jj::Epoch.
+
+### Example
+
+    #include <jj/chash.h>
+    #include "ex.b"
+
+    class App  : INHERIT_App  {...};
+    class Atom : INHERIT_Atom {...};
+
+    jjCHash (atom_hash, App, Atom);
+
+    int atom_hash_class::hash_base(Entry *e){ ... }
+    int atom_hash_class::cmp_base(Entry *e1, Entry *e2){ ... }
+
+See [chash_test.cpp](../test/pattern/chash_test.cpp) source as actual sample.
+*/
+
+/*!
+\class  CHash::Holder
+\brief  Holder base class for jj::CHash pattern.
+*/
+
+/*!
+\class  CHash::Entry
+\brief  Entry base class for jj::CHash pattern.
+*/
+
+/*!
+\class  CHash::Iter
+\brief  Iterator class for jj::CHash pattern.
+
+Iter does not lock shards; use it only while no other thread writes.
+*/
+static const int
+  chash_init_bits     =  4,   /* default shard number = 2^4 */
+  chash_init_size     = 16,   /* initial array size per shard */
+  chash_inc_magnitude =  2;   /* magnitude for each increasing timing */
+
+class CHash::Table {
+public:
+  int                   _size;
+  std::atomic<Entry*>*  _tail;
+  Table*                _old;
+
+  Table(int size){
+    _size = size;
+    _tail = new std::atomic<Entry*>[size]();
+    _old  = NULL;
+  }
+ ~Table(){ delete[] _tail; }
+};
+
+CHash::Shard::Shard(){
+  _seq    = 0;
+  _table  = NULL;
+  _num    = 0;
+  _old    = NULL;
+}
+
+CHash::Shard::~Shard(){
+  Table *t, *o;
+
+  delete _table.load();
+  for(t=_old; t; t=o){
+    o = t->_old;
+    delete t;
+  }
+}
+
+void CHash::Holder::init(int bits){
+  _bits   = bits;
+  _shard  = new Shard[1 << bits];
+}
+
+CHash::Holder::Holder(){ init(chash_init_bits); }
+
+CHash::Holder::Holder(int bits){ init(bits); }
+
+CHash::Holder::~Holder(){
+  delete[] _shard;
+}
+
+/*
+shard is chosen by upper bits of multiplicative hash while bucket is by
+'hash % size' so that both are independent.
+*/
+CHash::Shard* CHash::shard(Holder* h, int hash){
+  if( h->_bits == 0 ) return h->_shard;
+  unsigned m = (unsigned)hash * 0x9e3779b1u;
+  return &h->_shard[m >> (32 - h->_bits)];
+}
+
+/*
+called under the shard lock, in the odd sequence
+*/
+void CHash::expand(Shard* s, int new_size){
+  Table*  t   = s->_table.load(std::memory_order_relaxed);
+  Table*  nt  = new Table(new_size);
+
+  if( t ){
+    for(int i=0; i<t->_size; i++){
+      Entry*  beg = t->_tail[i].load(std::memory_order_relaxed),
+           *  nxt,
+           *  e;
+      if( !beg ) continue;
+      for(nxt = beg->_next.load(std::memory_order_relaxed); nxt;){
+        e = nxt;
+        if(nxt == beg)
+          nxt = beg = NULL;
+        else
+          nxt = e->_next.load(std::memory_order_relaxed);
+
+        int     ix    = e->_hash.load(std::memory_order_relaxed) % nt->_size;
+        Entry*  tail  = nt->_tail[ix].load(std::memory_order_relaxed);
+        if( tail ){
+          e->_next.store(tail->_next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+          tail->_next.store(e, std::memory_order_relaxed);
+        }else{
+          e->_next.store(e, std::memory_order_relaxed);
+        }
+        nt->_tail[ix].store(e, std::memory_order_relaxed);
+      }
+    }
+    t->_old = s->_old;      /* retire; sel() may still read it */
+    s->_old = t;
+  }
+  s->_table.store(nt, std::memory_order_release);
+}
+
+/* begin/end of the writer section of seqlock */
+static inline void write_begin(std::atomic<unsigned>& seq){
+  seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+static inline void write_end(std::atomic<unsigned>& seq){
+  seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void CHash::add(Holder* h, Entry* e){
+/* require */
+  if( h==NULL || e==NULL ) return;
+
+/* check */
+  if( e->_next.load(std::memory_order_relaxed) != NULL ) return;
+
+  int     hash  = hash_base(e);
+  e->_hash.store(hash, std::memory_order_relaxed);
+  Shard*  s = shard(h, hash);
+  std::lock_guard<std::mutex> lock(s->_lock);
+
+  write_begin(s->_seq);
+  Table*  t = s->_table.load(std::memory_order_relaxed);
+  if( t==NULL ){
+    expand(s, chash_init_size);
+    t = s->_table.load(std::memory_order_relaxed);
+  }else if( s->_num.load(std::memory_order_relaxed) > t->_size * 2 ){
+    expand(s, t->_size * chash_inc_magnitude);
+    t = s->_table.load(std::memory_order_relaxed);
+  }
+
+  int     ix    = hash % t->_size;
+  Entry*  tail  = t->_tail[ix].load(std::memory_order_relaxed);
+  if( tail ){
+    e->_next.store(tail->_next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    tail->_next.store(e, std::memory_order_release);
+  }else{
+    e->_next.store(e, std::memory_order_relaxed);
+  }
+  t->_tail[ix].store(e, std::memory_order_release);
+  s->_num.fetch_add(1, std::memory_order_relaxed);
+  write_end(s->_seq);
+}
+
+void CHash::del(Holder* h, Entry* e){
+/* require */
+  if( h==NULL || e==NULL ) return;
+  if( e->_next.load(std::memory_order_relaxed) == NULL ) return;
+
+  int     hash  = e->_hash.load(std::memory_order_relaxed);
+  Shard*  s = shard(h, hash);
+  std::lock_guard<std::mutex> lock(s->_lock);
+
+  Table*  t   = s->_table.load(std::memory_order_relaxed);
+  if( t==NULL ){                      // e is of another holder
+    jj::raise(g_eh, chash_del_internal_error);
+    return;
+  }
+  int     ix  = hash % t->_size;
+  Entry*  tail= t->_tail[ix].load(std::memory_order_relaxed),
+       *  p,
+       *  n;
+
+  for(p=tail; p; p=n){                //find 'p' points to e
+    n = p->_next.load(std::memory_order_relaxed);
+    if( n==e ) break;
+    if( n==tail ) n = NULL;
+  }
+  if( p==NULL ){
+    jj::raise(g_eh, chash_del_internal_error);
+    return;
+  }
+
+  write_begin(s->_seq);
+  if( p == e ){                       // last entry?
+    t->_tail[ix].store(NULL, std::memory_order_relaxed);
+  }else{
+    p->_next.store(e->_next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    if( tail == e ) t->_tail[ix].store(p, std::memory_order_relaxed);
+  }
+  e->_next.store(NULL, std::memory_order_relaxed);
+  s->_num.fetch_sub(1, std::memory_order_relaxed);
+  write_end(s->_seq);
+}
+
+/*
+Implementation Note: chain may be relinked by writer while walking; then
+it can end at NULL (deleted entry) or go around other ring.  Both are
+detected by the sequence, and the walk is bounded by the shard entry
+number so that it never loops forever.
+*/
+jj::CHash::Entry* CHash::sel(Holder* h, Entry* key){
+  if( h == NULL || key == NULL ) return NULL;
+
+  int     hash  = hash_base(key);
+  Shard*  s     = shard(h, hash);
+
+  for(;;){
+    unsigned  seq = s->_seq.load(std::memory_order_acquire);
+    if( seq & 1 ) continue;           /* writer is running */
+
+    Entry*  found = NULL;
+    Table*  t     = s->_table.load(std::memory_order_acquire);
+    if( t ){
+      int     limit = s->_num.load(std::memory_order_relaxed) + 1;
+      Entry*  beg   = t->_tail[hash % t->_size].load(std::memory_order_acquire),
+           *  e     = beg ? beg->_next.load(std::memory_order_acquire) : NULL;
+
+      for(; e && limit > 0; limit--){
+        if( e->_hash.load(std::memory_order_relaxed) == hash && cmp_base(e, key)==0 ){
+          found = e;
+          break;
+        }
+        if( e == beg ) break;         /* end of list */
+        e = e->_next.load(std::memory_order_acquire);
+      }
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if( s->_seq.load(std::memory_order_relaxed) == seq )
+      return found;
+  }
+}
+
+int CHash::num(Holder* h){
+  if( h==NULL ) return 0;
+  int n = 0;
+  for(int i=0; i < (1 << h->_bits); i++)
+    n += h->_shard[i]._num.load(std::memory_order_relaxed);
+  return n;
+}
+
+void CHash::Iter::start(Holder* h){
+  _h          = h;
+  _sx         = 0;
+  _ix         = 0;
+  _beg        = NULL;
+}
+
+jj::CHash::Entry* CHash::Iter::operator++(){
+  if( _beg == NULL ){
+    /* find next non-empty slot */
+    for(;;){
+      if( _h == NULL || _sx >= (1 << _h->_bits) )
+        return NULL;            /* end of all shards */
+
+      Table* t = _h->_shard[_sx]._table.load(std::memory_order_acquire);
+      if( t == NULL || _ix >= t->_size ){
+        _sx++;
+        _ix = 0;
+        continue;
+      }
+      _beg = t->_tail[_ix++].load(std::memory_order_acquire);
+      if(_beg){
+        _nxt = _beg->_next.load(std::memory_order_acquire);
+        break;
+      }
+    }
+  }
+/* next entry */
+  Entry* e = _nxt;
+  if(_nxt == _beg)
+    _nxt = _beg = NULL;             /* end of list */
+  else{
+    _nxt = e->_next.load(std::memory_order_acquire);
+  }
+  return e;
+}
+
+}; // jj
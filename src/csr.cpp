@@ -0,0 +1,257 @@
+/*!
+\file   csr.cpp
+\brief  CSR (compressed sparse row) snapshot of Graph and Aggregate tree
+*/
+
+#include <malloc.h>
+#include <string.h>
+#include "jj/errno.h"
+#include "jj/pattern.h"
+
+
+namespace jj {
+
+static Errno      g_eh;
+
+enum Error {
+  csr_not_tree    = 1
+};
+
+/*!
+\class  CSR
+\brief  read-only copy of Graph or tree in flat arrays for analytics.
+
+Walking the intrusive patterns follows one pointer per edge, and each
+pointer is likely a cache miss on a large graph.  Whole-graph algorithms
+(BFS, PageRank, subtree aggregate, ...) which visit every edge many times
+run much faster on a compact copy:
+
+* nodes are numbered 0..num()-1
+* out-edges of node i are `adj(i)[0 .. degree(i)-1]`, all in one array
+
+The snapshot is not updated by later add()/del() on the pattern; freeze()
+again to take a new one.  node(i) gives back the pattern object so that
+results can be written to the models.
+
+### Tree
+
+freeze(Aggregate*, root) numbers the tree by BFS from root (index 0).
+Children of a node have consecutive indices, parent(i) < i, so that
+subtree_sum() is a single backward pass.  The tree must be
+jjAggregate(id, Node, Node); Parent and Child parts of one object are
+connected by Aggregate::as_parent().
+
+### Graph
+
+freeze(Graph*, nodes, n) numbers nodes as given in nodes[].  Edges to the
+nodes not in nodes[] are dropped.  Node index is also kept in the node
+itself for the last freeze().
+
+### Example
+
+    jjGraph (net, Host, Link);
+
+    jj::CSR   s;
+    double*   rank = new double[n];
+
+    net.freeze(&s, hosts, n);
+    s.pagerank(rank, 20, 0.85);
+    for(int i=0; i < s.num(); i++) net.node(&s, i)->rank = rank[i];
+
+See [csr_test.cpp](../test/pattern/csr_test.cpp) source as actual sample.
+*/
+CSR::CSR(){
+  _num    = 0;
+  _off    = NULL;
+  _dst    = NULL;
+  _parent = NULL;
+  _node   = NULL;
+}
+
+CSR::~CSR(){
+  clear();
+}
+
+/*! free the snapshot */
+void CSR::clear(){
+  free(_off);
+  free(_dst);
+  free(_parent);
+  free(_node);
+  _num    = 0;
+  _off    = NULL;
+  _dst    = NULL;
+  _parent = NULL;
+  _node   = NULL;
+}
+
+/*! take snapshot of the tree under root */
+void CSR::freeze(Aggregate* a, Aggregate::Parent* root){
+  clear();
+  if( a==NULL || root==NULL ) return;
+
+  int   cap = 64;
+  _node     = (void**)malloc(sizeof(void*) * cap);
+  _parent   = (int*)  malloc(sizeof(int)   * cap);
+  _off      = (int*)  malloc(sizeof(int)   * (cap + 1));
+
+  _node[0]    = root;
+  _parent[0]  = -1;
+  _num        = 1;
+
+  /* _node[] is the BFS queue itself */
+  for(int i=0; i < _num; i++){
+    Aggregate::Parent*  p = (Aggregate::Parent*)_node[i];
+    _off[i] = _num - 1;         /* edge k goes to node k+1 */
+    if( p->_tail == NULL ) continue;
+
+    Aggregate::Child*   c = p->_tail;
+    do {
+      c = c->_next;
+      Aggregate::Parent* q = a->as_parent(c);
+      if( q == NULL ){
+        jj::raise(g_eh, csr_not_tree);
+        clear();
+        return;
+      }
+      if( _num == cap ){
+        cap    *= 2;
+        _node   = (void**)realloc(_node,   sizeof(void*) * cap);
+        _parent = (int*)  realloc(_parent, sizeof(int)   * cap);
+        _off    = (int*)  realloc(_off,    sizeof(int)   * (cap + 1));
+      }
+      _node[_num]   = q;
+      _parent[_num] = i;
+      _num++;
+    } while( c != p->_tail );
+  }
+  _off[_num] = _num - 1;
+
+  /* children are consecutive */
+  _dst    = (int*)malloc(sizeof(int) * (_num > 1 ? _num - 1 : 1));
+  for(int k=0; k < _num - 1; k++) _dst[k] = k + 1;
+}
+
+/*!
+allocate node table of n entries for freeze(Graph*); the caller sets
+Graph::Node* to each of them.  Used by the typed wrapper of jjGraph.
+*/
+void** CSR::prepare(int n){
+  clear();
+  if( n <= 0 ) return NULL;
+  _num  = n;
+  _node = (void**)calloc(n, sizeof(void*));
+  return _node;
+}
+
+/*! take snapshot of the graph among nodes[0..n-1] */
+void CSR::freeze(Graph* g, Graph::Node** nodes, int n){
+  void** t = prepare(n);
+  for(int i=0; i < n; i++) t[i] = nodes[i];
+  freeze(g);
+}
+
+/*! take snapshot of the graph among the nodes set by prepare() */
+void CSR::freeze(Graph* g){
+  if( g==NULL || _node==NULL ) return;
+
+  for(int i=0; i < _num; i++) ((Graph::Node*)_node[i])->_ix = i;
+
+  /* pass 1: count edges inside the node set */
+  _off = (int*)malloc(sizeof(int) * (_num + 1));
+  int m = 0;
+  for(int i=0; i < _num; i++){
+    Graph::Node* n = (Graph::Node*)_node[i];
+    _off[i] = m;
+    if( n->_out == NULL ) continue;
+    Graph::Edge* e = n->_out;
+    do {
+      e = e->_out_next;
+      int ix = e->_to->_ix;
+      if( ix >= 0 && ix < _num && _node[ix] == e->_to ) m++;
+    } while( e != n->_out );
+  }
+  _off[_num] = m;
+
+  /* pass 2: fill */
+  _dst = (int*)malloc(sizeof(int) * (m ? m : 1));
+  for(int i=0, k=0; i < _num; i++){
+    Graph::Node* n = (Graph::Node*)_node[i];
+    if( n->_out == NULL ) continue;
+    Graph::Edge* e = n->_out;
+    do {
+      e = e->_out_next;
+      int ix = e->_to->_ix;
+      if( ix >= 0 && ix < _num && _node[ix] == e->_to ) _dst[k++] = ix;
+    } while( e != n->_out );
+  }
+}
+
+/*!
+breadth first search from src.  dist[] (num() entries) gets hop count,
+or -1 if not reachable.  Returns the number of reached nodes.
+*/
+int CSR::bfs(int src, int* dist){
+  if( src < 0 || src >= _num || dist==NULL ) return 0;
+
+  int* q = (int*)malloc(sizeof(int) * _num);
+  int  head = 0, tail = 0;
+
+  for(int i=0; i < _num; i++) dist[i] = -1;
+  dist[src] = 0;
+  q[tail++] = src;
+  while( head < tail ){
+    int         u = q[head++];
+    const int*  d = _dst + _off[u];
+    const int*  e = _dst + _off[u+1];
+    for(; d < e; d++){
+      if( dist[*d] < 0 ){
+        dist[*d]  = dist[u] + 1;
+        q[tail++] = *d;
+      }
+    }
+  }
+  free(q);
+  return tail;
+}
+
+/*!
+PageRank by power iteration.  rank[] (num() entries) gets the result
+summing up to 1.  Rank of nodes without out-edge is spread to all nodes.
+*/
+void CSR::pagerank(double* rank, int iter, double damping){
+  if( rank==NULL || _num == 0 ) return;
+
+  double* next = (double*)malloc(sizeof(double) * _num);
+  for(int i=0; i < _num; i++) rank[i] = 1.0 / _num;
+
+  for(int it=0; it < iter; it++){
+    double dangling = 0;
+    for(int i=0; i < _num; i++){
+      if( _off[i] == _off[i+1] ) dangling += rank[i];
+    }
+    double base = (1.0 - damping + damping * dangling) / _num;
+    for(int i=0; i < _num; i++) next[i] = base;
+    for(int i=0; i < _num; i++){
+      int deg = _off[i+1] - _off[i];
+      if( deg == 0 ) continue;
+      double share = damping * rank[i] / deg;
+      for(int k=_off[i]; k < _off[i+1]; k++) next[_dst[k]] += share;
+    }
+    memcpy(rank, next, sizeof(double) * _num);
+  }
+  free(next);
+}
+
+/*!
+sum[i] = sum of val[] in the subtree of i; tree snapshot only.
+sum may be the same array as val.
+*/
+void CSR::subtree_sum(const long* val, long* sum){
+  if( _parent==NULL || val==NULL || sum==NULL ) return;
+
+  if( sum != val ) memcpy(sum, val, sizeof(long) * _num);
+  for(int i=_num-1; i > 0; i--) sum[_parent[i]] += sum[i];
+}
+
+}; // jj
@@ -0,0 +1,247 @@
+/*!
+\file   epoch.cpp
+\brief  Epoch based reclamation for patterns shared by threads
+*/
+
+#include "jj/errno.h"     /* before <thread>, which defines errno macro */
+#include <thread>
+#include "jj/epoch.h"
+
+
+namespace jj {
+
+static Errno      g_eh;
+
+enum Error {
+  epoch_too_many_threads  = 1
+};
+
+/*!
+\class  Epoch
+\brief  defer free of pattern participants until no reader can see them.
+
+Lock-free readers (e.g. jj::CHash::sel()) may still hold an entry which
+other thread has just del()-ed.  Epoch lets such readers run without any
+lock while the entry is freed safely later:
+
+* reader wraps its access by enter()/leave() (or Guard).  It only stores
+  the current global epoch in its own slot; it never waits.
+* writer unlinks the object from the pattern (del()) as usual, then calls
+  retire() instead of delete.
+* retired objects are passed to reclaim_base() after the global epoch has
+  advanced twice, which happens only when every reader in a critical
+  section has seen the current epoch.  So no reader can still hold them.
+
+Reader sections can be nested.  Do not call synchronize() in a section.
+
+The object itself must not be changed by del() in a way the reader can't
+follow (jj::CHash keeps it so); plain Collect, DCollect and Hash still
+need writers to be excluded from readers.
+
+### Example
+
+    #include <jj/epoch.h>
+    #include "ex.b"
+
+    class App  : INHERIT_App  {...};
+    class Atom : INHERIT_Atom {...};
+
+    jjCHash (atom_hash, App, Atom);
+    jjEpoch (gc,        App, Atom);
+
+    void gc_class::reclaim_base(Node *n){ delete (Atom*)n; }
+
+    // reader thread
+    {
+      jj::Epoch::Guard g = gc.guard(&app);
+      Atom* a = atom_hash.sel(&app, &key);    // 'a' is valid until '}'
+    }
+
+    // writer thread
+    atom_hash.del(&app, a);
+    gc.retire(&app, a);
+
+See [epoch_test.cpp](../test/pattern/epoch_test.cpp) source as actual sample.
+*/
+
+/*!
+\class  Epoch::Domain
+\brief  Domain base class for jj::Epoch pattern; readers and retired
+        objects of one domain are tracked together.
+*/
+
+/*!
+\class  Epoch::Node
+\brief  Node base class for jj::Epoch pattern (object to be retired).
+*/
+
+/*!
+\class  Epoch::Guard
+\brief  enter() at construction and leave() at destruction.
+*/
+static const int
+  epoch_max_threads = 256,    /* max threads alive at the same time */
+  epoch_batch       =  64;    /* retire() number to try advance() */
+
+/*
+Thread index registry.  Each thread gets the smallest free index at its
+first enter() and returns it at thread exit, so that Domain::_slot[] can
+be indexed directly.
+*/
+static std::mutex           g_reg_lock;
+static bool                 g_reg_used[epoch_max_threads];
+static std::atomic<int>     g_reg_high(0);    /* max index + 1 ever used */
+
+class ThreadIndex {
+public:
+  int   _ix;
+
+  ThreadIndex(){
+    std::lock_guard<std::mutex> lock(g_reg_lock);
+    for(_ix=0; _ix < epoch_max_threads; _ix++){
+      if( !g_reg_used[_ix] ) break;
+    }
+    if( _ix == epoch_max_threads ){
+      jj::raise2_(g_eh, epoch_too_many_threads, __FILE__, __LINE__);
+      _ix = -1;
+      return;
+    }
+    g_reg_used[_ix] = true;
+    if( _ix + 1 > g_reg_high.load() ) g_reg_high.store(_ix + 1);
+  }
+ ~ThreadIndex(){
+    std::lock_guard<std::mutex> lock(g_reg_lock);
+    if( _ix >= 0 ) g_reg_used[_ix] = false;
+  }
+};
+
+static int thread_index(){
+  static thread_local ThreadIndex t;
+  return t._ix;
+}
+
+Epoch::Domain::Domain(){
+  _global   = 1;
+  _slot     = new Slot[epoch_max_threads];
+  _limbo[0] = _limbo[1] = _limbo[2] = NULL;
+  _num      = 0;
+  _batch    = 0;
+}
+
+/*
+Objects still retired here are not reclaimed since Domain doesn't know
+reclaim_base(); call synchronize() before.
+*/
+Epoch::Domain::~Domain(){
+  delete[] _slot;
+}
+
+/*! enter reader critical section */
+void Epoch::enter(Domain* d){
+  int ix = thread_index();
+  if( d==NULL || ix < 0 ) return;
+
+  Slot& s = d->_slot[ix];
+  if( s._nest++ > 0 ) return;
+
+  unsigned long g = d->_global.load(std::memory_order_relaxed);
+  for(;;){
+    s._epoch.store(g, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    unsigned long g2 = d->_global.load(std::memory_order_relaxed);
+    if( g2 == g ) break;
+    g = g2;
+  }
+}
+
+/*! leave reader critical section */
+void Epoch::leave(Domain* d){
+  int ix = thread_index();
+  if( d==NULL || ix < 0 ) return;
+
+  Slot& s = d->_slot[ix];
+  if( --s._nest > 0 ) return;
+  s._epoch.store(0, std::memory_order_release);
+}
+
+/*
+advance global epoch if all readers in section have seen it.
+Called under d->_lock.  On success, retired list which is no more
+visible is set to *freed.
+*/
+bool Epoch::advance(Domain* d, Node** freed){
+  unsigned long g     = d->_global.load(std::memory_order_relaxed);
+  int           high  = g_reg_high.load(std::memory_order_acquire);
+
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  for(int i=0; i < high; i++){
+    unsigned long e = d->_slot[i]._epoch.load(std::memory_order_acquire);
+    if( e != 0 && e != g ) return false;
+  }
+  d->_global.store(g + 1, std::memory_order_release);
+
+  /* retired at g-2 (the same bag as g+1) can't be seen anymore */
+  *freed                = d->_limbo[(g + 1) % 3];
+  d->_limbo[(g + 1) % 3] = NULL;
+  d->_batch             = 0;
+  return true;
+}
+
+void Epoch::free_list(Node* n){
+  Node* next;
+  for(; n; n=next){
+    next = n->_next;
+    n->_next = NULL;
+    reclaim_base(n);
+  }
+}
+
+/*! pass n to reclaim_base() later when no reader can see it */
+void Epoch::retire(Domain* d, Node* n){
+/* require */
+  if( d==NULL || n==NULL ) return;
+
+  Node* freed = NULL;
+  {
+    std::lock_guard<std::mutex> lock(d->_lock);
+    unsigned long g = d->_global.load(std::memory_order_relaxed);
+    n->_next            = d->_limbo[g % 3];
+    d->_limbo[g % 3]    = n;
+    d->_num++;
+    if( ++d->_batch >= epoch_batch ) advance(d, &freed);
+    for(Node* f=freed; f; f=f->_next) d->_num--;
+  }
+  free_list(freed);       /* out of lock; reclaim_base() may be slow */
+}
+
+/*! try to advance and reclaim; returns the number of reclaimed objects */
+int Epoch::reclaim(Domain* d){
+  if( d==NULL ) return 0;
+
+  Node* freed = NULL;
+  int   n     = 0;
+  {
+    std::lock_guard<std::mutex> lock(d->_lock);
+    advance(d, &freed);
+    for(Node* f=freed; f; f=f->_next) n++;
+    d->_num -= n;
+  }
+  free_list(freed);
+  return n;
+}
+
+/*! wait until all retired objects are reclaimed */
+void Epoch::synchronize(Domain* d){
+  while( num(d) > 0 ){
+    if( reclaim(d) == 0 ) std::this_thread::yield();
+  }
+}
+
+/*! get number of retired, but not yet reclaimed, objects */
+int Epoch::num(Domain* d){
+  if( d==NULL ) return 0;
+  std::lock_guard<std::mutex> lock(d->_lock);
+  return d->_num;
+}
+
+}; // jj
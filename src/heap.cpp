@@ -0,0 +1,231 @@
+/*!
+\file   heap.cpp
+\brief  intrusive pairing heap pattern
+*/
+
+#include "jj/errno.h"
+#include "jj/heap.h"
+
+
+namespace jj {
+
+static Errno      g_eh;
+
+enum Error {
+  heap_del_internal_error   = 1
+};
+
+/*!
+\class  Heap
+\brief  define holder-entry relation as a priority queue (pairing heap).
+
+Heap keeps entries so that the least one by cmp_base() is on top.  The
+links are in the entry itself, so an entry which also lives in Collects
+and Hashes is queued without extra allocation nor indirection, and can be
+reached in the heap directly:
+
+* add() and meld() are O(1).
+* pop() is amortized O(log n) by the two-pass pairing.
+* decrease() after the key of an entry got less is O(1) (amortized
+  o(log n)): the subtree of the entry is cut and linked to the root.
+* del() removes any entry in amortized O(log n); update() is del() and
+  add() for a key changed either way.
+
+Ties are in no particular order.  For a max-heap, invert cmp_base().
+
+An entry given to del(), decrease() and update() must be in the given
+holder.  The links don't tell the holder of an entry short of a walk to
+the root, so only the root of another heap is caught (it raises
+heap_del_internal_error and nothing changes); any other entry of another
+heap is cut out of it and linked into the given one, leaving num() of
+both wrong.
+
+### Example
+
+    #include <jj/heap.h>
+    #include "ex.b"
+
+    class Sched : INHERIT_Sched {...};
+    class Job   : INHERIT_Job   {...};
+
+    jjHeap (runq, Sched, Job);
+
+    int runq_class::cmp_base(Entry *e1, Entry *e2){
+      return ((Job*)e1)->deadline < ((Job*)e2)->deadline ? -1 : ...;
+    }
+
+    runq.add(&sched, job);
+    job->deadline -= boost;  runq.decrease(&sched, job);
+    runq.del(&sched, killed);
+    while( (job = runq.pop(&sched)) ) run(job);
+
+See [heap_test.cpp](../test/pattern/heap_test.cpp) source as actual sample.
+*/
+
+/*!
+\class  Heap::Entry
+\brief  Entry base class for jj::Heap pattern.
+*/
+
+/*!
+\class  Heap::Holder
+\brief  Holder base class for jj::Heap pattern.
+*/
+
+/* link two roots; the loser becomes leftmost child of the winner */
+Heap::Entry *Heap::link(Entry* a, Entry* b){
+  if( cmp_base(b, a) < 0 ){
+    Entry* t = a;  a = b;  b = t;
+  }
+  b->_next  = a->_child;
+  if( a->_child ) a->_child->_prev = b;
+  b->_prev  = a;
+  a->_child = b;
+  return a;
+}
+
+/* two-pass pairing of siblings from first; returns the new root */
+Heap::Entry *Heap::combine(Entry* first){
+  Entry*  stack = NULL;           /* pairs linked by _next, last on top */
+
+  /* pass 1: link pairs from left to right */
+  while( first ){
+    Entry*  a = first;
+    Entry*  b = a->_next;
+    if( b == NULL ){
+      a->_next  = stack;
+      stack     = a;
+      break;
+    }
+    first     = b->_next;
+    a->_next  = b->_next = NULL;
+    a         = link(a, b);
+    a->_next  = stack;
+    stack     = a;
+  }
+  if( stack == NULL ) return NULL;
+
+  /* pass 2: link them from right to left */
+  Entry*  r = stack;
+  stack     = stack->_next;
+  r->_next  = NULL;
+  while( stack ){
+    Entry* n      = stack->_next;
+    stack->_next  = NULL;
+    r             = link(r, stack);
+    stack         = n;
+  }
+  return r;
+}
+
+/* detach entry (not root) with its subtree from the siblings */
+void Heap::cut(Entry* e){
+  if( e->_prev->_child == e )
+    e->_prev->_child  = e->_next;     /* leftmost: _prev is parent */
+  else
+    e->_prev->_next   = e->_next;
+  if( e->_next ) e->_next->_prev = e->_prev;
+  e->_next  = NULL;
+}
+
+/*! add entry in O(1) */
+void Heap::add(Holder* h, Entry* e){
+/* require */
+  if( h==NULL || e==NULL ) return;
+
+/* check */
+  if( e->_prev != NULL ) return;        /* already added */
+
+  e->_child = e->_next = NULL;
+  h->_root  = h->_root ? link(h->_root, e) : e;
+  h->_root->_prev = h->_root;
+  h->_num++;
+}
+
+/*! delete any entry from heap */
+void Heap::del(Holder* h, Entry* e){
+/* require */
+  if( h==NULL || e==NULL ) return;
+
+/* check */
+  if( e->_prev == NULL ) return;
+  if( e->_prev == e && e != h->_root ){   /* root of another heap */
+    ::jj::raise(g_eh, heap_del_internal_error);
+    return;
+  }
+
+  if( e == h->_root ){
+    pop(h);
+    return;
+  }
+  cut(e);
+  Entry* sub = combine(e->_child);
+  if( sub ){
+    h->_root = link(h->_root, sub);
+    h->_root->_prev = h->_root;
+  }
+  e->_child = e->_prev = NULL;
+  h->_num--;
+}
+
+/*! get the least entry */
+Heap::Entry *Heap::top(Holder* h){
+  return h ? h->_root : NULL;
+}
+
+/*! remove the least entry and return it */
+Heap::Entry *Heap::pop(Holder* h){
+  if( h==NULL || h->_root==NULL ) return NULL;
+
+  Entry* r = h->_root;
+  h->_root = combine(r->_child);
+  if( h->_root ) h->_root->_prev = h->_root;
+  r->_child = r->_next = r->_prev = NULL;
+  h->_num--;
+  return r;
+}
+
+/*! restore the order after the key of entry got less (or equal) */
+void Heap::decrease(Holder* h, Entry* e){
+/* require */
+  if( h==NULL || e==NULL ) return;
+
+/* check */
+  if( e->_prev == NULL || e == h->_root ) return;
+  if( e->_prev == e ){                    /* root of another heap */
+    ::jj::raise(g_eh, heap_del_internal_error);
+    return;
+  }
+
+  cut(e);
+  h->_root = link(h->_root, e);
+  h->_root->_prev = h->_root;
+}
+
+/*! restore the order after the key of entry changed either way */
+void Heap::update(Holder* h, Entry* e){
+/* require */
+  if( h==NULL || e==NULL || e->_prev == NULL ) return;
+
+  del(h, e);
+  add(h, e);
+}
+
+/*! move all entries of 'from' into h in O(1) */
+void Heap::meld(Holder* h, Holder* from){
+/* require */
+  if( h==NULL || from==NULL || h==from || from->_root==NULL ) return;
+
+  h->_root  = h->_root ? link(h->_root, from->_root) : from->_root;
+  h->_root->_prev = h->_root;
+  h->_num  += from->_num;
+  from->_root = NULL;
+  from->_num  = 0;
+}
+
+/*! get number of entries */
+int Heap::num(Holder* h){
+  return h ? h->_num : 0;
+}
+
+}; // jj
@@ -0,0 +1,113 @@
+/*!
+\file   lhash.cpp
+\brief  linked Hash pattern: Hash with insertion-ordered ring
+*/
+
+#include "jj/lhash.h"
+
+
+namespace jj {
+
+/*!
+\class  LHash
+\brief  define holder-entry relation with lookup and insertion order.
+
+LHash is a Hash (jj::Hash) whose entries are also threaded onto a ring
+(jj::DCollect) in the order of add():
+
+* Iter walks the entries in insertion order in O(n).  The order is
+  stable, whatever expand() of the Hash did to the buckets, so outputs
+  and snapshots are deterministic without sort.
+* pop() removes the oldest entry in O(1), i.e. FIFO eviction out of a
+  Hash; first() / last() are the oldest / newest.
+* sel() by key, add() and del() stay O(1) as Hash.
+
+del() and add() again moves an entry to the newest.  As Hash, entries of
+the same key may be added; sel() finds one of them.
+
+### Example
+
+    #include <jj/lhash.h>
+    #include "ex.b"
+
+    class Conf : INHERIT_Conf {...};
+    class Item : INHERIT_Item {...};
+
+    jjLHash (items, Conf, Item);
+
+    int items_class::hash_base(Entry *e){ ... }
+    int items_class::cmp_base(Entry *e1, Entry *e2){ ... }
+
+    items.add(&conf, item);
+    items_class::Iter i(&conf);             // as added
+    for(Item* p; (p = ++i); ) dump(p);
+    while( items.num(&conf) > max ) delete items.pop(&conf);
+
+See [lhash_test.cpp](../test/pattern/lhash_test.cpp) source as actual sample.
+*/
+
+/*!
+\class  LHash::Entry
+\brief  Entry base class for jj::LHash pattern.
+*/
+
+/*!
+\class  LHash::Holder
+\brief  Holder base class for jj::LHash pattern.
+*/
+
+/*! add entry as the newest */
+void LHash::add(Holder* h, Entry* e){
+/* require */
+  if( h==NULL || e==NULL ) return;
+
+/* check */
+  if( _ring.next(e) != NULL ) return;       /* already added */
+
+  _index.add(h, e);
+  _ring.add(h, e);
+}
+
+/*! delete entry */
+void LHash::del(Holder* h, Entry* e){
+/* require */
+  if( h==NULL || e==NULL ) return;
+
+/* check */
+  if( _ring.next(e) == NULL ) return;
+
+  _index.del(h, e);
+  _ring.unlink(h, e);
+}
+
+/*! find entry of the key */
+LHash::Entry *LHash::sel(Holder* h, Entry* key){
+  if( h==NULL || key==NULL ) return NULL;
+  return static_cast<Entry*>(_index.sel(h, key));
+}
+
+/*! get the oldest entry */
+LHash::Entry *LHash::first(Holder* h){
+  if( h==NULL ) return NULL;
+  return static_cast<Entry*>(_ring.child(h));
+}
+
+/*! get the newest entry */
+LHash::Entry *LHash::last(Holder* h){
+  if( h==NULL ) return NULL;
+  return static_cast<Entry*>(_ring.last(h));
+}
+
+/*! remove the oldest entry and return it */
+LHash::Entry *LHash::pop(Holder* h){
+  Entry* e = first(h);
+  if( e ) del(h, e);
+  return e;
+}
+
+/*! get number of entries */
+int LHash::num(Holder* h){
+  return _ring.num(h);
+}
+
+}; // jj
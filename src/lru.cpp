@@ -0,0 +1,203 @@
+/*!
+\file   lru.cpp
+\brief  LRU cache pattern by Hash and DCollect
+*/
+
+#include "jj/lru.h"
+
+
+namespace jj {
+
+/*!
+\class  LRU
+\brief  define cache-entry relation with lookup and least-recently-used order.
+
+LRU is the usual "Hash + list" cache made one pattern, so that the two
+are never out of sync:
+
+* sel() finds the entry by key (jj::Hash) and moves it to the most
+  recently used end of the list (jj::DCollect); a hit or a miss is
+  counted.
+* add() puts an entry of a cost (1 by default) as the most recently used;
+  while the sum of cost exceeds the capacity, the least recently used
+  entries are removed and passed to evict_base(), where the user may
+  free them.  The entry just added is never evicted by its own add().
+
+All operations are O(1).  peek() finds without touching nor counting.
+
+### Example
+
+    #include <jj/lru.h>
+    #include "ex.b"
+
+    class Store : INHERIT_Store {...};
+    class Page  : INHERIT_Page  {...};
+
+    jjLRU (pages, Store, Page);
+
+    int  pages_class::hash_base(Entry *e){ ... }
+    int  pages_class::cmp_base(Entry *e1, Entry *e2){ ... }
+    void pages_class::evict_base(Cache *c, Entry *e){ delete (Page*)e; }
+
+    pages.capacity(&store, 64 << 20);
+    Page  key(no), *p;
+    if( (p = pages.sel(&store, &key)) == NULL ){
+      p = load(no);
+      pages.add(&store, p, p->size);
+    }
+
+See [lru_test.cpp](../test/pattern/lru_test.cpp) source as actual sample.
+*/
+
+/*!
+\class  LRU::Entry
+\brief  Entry base class for jj::LRU pattern.
+*/
+
+/*!
+\class  LRU::Cache
+\brief  Cache base class for jj::LRU pattern.
+*/
+LRU::Cache::Cache(){
+  _capacity   = 0;
+  _cost       = 0;
+  _hits       = _misses = _evictions = 0;
+}
+
+/*! capacity is max of sum of cost; 0 for no limit */
+LRU::Cache::Cache(long capacity){
+  _capacity   = capacity;
+  _cost       = 0;
+  _hits       = _misses = _evictions = 0;
+}
+
+/* evict the least recently used but 'keep' until cost fits capacity */
+void LRU::shrink(Cache* c, Entry* keep){
+  while( c->_capacity > 0 && c->_cost > c->_capacity ){
+    Entry* e = oldest(c);
+    if( e == NULL || e == keep ) break;
+    evict(c);
+  }
+}
+
+/*! add entry as the most recently used; evict old ones over capacity */
+void LRU::add(Cache* c, Entry* e, long cost){
+/* require */
+  if( c==NULL || e==NULL ) return;
+
+/* check */
+  if( _list.next(e) != NULL ) return;       /* already added */
+
+  e->_cost = cost;
+  _index.add(c, e);
+  _list.add(c, e);
+  c->_cost += cost;
+  shrink(c, e);
+}
+
+/*! delete entry from cache (evict_base() is not called) */
+void LRU::del(Cache* c, Entry* e){
+/* require */
+  if( c==NULL || e==NULL ) return;
+
+/* check */
+  if( _list.next(e) == NULL ) return;
+
+  _index.del(c, e);
+  _list.unlink(c, e);
+  c->_cost -= e->_cost;
+}
+
+/*! find entry of the key and make it the most recently used */
+LRU::Entry *LRU::sel(Cache* c, Entry* key){
+  if( c==NULL || key==NULL ) return NULL;
+  Entry* e = peek(c, key);
+  if( e ){
+    c->_hits++;
+    touch(c, e);
+  }else
+    c->_misses++;
+  return e;
+}
+
+/*! find entry of the key without changing order nor stat */
+LRU::Entry *LRU::peek(Cache* c, Entry* key){
+  if( c==NULL || key==NULL ) return NULL;
+  return static_cast<Entry*>(_index.sel(c, key));
+}
+
+/*! make entry the most recently used */
+void LRU::touch(Cache* c, Entry* e){
+  if( c==NULL || e==NULL || _list.next(e) == NULL ) return;
+  if( _list.last(c) == e ) return;
+  _list.unlink(c, e);
+  _list.add(c, e);
+}
+
+/*! remove the least recently used entry and pass it to evict_base();
+    returns the entry (it may have been freed by evict_base()) */
+LRU::Entry *LRU::evict(Cache* c){
+  Entry* e = oldest(c);
+  if( e == NULL ) return NULL;
+  del(c, e);
+  c->_evictions++;
+  evict_base(c, e);
+  return e;
+}
+
+/*! get the least recently used entry */
+LRU::Entry *LRU::oldest(Cache* c){
+  if( c==NULL ) return NULL;
+  return static_cast<Entry*>(_list.child(c));
+}
+
+/*! get the most recently used entry */
+LRU::Entry *LRU::newest(Cache* c){
+  if( c==NULL ) return NULL;
+  return static_cast<Entry*>(_list.last(c));
+}
+
+/*! set capacity (0: no limit) and evict over it */
+void LRU::capacity(Cache* c, long capacity){
+  if( c==NULL ) return;
+  c->_capacity = capacity;
+  shrink(c, NULL);
+}
+
+/*! get capacity */
+long LRU::capacity(Cache* c){
+  return c ? c->_capacity : 0;
+}
+
+/*! get sum of cost of the entries */
+long LRU::cost(Cache* c){
+  return c ? c->_cost : 0;
+}
+
+/*! get number of entries */
+int LRU::num(Cache* c){
+  return _list.num(c);
+}
+
+/*! get number of sel() found */
+long LRU::hits(Cache* c){
+  return c ? c->_hits : 0;
+}
+
+/*! get number of sel() not found */
+long LRU::misses(Cache* c){
+  return c ? c->_misses : 0;
+}
+
+/*! get number of entries evicted */
+long LRU::evictions(Cache* c){
+  return c ? c->_evictions : 0;
+}
+
+/*! clear hits, misses and evictions */
+void LRU::reset_stat(Cache* c){
+  if( c==NULL ) return;
+  c->_hits = c->_misses = c->_evictions = 0;
+}
+
+}; // jj
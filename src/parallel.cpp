@@ -0,0 +1,471 @@
+/*!
+\file   parallel.cpp
+\brief  Multi-threaded traversal over Aggregate tree and Graph patterns
+*/
+
+#include "jj/errno.h"     /* before <thread>, which defines errno macro */
+#include <thread>
+#include "jj/parallel.h"
+
+
+namespace jj {
+
+static Errno      g_eh;
+
+enum Error {
+  parallel_not_tree   = 1
+};
+
+/* run id for Graph::Node::_bfs; shared by all Parallel since marks are in
+   the nodes */
+static std::atomic<unsigned>  g_stamp(0);
+
+static const int
+  parallel_chunk      = 64,     /* frontier nodes taken by a thread at once */
+  parallel_alpha      = 14,     /* see Parallel::bfs() */
+  parallel_beta       = 24,
+  parallel_cutoff     = 1024;   /* see Parallel::fold() */
+
+/*!
+\class  Parallel
+\brief  run traversal over a pattern by several threads.
+
+bfs() visits nodes level by level (level-synchronous BFS).  The nodes of
+the current level (frontier) are shared by the threads in chunks; each
+thread collects the nodes it reaches into its own next frontier, so that
+no lock is taken during a level.  At the end of a level the next
+frontiers are concatenated.
+
+Override visit_base() to do the work; it is called once for each reached
+node with its level, from any thread at the same time.
+
+### Graph
+
+A node is marked as reached by one compare-and-swap on the node itself, so
+the winner thread owns it.  When all nodes are given, the traversal is
+direction-optimizing: if the frontier has many out-edges, unreached nodes
+look for a parent in the frontier through their in-edge ring instead
+(bottom-up), which touches far fewer edges on low-diameter graphs.  It
+goes back to top-down when the frontier becomes small.  The switch
+follows Beamer's heuristic:
+
+* top-down to bottom-up when `edges(frontier) > edges(unreached) / alpha`
+* bottom-up to top-down when `nodes(frontier) < n / beta`
+
+level() gives the level of a node reached by the last bfs().
+
+### Tree
+
+A tree, jjAggregate(id, Node, Node), has no shared child, so no mark is
+needed.
+
+fold() computes a value of every subtree, e.g. size or checksum, by
+pre_base() / post_base() / reduce_base() on a work-stealing scheduler.  A
+task is a subtree.  It runs depth-first on its own stack (not recursion,
+so deep trees are fine) until `cutoff` nodes are done and some thread is
+idle; then the nodes on its stack wait in frames for their unvisited
+children, which are pushed as new tasks.  The owner takes the newest task
+(deep, small) and idle threads steal the oldest one (shallow, large).
+Subtrees of less than `cutoff` nodes are never split.
+
+### Example
+
+    class Count : public jj::Parallel {
+      std::atomic<long> _num;
+      void visit_base(jj::Graph::Node* n, int level){
+        Host* h = static_cast<Host*>(static_cast<net_Node*>(n));
+        ...
+      }
+    };
+
+    Count c;
+    c.bfs(&net, &hosts[0], all, n);
+
+See [parallel_test.cpp](../test/pattern/parallel_test.cpp) source as actual sample.
+*/
+
+/*!
+\class  Parallel::Barrier
+\brief  all threads wait here until the last one comes.
+*/
+void Parallel::Barrier::wait(){
+  unsigned g = _gen.load(std::memory_order_acquire);
+  if( _count.fetch_add(1, std::memory_order_acq_rel) + 1 == _num ){
+    _count.store(0, std::memory_order_relaxed);
+    _gen.fetch_add(1, std::memory_order_release);
+    return;
+  }
+  while( _gen.load(std::memory_order_acquire) == g ) std::this_thread::yield();
+}
+
+/*! threads=0 uses the number of hardware threads */
+Parallel::Parallel(int threads){
+  if( threads <= 0 ) threads = std::thread::hardware_concurrency();
+  _threads  = threads > 0 ? threads : 1;
+  _stamp    = 0;
+  _levels   = 0;
+  _alpha    = parallel_alpha;
+  _beta     = parallel_beta;
+  _cursor   = 0;
+  _worker   = NULL;
+  _idle     = 0;
+  _done     = false;
+  _result   = 0;
+  _cutoff   = parallel_cutoff;
+}
+
+/* run f(tid) on _threads threads including the caller */
+template<class F> void Parallel::run(F f){
+  std::vector<std::thread> t;
+  for(int i=1; i < _threads; i++) t.emplace_back(f, i);
+  f(0);
+  for(auto& i : t) i.join();
+}
+
+/*
+mark n as reached at level; true if this thread did it.
+_bfs is not std::atomic to keep Graph::Node copyable.
+*/
+bool Parallel::claim(Graph::Node* n, int level){
+  unsigned long long want = (unsigned long long)_stamp << 32 | (unsigned)level;
+  unsigned long long old  = __atomic_load_n(&n->_bfs, __ATOMIC_RELAXED);
+
+  while( (unsigned)(old >> 32) != _stamp ){
+    if( __atomic_compare_exchange_n(&n->_bfs, &old, want, false,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_RELAXED) )
+      return true;
+  }
+  return false;
+}
+
+void Parallel::top_down_step(Graph* g, int tid, int level){
+  std::vector<void*>& next  = _next[tid];
+  long                edges = 0;
+  long                size  = _frontier.size();
+
+  for(;;){
+    long b = _cursor.fetch_add(parallel_chunk, std::memory_order_relaxed);
+    if( b >= size ) break;
+    long e = b + parallel_chunk < size ? b + parallel_chunk : size;
+    for(; b < e; b++){
+      Graph::OutIter  o((Graph::Node*)_frontier[b]);
+      Graph::Edge*    x;
+      while( (x = ++o) ){
+        Graph::Node* v = g->to(x);
+        if( claim(v, level + 1) ){
+          next.push_back(v);
+          edges += v->_out_num;
+          visit_base(v, level + 1);
+        }
+      }
+    }
+  }
+  _next_edges[tid] = edges;
+}
+
+/* each unreached node in all[] looks for a parent at level */
+void Parallel::bottom_up_step(Graph* g, Graph::Node** all, int n, int tid, int level){
+  std::vector<void*>& next  = _next[tid];
+  long                edges = 0;
+  unsigned long long  parent = (unsigned long long)_stamp << 32 | (unsigned)level;
+
+  for(;;){
+    long b = _cursor.fetch_add(parallel_chunk, std::memory_order_relaxed);
+    if( b >= n ) break;
+    long e = b + parallel_chunk < n ? b + parallel_chunk : n;
+    for(; b < e; b++){
+      Graph::Node* v = all[b];
+      if( (unsigned)(__atomic_load_n(&v->_bfs, __ATOMIC_RELAXED) >> 32) == _stamp ) continue;
+
+      Graph::InIter i(v);
+      Graph::Edge*  x;
+      while( (x = ++i) ){
+        if( __atomic_load_n(&g->from(x)->_bfs, __ATOMIC_ACQUIRE) == parent ){
+          __atomic_store_n(&v->_bfs, parent + 1, __ATOMIC_RELEASE);   /* only this thread owns v */
+          next.push_back(v);
+          edges += v->_out_num;
+          visit_base(v, level + 1);
+          break;
+        }
+      }
+    }
+  }
+  _next_edges[tid] = edges;
+}
+
+void Parallel::tree_step(Aggregate* a, int tid, int level){
+  std::vector<void*>& next = _next[tid];
+  long                size = _frontier.size();
+
+  for(;;){
+    long b = _cursor.fetch_add(parallel_chunk, std::memory_order_relaxed);
+    if( b >= size ) break;
+    long e = b + parallel_chunk < size ? b + parallel_chunk : size;
+    for(; b < e; b++){
+      Aggregate::Iter   i((Aggregate::Parent*)_frontier[b]);
+      Aggregate::Child* c;
+      while( (c = ++i) ){
+        Aggregate::Parent* p = a->as_parent(c);
+        next.push_back(p);
+        visit_base(p, level + 1);
+      }
+    }
+  }
+}
+
+/*!
+visit the tree under root by BFS; returns the number of visited nodes.
+The aggregate must be jjAggregate(id, Node, Node).
+*/
+int Parallel::bfs(Aggregate* a, Aggregate::Parent* root){
+  _levels = 0;
+  if( a==NULL || root==NULL ) return 0;
+  if( a->as_child(root) == NULL ){
+    jj::raise(g_eh, parallel_not_tree);
+    return 0;
+  }
+
+  long    reached = 1;
+  bool    done    = false;
+  Barrier bar(_threads);
+
+  _frontier.assign(1, root);
+  _next.assign(_threads, std::vector<void*>());
+  _cursor = 0;
+  visit_base(root, 0);
+
+  run([&](int tid){
+    for(int level=0; ; level++){
+      tree_step(a, tid, level);
+      bar.wait();
+      if( tid == 0 ){
+        _levels = level + 1;
+        _frontier.clear();
+        for(auto& n : _next){
+          _frontier.insert(_frontier.end(), n.begin(), n.end());
+          n.clear();
+        }
+        reached += _frontier.size();
+        done     = _frontier.empty();
+        _cursor  = 0;
+      }
+      bar.wait();
+      if( done ) break;
+    }
+  });
+  return reached;
+}
+
+/*!
+visit the nodes reachable from src by BFS; returns the number of visited
+nodes.  When all[0..n-1] (all nodes which can be reached) is given, it
+switches to bottom-up steps as described above; mode forces one
+direction.
+*/
+int Parallel::bfs(Graph* g, Graph::Node* src, Graph::Node** all, int n, int mode){
+  _levels = 0;
+  if( g==NULL || src==NULL ) return 0;
+  if( all==NULL || n <= 0 ) mode = top_down;
+
+  long    unexplored = 0;       /* out-edges of unreached nodes */
+  long    reached    = 1;
+  bool    done       = false;
+  bool    up         = (mode == bottom_up);
+  Barrier bar(_threads);
+
+  if( mode & bottom_up ){
+    for(int i=0; i < n; i++) unexplored += all[i]->_out_num;
+  }
+  unexplored -= src->_out_num;
+
+  _stamp = ++g_stamp;
+  __atomic_store_n(&src->_bfs, (unsigned long long)_stamp << 32, __ATOMIC_RELAXED);
+  _frontier.assign(1, src);
+  _next.assign(_threads, std::vector<void*>());
+  _next_edges.assign(_threads, 0);
+  _cursor = 0;
+  visit_base(src, 0);
+
+  run([&](int tid){
+    for(int level=0; ; level++){
+      if( up ) bottom_up_step(g, all, n, tid, level);
+      else     top_down_step(g, tid, level);
+      bar.wait();
+      if( tid == 0 ){
+        long edges = 0;
+        _levels = level + 1;
+        _frontier.clear();
+        for(int t=0; t < _threads; t++){
+          _frontier.insert(_frontier.end(), _next[t].begin(), _next[t].end());
+          _next[t].clear();
+          edges += _next_edges[t];
+        }
+        reached    += _frontier.size();
+        unexplored -= edges;
+        done        = _frontier.empty();
+        _cursor     = 0;
+
+        if( mode == direction_optimizing ){
+          if( !up && edges > unexplored / _alpha )        up = true;
+          else if( up && (long)_frontier.size() < n / _beta ) up = false;
+        }
+      }
+      bar.wait();
+      if( done ) break;
+    }
+  });
+  return reached;
+}
+
+/*! level of n in the last Graph bfs(); -1 if not reached */
+int Parallel::level(Graph::Node* n){
+  if( n==NULL ) return -1;
+  unsigned long long m = __atomic_load_n(&n->_bfs, __ATOMIC_RELAXED);
+  if( _stamp == 0 || (unsigned)(m >> 32) != _stamp ) return -1;
+  return (int)(m & 0xffffffff);
+}
+
+/* give v, the value of a subtree, to the waiting frame f */
+void Parallel::deliver(Frame* f, long v){
+  while( f ){
+    long old = f->_acc.load(std::memory_order_relaxed);
+    while( !f->_acc.compare_exchange_weak(old, reduce_base(old, v),
+                                          std::memory_order_relaxed) );
+    if( f->_pending.fetch_sub(1, std::memory_order_acq_rel) != 1 ) return;
+
+    /* the last child; f is done */
+    Frame* up = f->_up;
+    v = post_base(f->_node, f->_acc.load(std::memory_order_relaxed));
+    delete f;
+    f = up;
+  }
+  _result = v;
+  _done.store(true, std::memory_order_release);
+}
+
+/* own newest task, or the oldest one of other thread */
+bool Parallel::get_task(int tid, Task* t){
+  for(int i=0; i < _threads; i++){
+    Worker& w = _worker[(tid + i) % _threads];
+    std::lock_guard<std::mutex> lock(w._lock);
+    if( w._tasks.empty() ) continue;
+    if( i == 0 ){
+      *t = w._tasks.back();
+      w._tasks.pop_back();
+    }else{
+      *t = w._tasks.front();
+      w._tasks.pop_front();
+    }
+    return true;
+  }
+  return false;
+}
+
+/* fold the subtree of t by one thread; split it when others are idle */
+void Parallel::fold_task(Aggregate* a, int tid, Task t){
+  struct Entry {
+    Aggregate::Parent*  _node;
+    Aggregate::Child*   _next;      /* next child to visit; NULL at end */
+    long                _acc;
+  };
+  std::vector<Entry>  stack;
+  int                 done = 0;
+  auto first = [](Aggregate::Parent* p){ return p->_tail ? p->_tail->_next : NULL; };
+
+  pre_base(t._node);
+  stack.push_back(Entry{t._node, first(t._node), 0});
+  while( !stack.empty() ){
+    Entry&            e = stack.back();
+    Aggregate::Child* c = e._next;
+    if( c == NULL ){
+      long v = post_base(e._node, e._acc);
+      stack.pop_back();
+      if( stack.empty() ){
+        deliver(t._up, v);
+        return;
+      }
+      stack.back()._acc = reduce_base(stack.back()._acc, v);
+      continue;
+    }
+    e._next = (c == e._node->_tail) ? NULL : c->_next;
+    Aggregate::Parent* q = a->as_parent(c);
+
+    if( ++done < _cutoff || _idle.load(std::memory_order_relaxed) == 0 ){
+      pre_base(q);
+      stack.push_back(Entry{q, first(q), 0});
+      continue;
+    }
+
+    /* split: each node on the stack waits in a frame for the child in
+       progress (the next frame) and its unvisited children (new tasks) */
+    std::vector<Task> spawn;
+    Frame*            up = t._up;
+    for(size_t i=0; i < stack.size(); i++){
+      Entry&  e = stack[i];
+      Frame*  f = new Frame;
+      int     pending = (i + 1 < stack.size()) ? 1 : 0;
+
+      if( i + 1 == stack.size() ){
+        spawn.push_back(Task{q, f});
+        pending++;
+      }
+      for(Aggregate::Child* r=e._next; r; pending++){
+        spawn.push_back(Task{a->as_parent(r), f});
+        r = (r == e._node->_tail) ? NULL : r->_next;
+      }
+
+      f->_node    = e._node;
+      f->_up      = up;
+      f->_acc     = e._acc;
+      f->_pending = pending;
+      up          = f;
+    }
+    Worker& w = _worker[tid];
+    std::lock_guard<std::mutex> lock(w._lock);
+    w._tasks.insert(w._tasks.end(), spawn.begin(), spawn.end());
+    return;
+  }
+}
+
+/*!
+fold the tree under root by the threads; returns the value of root.
+The aggregate must be jjAggregate(id, Node, Node).  reduce_base() must be
+associative and commutative since children are done in any order, and 0
+is the initial value of the children.  cutoff is the number of nodes a
+task does by itself before it may be split (0: default).
+*/
+long Parallel::fold(Aggregate* a, Aggregate::Parent* root, int cutoff){
+  if( a==NULL || root==NULL ) return 0;
+  if( a->as_child(root) == NULL ){
+    jj::raise(g_eh, parallel_not_tree);
+    return 0;
+  }
+
+  _worker = new Worker[_threads];
+  _idle   = 0;
+  _done   = false;
+  _result = 0;
+  _cutoff = cutoff > 0 ? cutoff : parallel_cutoff;
+  _worker[0]._tasks.push_back(Task{root, NULL});
+
+  run([&](int tid){
+    Task  t;
+    bool  idle = false;
+    while( !_done.load(std::memory_order_acquire) ){
+      if( get_task(tid, &t) ){
+        if( idle ){ _idle--; idle = false; }
+        fold_task(a, tid, t);
+      }else{
+        if( !idle ){ _idle++; idle = true; }
+        std::this_thread::yield();
+      }
+    }
+    if( idle ) _idle--;
+  });
+
+  delete[] _worker;
+  _worker = NULL;
+  return _result;
+}
+
+}; // jj
@@ -55,6 +55,9 @@ Relation between Childlen is implemented by `ring`, which is:
 * last child's next is first.
 
 Ring is a little better than linkd-list so that I chose this data structure.
+Aggregate's ring is linked both ways, so that del() and move() of a child
+are O(1) even for a parent of millions of children, and move_all() splices
+one ring into another.
 
 (The figure above omits ring and tail to show conceptual level relations only.)
 
@@ -122,6 +125,17 @@ Tree can be implemented by:
     class Node : INHERIT_Node {...};
     jjAggregate (tree, Node, Node);
 
+The whole tree under a node is walked by PreIter, PostIter (depth first)
+and LevelIter (breadth first) without recursion:
+
+    tree_class::PreIter i(&tree, &root);
+    for(Node* n; (n = ++i); ) printf("%*s%s\n", i.depth() * 2, "", n->name);
+
+PreIter and PostIter keep only the current node; they move to the first
+child, next sibling or parent through the ring and `_parent`, so that a
+million-deep chain is walked as fast as a flat one.  A node got from
+PostIter may be del()-ed before the next ++, e.g. to free a whole tree.
+
 See [02_test.cpp](../test/pattern/02_test.cpp) source as actual sample.
 */
 
@@ -140,6 +154,7 @@ Aggregate::Parent::Parent(){
 */
 Aggregate::Child::Child(){
   _next   = NULL;
+  _prev   = NULL;
   _parent = NULL;
 }
 
@@ -150,6 +165,8 @@ Aggregate::Child::Child(){
 Aggregate::Iter::Iter(){
   _curr   = NULL;
   _last   = NULL;
+  _ahead  = NULL;
+  _dist   = 0;
 }
 
 
@@ -165,12 +182,16 @@ void Aggregate::add(Parent* p, Child* c){
   c->_parent = p;
   if( p->_tail ){
     c->_next        = p->_tail->_next;
+    c->_prev        = p->_tail;
+    c->_next->_prev = c;
     p->_tail->_next = c;
   }else{
     c->_next    = c;
+    c->_prev    = c;
   }
   p->_tail = c;
   p->_num++;
+  _ver++;
 }
 
 
@@ -209,35 +230,202 @@ Aggregate::Child *Aggregate::next(Aggregate::Child* c){
    return c->_next;
 }
 
-/*! delete child from the aggregation */
+/*!
+\class  Aggregate::PreIter
+\brief  parent first walk of the tree; see Aggregate.
+*/
+void Aggregate::PreIter::start(Aggregate* a, Parent* root){
+  _a      = a;
+  _root   = root;
+  _curr   = (a && root && a->as_child(root)) ? root : NULL;   /* tree only */
+  _depth  = 0;
+  _got    = 0;
+}
+
+/*! get node, then go to its first child, next sibling or next of ancestor */
+Aggregate::Parent *Aggregate::PreIter::operator++(){
+  Parent* result = _curr;
+  if( result == NULL ) return NULL;
+  _got = _depth;
+
+  if( result->_tail ){
+    _curr = _a->as_parent(result->_tail->_next);
+    _depth++;
+    return result;
+  }
+  for(Parent* n=result; n != _root; _depth--){
+    Child*  c = _a->as_child(n);
+    Parent* p = c->_parent;
+    if( c != p->_tail ){
+      _curr = _a->as_parent(c->_next);
+      return result;
+    }
+    n = p;
+  }
+  _curr = NULL;
+  return result;
+}
+
+/*!
+\class  Aggregate::PostIter
+\brief  children first walk of the tree; see Aggregate.
+*/
+void Aggregate::PostIter::start(Aggregate* a, Parent* root){
+  _a      = a;
+  _root   = root;
+  _curr   = (a && root && a->as_child(root)) ? root : NULL;
+  _depth  = 0;
+  _got    = 0;
+  while( _curr && _curr->_tail ){         /* first leaf */
+    _curr = a->as_parent(_curr->_tail->_next);
+    _depth++;
+  }
+}
+
+/*! get node, then go to the first leaf of next sibling, or parent */
+Aggregate::Parent *Aggregate::PostIter::operator++(){
+  Parent* result = _curr;
+  if( result == NULL ) return NULL;
+  _got = _depth;
+
+  if( result == _root ){
+    _curr = NULL;
+    return result;
+  }
+  Child*  c = _a->as_child(result);
+  Parent* p = c->_parent;
+  if( c == p->_tail ){
+    _curr = p;
+    _depth--;
+    return result;
+  }
+  Parent* n = _a->as_parent(c->_next);
+  while( n->_tail ){
+    n = _a->as_parent(n->_tail->_next);
+    _depth++;
+  }
+  _curr = n;
+  return result;
+}
+
+/*!
+\class  Aggregate::LevelIter
+\brief  level by level walk of the tree; see Aggregate.
+*/
+Aggregate::LevelIter::~LevelIter(){
+  free(_q);
+}
+
+void Aggregate::LevelIter::start(Aggregate* a, Parent* root){
+  _a          = a;
+  _head       = 0;
+  _num        = 0;
+  _level_end  = 1;
+  _depth      = 0;
+  if( a==NULL || root==NULL || a->as_child(root)==NULL ) return;
+  if( _cap == 0 ){
+    _cap  = 64;
+    _q    = (Parent**)malloc(sizeof(Parent*) * _cap);
+  }
+  _q[_num++]  = root;
+}
+
+/*! get node, then queue its children */
+Aggregate::Parent *Aggregate::LevelIter::operator++(){
+  if( _head == _num ) return NULL;
+  if( _head == _level_end ){
+    _depth++;
+    _level_end = _num;
+  }
+  Parent* result = _q[_head++];
+  if( result->_tail == NULL ) return result;
+
+  Child* c = result->_tail;
+  do {
+    c = c->_next;
+    if( _num == _cap ){
+      if( _head >= _cap / 2 ){          /* reuse the front */
+        memmove(_q, _q + _head, sizeof(Parent*) * (_num - _head));
+        _num       -= _head;
+        _level_end -= _head;
+        _head       = 0;
+      }else{
+        _cap *= 2;
+        _q    = (Parent**)realloc(_q, sizeof(Parent*) * _cap);
+      }
+    }
+    _q[_num++] = _a->as_parent(c);
+  } while( c != result->_tail );
+  return result;
+}
+
+/*! delete child from the aggregation in O(1) */
 void Aggregate::del(Aggregate::Child* c){
   /* require */
   if( c==NULL ) return;
   Parent* parent = c->_parent;
+  if( parent==NULL ) return;      // not added
 
   if( c->_next == c ){            // last element?
-    c->_next= parent->_tail = NULL;     // then emptify
-    parent->_num = 0;
-    return;
-  }
-  Child *p, *next;
-  for(p=parent->_tail; p; p=next){  //find 'p' points to s
-    next = p->_next;
-    if( next == c ) break;
-    if( next == parent->_tail ) next = NULL;
+    parent->_tail = NULL;         // then emptify
+    parent->_num  = 0;
+  }else{
+    if( c->_prev->_next != c || c->_next->_prev != c ){
+      ::jj::raise(g_eh, aggregate_del_internal_error);
+      return;
+    }
+    c->_prev->_next = c->_next;
+    c->_next->_prev = c->_prev;
+    if(parent->_tail == c) parent->_tail = c->_prev;
+    parent->_num--;
   }
-  if(p){
-    p->_next = c->_next;
 
-    //set NULL for later add()
-    c->_next    = NULL;
-    c->_parent  = NULL;
+  //set NULL for later add()
+  c->_next    = NULL;
+  c->_prev    = NULL;
+  c->_parent  = NULL;
+  _ver++;
+}
 
-    if(parent->_tail == c) parent->_tail = p;
+/*! move child to the last of parent p in O(1); it may be in another
+    parent or in none.  For a tree, p must not be under c. */
+void Aggregate::move(Aggregate::Child* c, Aggregate::Parent* p){
+  /* require */
+  if( c==NULL || p==NULL ) return;
+  if( c->_parent == p && p->_tail == c ) return;
 
-    parent->_num--;
-  }else
-    ::jj::raise(g_eh, aggregate_del_internal_error);
+  del(c);
+  add(p, c);
+}
+
+/*! move all children of 'from' to the last of 'to' keeping their order.
+    The rings are spliced in O(1) and `_parent` is fixed in one pass over
+    the moved children.  Returns the number of moved children. */
+int Aggregate::move_all(Aggregate::Parent* from, Aggregate::Parent* to){
+  /* require */
+  if( from==NULL || to==NULL || from==to || from->_tail==NULL ) return 0;
+
+  Child*  c = from->_tail;
+  do{
+    c->_parent = to;
+    c = c->_next;
+  }while( c != from->_tail );
+
+  if( to->_tail ){
+    Child*  fh = from->_tail->_next,      // head of each ring
+         *  th = to->_tail->_next;
+    to->_tail->_next    = fh;
+    fh->_prev           = to->_tail;
+    from->_tail->_next  = th;
+    th->_prev           = from->_tail;
+  }
+  int n = from->_num;
+  to->_tail   = from->_tail;
+  to->_num   += n;
+  from->_tail = NULL;
+  from->_num  = 0;
+  _ver++;
+  return n;
 }
 
 /*! get number of children */
@@ -255,6 +443,23 @@ void Aggregate::Iter::start(::jj::Aggregate::Parent* p){
     iffa(p, _curr, _last->_next,          NULL);
   }else
     _curr = NULL;
+  prefetch(_dist);
+}
+
+/*!
+prefetch children 'distance' ahead of the current one in operator++() and
+fetch().  0 (default) disables it.  See Collect::Iter::prefetch().
+*/
+void Aggregate::Iter::prefetch(int distance){
+  _dist   = distance;
+  _ahead  = NULL;
+  if( distance <= 0 || _curr == NULL ) return;
+
+  _ahead  = _curr;
+  for(int i=0; i < distance && _ahead != _last; i++){
+    _ahead = _ahead->_next;
+    __builtin_prefetch(_ahead);
+  }
 }
 
 /*! get child, then increment the iterator */
@@ -264,9 +469,37 @@ Aggregate::Child *Aggregate::Iter::operator++(){
     _curr = _last = NULL;
   else
     _curr = _curr->_next;
+  if( _ahead ){
+    if( _ahead == _last || _last == NULL )
+      _ahead = NULL;              /* runner reached the last */
+    else{
+      _ahead = _ahead->_next;
+      __builtin_prefetch(_ahead);
+    }
+  }
   return result;
 }
 
+/*!
+get up to n children into buf[] at once, then increment the iterator.
+Returns the number of children got (0 at the end).
+*/
+int Aggregate::Iter::fetch(Child** buf, int n){
+  int i;
+  if( _ahead ){
+    for(i=0; i < n && _curr; i++) buf[i] = operator++();
+    return i;
+  }
+  for(i=0; i < n && _curr; i++){
+    buf[i] = _curr;
+    if( _curr == _last )
+      _curr = _last = NULL;
+    else
+      _curr = _curr->_next;
+  }
+  return i;
+}
+
 /*!
 \class  Collect
 \brief  define one-to-many relation between two classes.
@@ -337,6 +570,16 @@ See [collect_test.cpp](../test/pattern/collect_test.cpp) source as actual sample
 /*!
 \class  Collect::Iter
 \brief  Iterator class for jj::Collect pattern.
+
+del() deletes the child got last in O(1), so that expiry runs in one pass
+without a side vector:
+
+    books_class::Iter i(&shelf);
+    for(Book* b; (b = ++i); )
+      if( b->expired() ) i.del();
+
+Children add()-ed during the walk are not visited.  Other children must
+not be deleted during the walk.
 */
 
 Collect::Parent::Parent(){
@@ -347,6 +590,11 @@ Collect::Parent::Parent(){
 Collect::Iter::Iter(){
   _curr   = NULL;
   _last   = NULL;
+  _ahead  = NULL;
+  _dist   = 0;
+  _parent = NULL;
+  _got    = NULL;
+  _prev   = NULL;
 }
 
 /*! add child to parent.
@@ -438,18 +686,105 @@ void Collect::Iter::start(::jj::Collect::Parent* p){
     iffa(p, _curr, _last->_next,          NULL);
   }else
     _curr = NULL;
+  _parent = p;
+  _prev   = _last;
+  _got    = NULL;
+  prefetch(_dist);
+}
+
+/*!
+prefetch children 'distance' ahead of the current one in operator++() and
+fetch().  0 (default) disables it.
+
+A ring can only be followed one by one, so a runner walks 'distance'
+ahead of the current child and prefetches it.  The cache miss of the
+runner then overlaps with the work on the current children instead of
+stalling every operator++().
+*/
+void Collect::Iter::prefetch(int distance){
+  _dist   = distance;
+  _ahead  = NULL;
+  if( distance <= 0 || _curr == NULL ) return;
+
+  _ahead  = _curr;
+  for(int i=0; i < distance && _ahead != _last; i++){
+    _ahead = _ahead->_next;
+    __builtin_prefetch(_ahead);
+  }
 }
 
 /*! get child, then increment the iterator */
 Collect::Child *Collect::Iter::operator++(){
   Child *result = _curr;
+  if( _got && _got->_next ) _prev = _got;   /* unless deleted */
+  _got = result;
   if( _curr == _last )
     _curr = _last = NULL;
   else
     _curr = _curr->_next;
+  if( _ahead ){
+    if( _ahead == _last || _last == NULL )
+      _ahead = NULL;              /* runner reached the last */
+    else{
+      _ahead = _ahead->_next;
+      __builtin_prefetch(_ahead);
+    }
+  }
   return result;
 }
 
+/*!
+get up to n children into buf[] at once, then increment the iterator.
+Returns the number of children got (0 at the end).
+*/
+int Collect::Iter::fetch(Child** buf, int n){
+  int i;
+  if( _ahead ){
+    for(i=0; i < n && _curr; i++) buf[i] = operator++();
+    return i;
+  }
+  for(i=0; i < n && _curr; i++){
+    buf[i] = _curr;
+    if( _curr == _last )
+      _curr = _last = NULL;
+    else
+      _curr = _curr->_next;
+  }
+  if( i > 1 )
+    _prev = buf[i-2];
+  else if( i == 1 && _got && _got->_next )
+    _prev = _got;
+  if( i > 0 ) _got = buf[i-1];
+  return i;
+}
+
+/*!
+delete the child got last by operator++() (or the last one of fetch())
+from the collection in O(1), and go on walking.  Collect::del() has to
+search the ring for the one before the child; the Iter knows it.
+*/
+void Collect::Iter::del(){
+  /* require */
+  if( _parent == NULL || _got == NULL ) return;
+
+  /* check */
+  if( _got->_next == NULL ){ _got = NULL; return; }  /* del()-ed already */
+
+  Child* p = _prev;
+  while( p->_next != _got ) p = p->_next;   /* add()-ed after _prev */
+
+  if( p == _got )
+    _parent->_tail = NULL;                  /* the only one */
+  else{
+    p->_next = _got->_next;
+    if( _parent->_tail == _got ) _parent->_tail = p;
+  }
+  _got->_next = NULL;                       /* for later add() */
+  _got        = NULL;
+  _prev       = p;
+  _parent->_num--;
+}
+
 /*!
 \class  DCollect
 \brief  define one-to-many relation between two classes.
@@ -481,6 +816,10 @@ Relation between Childlen is implemented by `ring`, which is:
 * last child's next is first.
 
 Ring is a little better than linkd-list so that I chose this data structure.
+del(p, c) walks the ring of p to check that c is a child of p, and raises
+collect_del_internal_error if not.  The patterns built on DCollect which
+know the parent of a child (LHash, LRU, TimerWheel) unlink it in O(1)
+instead.
 
 ### Example
 
@@ -533,6 +872,8 @@ DCollect::Child::Child(){
 DCollect::Iter::Iter(){
   _curr = NULL;
   _last = NULL;
+  _ahead  = NULL;
+  _dist   = 0;
 }
 
 /*! add child to parent.
@@ -607,17 +948,27 @@ void DCollect::del(DCollect::Parent* parent, DCollect::Child* c){
     if( next == c ) break;
     if( next == parent->_tail ) next = NULL;
   }
-  if(ch){
-    ch               = c->_prev;
-    ch->_next        = c->_next;
-    ch->_next->_prev = ch;
-    c->_next        = c->_prev = NULL;
+  if(ch)
+    unlink(parent, c);
+  else
+    ::jj::raise(g_eh, collect_del_internal_error);
+}
+
+/*! delete child c of parent in O(1), without checking that c is of parent */
+void DCollect::unlink(DCollect::Parent* parent, DCollect::Child* c){
+  if( c->_next == c ){            // last element?
+    c->_next= c->_prev = parent->_tail = NULL;
+    parent->_num = 0;
+    return;
+  }
+  Child* ch        = c->_prev;
+  ch->_next        = c->_next;
+  ch->_next->_prev = ch;
+  c->_next        = c->_prev = NULL;
 
-    if(parent->_tail == c) parent->_tail = ch;
+  if(parent->_tail == c) parent->_tail = ch;
 
-    parent->_num--;
-  }else
-    ::jj::raise(g_eh, collect_del_internal_error);
+  parent->_num--;
 }
 
 /*! get number of children */
@@ -633,6 +984,7 @@ void DCollect::Iter::start(::jj::DCollect::Parent* p){
     iffa(p, _curr, _last->_next,          NULL);
   }else
     _curr = NULL;
+  prefetch(_dist);
 }
 
 /*!
@@ -641,6 +993,23 @@ init iterator as [c, c2]
 void DCollect::Iter::start(::jj::DCollect::Child* c, ::jj::DCollect::Child* c2){
   iffa(c,  _curr, c,  NULL);
   iffa(c2, _last, c2, NULL);
+  prefetch(_dist);
+}
+
+/*!
+prefetch children 'distance' ahead of the current one in operator++() and
+fetch().  0 (default) disables it.  See Collect::Iter::prefetch().
+*/
+void DCollect::Iter::prefetch(int distance){
+  _dist   = distance;
+  _ahead  = NULL;
+  if( distance <= 0 || _curr == NULL ) return;
+
+  _ahead  = _curr;
+  for(int i=0; i < distance && _ahead != _last; i++){
+    _ahead = _ahead->_next;
+    __builtin_prefetch(_ahead);
+  }
 }
 
 /*! get child, then increment the iterator */
@@ -650,9 +1019,37 @@ DCollect::Child *DCollect::Iter::operator++(){
     _curr = _last = NULL;
   else
     _curr = _curr->_next;
+  if( _ahead ){
+    if( _ahead == _last || _last == NULL )
+      _ahead = NULL;              /* runner reached the last */
+    else{
+      _ahead = _ahead->_next;
+      __builtin_prefetch(_ahead);
+    }
+  }
   return result;
 }
 
+/*!
+get up to n children into buf[] at once, then increment the iterator.
+Returns the number of children got (0 at the end).
+*/
+int DCollect::Iter::fetch(Child** buf, int n){
+  int i;
+  if( _ahead ){
+    for(i=0; i < n && _curr; i++) buf[i] = operator++();
+    return i;
+  }
+  for(i=0; i < n && _curr; i++){
+    buf[i] = _curr;
+    if( _curr == _last )
+      _curr = _last = NULL;
+    else
+      _curr = _curr->_next;
+  }
+  return i;
+}
+
 /*! get child, then decrement the iterator */
 DCollect::Child *DCollect::Iter::operator--(){
   Child *result = _curr;
@@ -703,6 +1100,27 @@ digraph D {
   { rank=same holder_N entry_N0 entry_N1 entry_NM }
 }
 @enddot
+
+Entries of the same key may be added (multimap).  sel() finds one of
+them; sel_all() starts an Iter on all of them and count() counts them,
+both walking only the slot of the key.  hash_base() of an entry is
+cached at add(), so that entries of other hash in the slot are skipped
+without cmp_base(), and del() and expand() don't call hash_base().  The
+key of an entry must not change while it is added.
+
+sel_mtf() is sel() which moves a hit to the front of its slot by a few
+pointer writes, so that hot keys of a skewed (e.g. Zipf) workload are
+found first even in a long chain.  Under uniform keys it only adds
+writes.  It is a write to the Holder: unlike sel(), it needs exclusive
+access, so that lookups shared under a reader lock must stay sel().  An
+Iter walking the Holder takes its slot again after it (see Hash::Iter).
+
+With filter(h, true), the Holder keeps a counting Bloom filter of the
+cached hashes, of the same size as the array and rebuilt by expand().
+sel(), sel_all() and count() of an absent key mostly end by the filter
+reading one cache line, without walking the chain; maybe() asks the
+filter alone.  It pays when most
+lookups miss (e.g. dedup); when they hit, it is an extra cache miss.
 */
 
 /*!
@@ -718,6 +1136,22 @@ digraph D {
 /*!
 \class  Hash::Iter
 \brief  Iterator class for jj::Hash pattern.
+
+del() deletes the entry got last in O(1) and the walk goes on.  add()
+during the walk may expand() the array: the Iter walks the slots of the
+array size at its 1st slot, and the slots a slot of it grew into in
+reverse binary order (as Redis SCAN does), so no entry that was there at
+start() is missed.  Holder::_gen tells the Iter that the array (or the
+order of a slot, by move to the front) changed under it; it takes the
+slot it was in again then, so the entries of that slot got before come
+once more.  Otherwise each comes once.  Entries add()-ed during the walk
+may or may not be visited, and other entries must not be deleted.
+
+The Iter writes nothing to the Holder: it may be copied, kept, or left in
+the middle of a walk.
+
+Hash::iterator (begin(), end(), range()) is the plain walk: an add() that
+expand()s the array invalidates it.
 */
 static const int
   hash_init_size      = 16,   /* initial hash array size */
@@ -726,6 +1160,10 @@ static const int
 void Hash::Holder::init(int size){
   _size       = size;
   _num        = 0;
+  _gen        = 0;
+  _bloom      = false;
+  _fblocks    = 0;
+  _filter     = NULL;
   if( size > 0 )
     _tail   = (Hash::Entry **)calloc(sizeof(Hash::Entry *), size);
   else
@@ -738,6 +1176,7 @@ Hash::Holder::Holder(){ init(0); }
 
 Hash::Holder::~Holder(){
   free(_tail);
+  free(_filter);
 }
 
 /*
@@ -763,20 +1202,28 @@ void Hash::expand(Holder *h, int new_size){
   Iter    i;
   Entry*  e2;
 
+  new_holder._bloom = h->_bloom;
+  if( h->_bloom ) bloom_alloc(&new_holder);   /* sized by new_size */
+
   i.start(h);
   while( (e2 = (Entry *)++i) ){
 #ifdef JJDEBUG
     fprintf(stderr, "Hash::expand() new_holder._size=%d\n", new_holder._size);
 #endif
-    e2->_next = NULL;       /* necessary for add() */
-    this->add(&new_holder, e2);
+    e2->_next = NULL;       /* necessary for insert() */
+    insert(&new_holder, e2);  /* by cached hash; no hash_base() */
   }
 
 /* re-birth! */
   free(h->_tail);
+  free(h->_filter);
   h->_size    = new_holder._size;
   h->_tail    = new_holder._tail;
-  new_holder._tail = NULL;    /* to avoid free() at destructor */
+  h->_fblocks = new_holder._fblocks;
+  h->_filter  = new_holder._filter;
+  h->_gen++;                  /* for Iter on h */
+  new_holder._tail   = NULL;  /* to avoid free() at destructor */
+  new_holder._filter = NULL;
 #ifdef JJDEBUG
   fprintf(stderr, "Hash::expand() end\n");
 #endif
@@ -804,9 +1251,18 @@ void Hash::add(Holder* h, Entry* e){
   fprintf(stderr, "    hash_base(e) = %d\n", hash_base(e));
   fprintf(stderr, "    h->_size     = %d\n", h->_size);
 #endif
-  int ix = hash_base(e) % h->_size;
+  e->_hash = hash_base(e);
+  insert(h, e);
 #ifdef JJDEBUG
-fprintf(stderr, "  Hash::add(%p) ix=%d\n", h, ix);
+  fprintf(stderr, "Hash::add(%p) end\n", h);
+#endif
+}
+
+/* link entry into the slot of its cached hash */
+void Hash::insert(Holder* h, Entry* e){
+  int ix = e->_hash % h->_size;
+#ifdef JJDEBUG
+fprintf(stderr, "  Hash::insert(%p) ix=%d\n", h, ix);
 #endif
   if( h->_tail[ix] ){
     e->_next              = h->_tail[ix]->_next;
@@ -816,22 +1272,24 @@ fprintf(stderr, "  Hash::add(%p) ix=%d\n", h, ix);
   }
   h->_tail[ix] = e;
   h->_num++;
-#ifdef JJDEBUG
-  fprintf(stderr, "Hash::add(%p) end\n", h);
-#endif
+  if( h->_filter ) bloom_count(h, e->_hash, 1);
 }
 
 void Hash::del(Holder* h, Entry* e){
 /* require */
   if( h==NULL || e==NULL ) return;
 
-  int     ix = hash_base(e) % h->_size;
+/* check */
+  if( e->_next == NULL ) return;
+
+  int     ix = e->_hash % h->_size;
   Entry*  p,
        *  n;
 
   if( e->_next == e ){                // last entry?
     e->_next = h->_tail[ix] = NULL;   // then emptify
     h->_num--;
+    if( h->_filter ) bloom_count(h, e->_hash, -1);
     return;
   }
   for(p=h->_tail[ix]; p; p=n){        //find 'p' points to s
@@ -844,21 +1302,35 @@ void Hash::del(Holder* h, Entry* e){
     e->_next = NULL;
     if(h->_tail[ix] == e) h->_tail[ix] = p;
     h->_num--;
+    if( h->_filter ) bloom_count(h, e->_hash, -1);
   }else
     jj::raise(g_eh, hash_del_internal_error);
 }
 
+/*! find entry equal to key; read only */
 jj::Hash::Entry* Hash::sel(Holder* h, Entry* key){
+  return find(h, key, false);
+}
+
+/*! sel() which moves the hit to the front of its slot (a write) */
+jj::Hash::Entry* Hash::sel_mtf(Holder* h, Entry* key){
+  return find(h, key, true);
+}
+
+jj::Hash::Entry* Hash::find(Holder* h, Entry* key, bool mtf){
   if( h == NULL || key == NULL ) return NULL;
 
 /* initial? */
   if( h->_size == 0 ) return NULL;
 
-  int     ix  = hash_base(key) % h->_size;
+  int     hk  = hash_base(key);
+  if( h->_filter && !bloom_maybe(h, hk) ) return NULL;  /* surely absent */
+  int     ix  = hk % h->_size;
 #ifdef JJDEBUG
 fprintf(stderr, "== Hash::sel() 2 ix=%d\n", ix);
 #endif
   Entry*  beg = h->_tail[ix],
+       *  p   = beg,              /* the one before e */
        *  nxt,
        *  e;
 
@@ -869,18 +1341,153 @@ fprintf(stderr, "== Hash::sel() 2 ix=%d\n", ix);
       nxt = beg = NULL;           /* end of list */
     else
       nxt = e->_next;
-    if( cmp_base(e, key)==0 ){
+    if( e->_hash == hk && cmp_base(e, key)==0 ){    /* other hash: skip cmp */
+      if( mtf && p != h->_tail[ix] ){
+        /* move to the front: next to the tail */
+        Entry* t = h->_tail[ix];
+        if( e == t )
+          h->_tail[ix] = p;       /* just rotate the ring */
+        else{
+          p->_next  = e->_next;
+          e->_next  = t->_next;
+          t->_next  = e;
+        }
+        h->_gen++;                /* for Iter in the slot */
+      }
       return e;
     }
+    p = e;
   }
   return NULL;
 }
 
+/*! start iterator on all entries equal to key (multimap lookup).
+    Only the slot of the key is walked; entries of other hash are skipped
+    without cmp_base().  key itself need not be added. */
+void Hash::sel_all(Holder* h, Entry* key, Iter* i){
+  if( i == NULL ) return;
+  i->start(h);
+  if( h == NULL || key == NULL || h->_size == 0 ){
+    i->stop();
+    return;
+  }
+  i->_hash  = this;
+  i->_key   = key;
+  i->_hk    = hash_base(key);
+  if( h->_filter && !bloom_maybe(h, i->_hk) ){
+    i->stop();                      /* surely absent */
+    return;
+  }
+  i->_size  = h->_size;
+  i->take();                        /* no other slot after this */
+}
+
+/*! get number of entries equal to key */
+int Hash::count(Holder* h, Entry* key){
+  Iter  i;
+  int   n = 0;
+  sel_all(h, key, &i);
+  while( ++i ) n++;
+  return n;
+}
+
 int Hash::num(Holder* h){
   if( h==NULL ) return 0;
   return h->_num;
 }
 
+/*! keep a counting Bloom filter in the Holder so that sel() of an absent
+    key mostly ends by one cache line (off by default) */
+void Hash::filter(Holder* h, bool on){
+  if( h==NULL || h->_bloom == on ) return;
+  h->_bloom = on;
+  free(h->_filter);
+  h->_filter  = NULL;
+  h->_fblocks = 0;
+  if( !on || h->_size == 0 ) return;    /* else at the 1st expand() */
+
+  bloom_alloc(h);
+  if( h->_filter == NULL ) return;      /* retried at the next expand() */
+  for(int ix=0; ix < h->_size; ix++){
+    Entry* t = h->_tail[ix];
+    if( t == NULL ) continue;
+    Entry* e = t;
+    do{
+      e = e->_next;
+      bloom_count(h, e->_hash, 1);
+    }while( e != t );
+  }
+}
+
+bool Hash::filter(Holder* h){
+  if( h==NULL ) return false;
+  return h->_bloom;
+}
+
+/*! false if key is surely absent by the filter; true if it may be there
+    (always without the filter).  Reads only */
+bool Hash::maybe(Holder* h, Entry* key){
+  if( h==NULL || key==NULL || h->_size == 0 ) return false;
+  if( h->_filter == NULL ) return true;
+  return bloom_maybe(h, hash_base(key));
+}
+
+/*
+Bloom filter of Hash::Holder
+
+64 byte blocks of 128 counters of 4 bits; 8 bytes (16 counters) for each
+slot of the array, i.e. 8 to 16 counters for an entry.  An entry counts
+up 3 counters in one block chosen by its cached hash, so that a query
+reads one cache line.  A counter stuck at 15 is never counted down (rare
+false positive rather than false negative).
+*/
+static const int
+  bloom_block_size    = 64,   /* bytes; a cache line */
+  bloom_slot_per_block=  8;
+
+static inline unsigned long bloom_mix(int hash){
+  unsigned long x = (unsigned long)(unsigned)hash * 0x9e3779b97f4a7c15UL;
+  x ^= x >> 32;
+  x *= 0xd6e8feb86659fd93UL;
+  x ^= x >> 32;
+  return x;
+}
+
+void Hash::bloom_alloc(Holder* h){
+  h->_fblocks = (h->_size + bloom_slot_per_block - 1) / bloom_slot_per_block;
+  h->_filter  = (unsigned char *)aligned_alloc(bloom_block_size,
+                                               (size_t)h->_fblocks * bloom_block_size);
+  if( h->_filter == NULL ){             /* no memory: sel() goes without */
+    h->_fblocks = 0;
+    return;
+  }
+  memset(h->_filter, 0, (size_t)h->_fblocks * bloom_block_size);
+}
+
+void Hash::bloom_count(Holder* h, int hash, int d){
+  unsigned long   x = bloom_mix(hash);
+  unsigned char*  b = h->_filter + (((x >> 32) * h->_fblocks) >> 32) * bloom_block_size;
+  for(int k=0; k < 3; k++, x >>= 7){
+    int             i = x & 127;
+    unsigned char&  c = b[i >> 1];
+    int             s = (i & 1) * 4,
+                    v = (c >> s) & 15;
+    if( v == 15 || v + d < 0 ) continue;  /* stuck */
+    v += d;
+    c = (c & ~(15 << s)) | (v << s);
+  }
+}
+
+bool Hash::bloom_maybe(Holder* h, int hash){
+  unsigned long   x = bloom_mix(hash);
+  unsigned char*  b = h->_filter + (((x >> 32) * h->_fblocks) >> 32) * bloom_block_size;
+  for(int k=0; k < 3; k++, x >>= 7){
+    int i = x & 127;
+    if( ((b[i >> 1] >> ((i & 1) * 4)) & 15) == 0 ) return false;
+  }
+  return true;
+}
+
 #include <stdio.h>      /* just for put_stat */
 
 void Hash::put_stat(Holder* h){
@@ -944,33 +1551,364 @@ void Hash::put_stat2(Holder* h){
 void Hash::Iter::start(Holder* h){
   _h          = h;
   _ix         = 0;
+  _size       = 0;                /* at the 1st slot */
+  _k          = 0;
   _beg        = NULL;
+  _got        = NULL;
+  _hash       = NULL;
+  _key        = NULL;
 }
 
-jj::Hash::Entry* Hash::Iter::operator++(){
-  if( _beg == NULL ){
-    /* find next non-empty slot */
-    for(;;){
-      if( _ix >= _h->_size )
-        return NULL;            /* end of hash array */
-
-      _beg = _h->_tail[_ix++];
-      if(_beg){
-        _nxt = _beg->_next;
-        break;
-      }
+/* end of walk */
+void Hash::Iter::stop(){
+  _h          = NULL;
+  _beg        = NULL;
+  _got        = NULL;
+}
+
+/* take the chain of the current slot: _ix, _k (the key's by sel_all()) */
+bool Hash::Iter::take(){
+  int ix  = _key ? _hk % _h->_size : _ix + _size * _k;
+  _gen    = _h->_gen;
+  _got    = NULL;
+  _beg    = _h->_tail[ix];
+  if( _beg == NULL ) return false;
+  _nxt    = _beg->_next;
+  _prev   = _beg;
+  return true;
+}
+
+/*
+to the next slot; false at the end.  A slot _ix of _size has grown into
+the slots _ix + _size * k (k < m) of the array expand()-ed since.  k goes
+in reverse binary order (0, m/2, m/4, 3m/4, ...), so that when the array
+grows again the ones that a done k grew into are still before the next k
+*/
+bool Hash::Iter::advance(){
+  if( _key ) return false;          /* the slot of the key only */
+  if( _h->_size == _size ) return ++_ix < _size;    /* not grown */
+  int bit = (_h->_size / _size) >> 1;
+  while( bit && (_k & bit) ){
+    _k &= ~bit;
+    bit >>= 1;
+  }
+  if( bit ){
+    _k |= bit;
+    return true;
+  }
+  _k = 0;
+  return ++_ix < _size;
+}
+
+/* next entry in bucket order */
+jj::Hash::Entry* Hash::Iter::step(){
+  if( _h == NULL ) return NULL;
+  if( _beg && _gen != _h->_gen ) take();   /* array or slot changed */
+  while( _beg == NULL ){
+    if( _size == 0 ) _size = _h->_size;     /* 1st slot */
+    if( _ix >= _size ){
+      stop();
+      return NULL;                          /* end of hash array */
+    }
+    if( !take() && !advance() ){
+      stop();
+      return NULL;
     }
   }
 /* next entry */
   Entry* e = _nxt;
-  if(_nxt == _beg)
+  if( _got && _got->_next ) _prev = _got;   /* unless deleted */
+  _got = e;
+  if(_nxt == _beg){
     _nxt = _beg = NULL;             /* end of list */
-  else{
+    if( !advance() ) _ix = _size;
+  }else{
     _nxt = e->_next;
   }
   return e;
 }
 
+jj::Hash::Entry* Hash::Iter::operator++(){
+  Entry* e;
+  while( (e = step()) && _key ){
+    if( e->_hash == _hk && _hash->cmp_base(e, _key) == 0 ) break;
+  }
+  return e;
+}
+
+/*! delete the entry got last by operator++() in O(1) and go on walking */
+void Hash::Iter::del(){
+/* require */
+  if( _h == NULL || _got == NULL ) return;
+
+/* check */
+  if( _got->_next == NULL ){ _got = NULL; return; }   /* del()-ed already */
+
+  int     ix  = _got->_hash % _h->_size;
+  Entry*  p   = _gen == _h->_gen ? _prev : _h->_tail[ix];
+  while( p->_next != _got ) p = p->_next;   /* add()-ed after _prev */
+
+  if( p == _got )
+    _h->_tail[ix] = NULL;                   /* the only one */
+  else{
+    p->_next = _got->_next;
+    if( _h->_tail[ix] == _got ) _h->_tail[ix] = p;
+  }
+  if( _h->_filter ) bloom_count(_h, _got->_hash, -1);
+  _got->_next = NULL;
+  _got        = NULL;
+  _prev       = p;
+  _h->_num--;
+}
+
+/*!
+\class  Graph
+\brief  define directed graph between nodes by edges.
+
+@dot
+digraph D {
+  node_a  [label="node a"]
+  node_b  [label="node b"]
+  node_c  [label="node c"]
+
+  node_a -> node_b [label="edge 1"]
+  node_a -> node_c [label="edge 2"]
+  node_b -> node_c [label="edge 3"]
+}
+@enddot
+
+### Data structure
+
+Both node and edge are participants; nothing is allocated.  Each node has
+two rings of edges:
+
+* out-edge ring, which links edges from the node.
+* in-edge ring, which links edges to the node.
+
+An edge is linked in both (out-ring of its 'from' and in-ring of its 'to')
+by doubly-linked ring so that del() of an edge is O(1), while Collect and
+Aggregate need to find the previous one.
+
+### Example
+
+    #include <jj/pattern.h>
+    #include "ex.b"
+
+    class Task : INHERIT_Task {...};
+    class Dep  : INHERIT_Dep  {...};
+
+    jjGraph (deps, Task, Dep);
+
+    deps.add(&compile, &link, &dep);      // compile -> link
+    for(Dep* d : deps.outs(&compile)) ... deps.to(d) ...
+
+See [graph_test.cpp](../test/pattern/graph_test.cpp) source as actual sample.
+*/
+
+/*!
+\class  Graph::Node
+\brief  Node base class for jj::Graph pattern.
+*/
+Graph::Node::Node(){
+  _out      = NULL;
+  _in       = NULL;
+  _out_num  = 0;
+  _in_num   = 0;
+  _ix       = -1;
+  _bfs      = 0;
+}
+
+/*!
+\class  Graph::Edge
+\brief  Edge base class for jj::Graph pattern.
+*/
+Graph::Edge::Edge(){
+  _from     = NULL;
+  _to       = NULL;
+  _out_next = _out_prev = NULL;
+  _in_next  = _in_prev  = NULL;
+}
+
+/*!
+\class  Graph::OutIter
+\brief  Iterator class over out-edges of a node for jj::Graph pattern.
+*/
+Graph::OutIter::OutIter(){
+  _curr   = NULL;
+  _last   = NULL;
+}
+
+/*!
+\class  Graph::InIter
+\brief  Iterator class over in-edges of a node for jj::Graph pattern.
+*/
+Graph::InIter::InIter(){
+  _curr   = NULL;
+  _last   = NULL;
+}
+
+/*! add edge from 'from' to 'to'. */
+void Graph::add(Node* from, Node* to, Edge* e){
+  /* require */
+  if( from==NULL || to==NULL || e==NULL ) return;
+
+  /* check */
+  if( e->_from != NULL || e->_to != NULL ) return;
+
+  e->_from = from;
+  e->_to   = to;
+
+  if( from->_out ){
+    e->_out_next                = from->_out->_out_next;
+    e->_out_prev                = from->_out;
+    from->_out->_out_next->_out_prev = e;
+    from->_out->_out_next       = e;
+  }else{
+    e->_out_next = e->_out_prev = e;
+  }
+  from->_out = e;
+  from->_out_num++;
+
+  if( to->_in ){
+    e->_in_next                 = to->_in->_in_next;
+    e->_in_prev                 = to->_in;
+    to->_in->_in_next->_in_prev = e;
+    to->_in->_in_next           = e;
+  }else{
+    e->_in_next = e->_in_prev = e;
+  }
+  to->_in = e;
+  to->_in_num++;
+}
+
+/*! delete edge from the graph in O(1) */
+void Graph::del(Edge* e){
+  /* require */
+  if( e==NULL ) return;
+  Node* from  = e->_from,
+      * to    = e->_to;
+  if( from==NULL || to==NULL ){
+    ::jj::raise(g_eh, graph_del_internal_error);
+    return;
+  }
+
+  if( e->_out_next == e ){
+    from->_out = NULL;
+  }else{
+    e->_out_prev->_out_next = e->_out_next;
+    e->_out_next->_out_prev = e->_out_prev;
+    if( from->_out == e ) from->_out = e->_out_prev;
+  }
+  from->_out_num--;
+
+  if( e->_in_next == e ){
+    to->_in = NULL;
+  }else{
+    e->_in_prev->_in_next = e->_in_next;
+    e->_in_next->_in_prev = e->_in_prev;
+    if( to->_in == e ) to->_in = e->_in_prev;
+  }
+  to->_in_num--;
+
+  //set NULL for later add()
+  e->_from      = e->_to      = NULL;
+  e->_out_next  = e->_out_prev = NULL;
+  e->_in_next   = e->_in_prev  = NULL;
+}
+
+/*! delete all edges from/to the node */
+void Graph::isolate(Node* n){
+  if( n==NULL ) return;
+  while( n->_out ) del(n->_out);
+  while( n->_in  ) del(n->_in);
+}
+
+/*! get node the edge is from */
+Graph::Node *Graph::from(Edge* e){
+  if( e==NULL ) return NULL;
+  return e->_from;
+}
+
+/*! get node the edge is to */
+Graph::Node *Graph::to(Edge* e){
+  if( e==NULL ) return NULL;
+  return e->_to;
+}
+
+/*! get 1st out-edge of the node */
+Graph::Edge *Graph::out(Node* n){
+  if( n==NULL || n->_out==NULL ) return NULL;
+  return n->_out->_out_next;
+}
+
+/*! get 1st in-edge of the node */
+Graph::Edge *Graph::in(Node* n){
+  if( n==NULL || n->_in==NULL ) return NULL;
+  return n->_in->_in_next;
+}
+
+/*! get out-edge next to the edge in the ring */
+Graph::Edge *Graph::next_out(Edge* e){
+  if( e==NULL ) return NULL;
+  return e->_out_next;
+}
+
+/*! get in-edge next to the edge in the ring */
+Graph::Edge *Graph::next_in(Edge* e){
+  if( e==NULL ) return NULL;
+  return e->_in_next;
+}
+
+/*! get number of out-edges */
+int Graph::num_out(Node* n){
+  if( n==NULL ) return 0;
+  return n->_out_num;
+}
+
+/*! get number of in-edges */
+int Graph::num_in(Node* n){
+  if( n==NULL ) return 0;
+  return n->_in_num;
+}
+
+/*! declare iterator */
+void Graph::OutIter::start(Node* n){
+  iffa(n, _last, n->_out, NULL);
+  if( _last ){
+    _curr = _last->_out_next;
+  }else
+    _curr = NULL;
+}
+
+/*! get edge, then increment the iterator */
+Graph::Edge *Graph::OutIter::operator++(){
+  Edge *result = _curr;
+  if( _curr == _last )
+    _curr = _last = NULL;
+  else
+    _curr = _curr->_out_next;
+  return result;
+}
+
+/*! declare iterator */
+void Graph::InIter::start(Node* n){
+  iffa(n, _last, n->_in, NULL);
+  if( _last ){
+    _curr = _last->_in_next;
+  }else
+    _curr = NULL;
+}
+
+/*! get edge, then increment the iterator */
+Graph::Edge *Graph::InIter::operator++(){
+  Edge *result = _curr;
+  if( _curr == _last )
+    _curr = _last = NULL;
+  else
+    _curr = _curr->_in_next;
+  return result;
+}
+
 /* convenient hash functions */
 int hash_str(const char *s){
   int hash = 0;
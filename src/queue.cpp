@@ -0,0 +1,135 @@
+/*!
+\file   queue.cpp
+\brief  Lock-free multi-producer single-consumer Queue pattern
+*/
+
+#include "jj/queue.h"
+
+
+namespace jj {
+
+/*!
+\class  Queue
+\brief  define one-to-many relation in FIFO order between threads.
+
+Many producer threads add() children at the same time without lock, and
+one consumer thread get()s them in the order they were added.  No memory
+is allocated; the child itself is the queue node.
+
+@dot
+digraph D {
+  parent
+  stub    [label="stub"]
+  child_1 [label="child 1"]
+  child_2 [label="child 2"]
+  child_N [label="child N"]
+
+  { rank=same
+    stub -> child_1 -> child_2 -> child_N
+    rankdir = LR
+  }
+
+  parent  -> stub     [ label="tail" ]
+  parent  -> child_N  [ label="head" ]
+}
+@enddot
+
+### Data structure
+
+Like Collect, the parent knows the last child (head here) and a child knows
+its next.  Collect links a new child by two stores (`tail->_next` and
+`_tail`), which can't be shared by producers, so Queue does it in the
+other order:
+
+1. exchange `head` to the new child atomically, which serializes producers.
+2. then link the previous head to the new child.
+
+Between 1 and 2 the list is broken for a moment; get() returns NULL then,
+as if the child were not yet added.  The list is not a ring but starts at
+`stub` in the parent so that the last child can be got without touching
+`head`.
+
+A child must not be add()-ed again before it has been got.
+
+### Example
+
+    #include <jj/queue.h>
+    #include "ex.b"
+
+    class Worker : INHERIT_Worker {...};
+    class Job    : INHERIT_Job    {...};
+
+    jjQueue (jobs, Worker, Job);
+
+    // any thread
+    jobs.add(&worker, job);
+
+    // worker thread only
+    while( (job = jobs.get(&worker)) ){ ... }
+
+See [queue_test.cpp](../test/pattern/queue_test.cpp) source as actual sample.
+*/
+
+/*!
+\class  Queue::Parent
+\brief  Parent base class for jj::Queue pattern.
+*/
+Queue::Parent::Parent(){
+  _head = &_stub;
+  _tail = &_stub;
+}
+
+/*!
+\class  Queue::Child
+\brief  Child base class for jj::Queue pattern.
+*/
+
+/*! add child to parent; any thread can call it. */
+void Queue::add(Parent* p, Child* c){
+  /* require */
+  if( p==NULL || c==NULL ) return;
+
+  c->_next.store(NULL, std::memory_order_relaxed);
+  Child* prev = p->_head.exchange(c, std::memory_order_acq_rel);
+  prev->_next.store(c, std::memory_order_release);
+}
+
+/*! get 1st child and remove it from parent; only one thread can call it. */
+Queue::Child *Queue::get(Parent* p){
+  if( p==NULL ) return NULL;
+
+  Child*  tail = p->_tail;
+  Child*  next = tail->_next.load(std::memory_order_acquire);
+
+  if( tail == &p->_stub ){          // skip stub
+    if( next == NULL ) return NULL; // empty
+    p->_tail  = next;
+    tail      = next;
+    next      = next->_next.load(std::memory_order_acquire);
+  }
+  if( next ){
+    p->_tail  = next;
+    return tail;
+  }
+
+  /* 'tail' is the last one, or a producer is between exchange and link */
+  if( tail != p->_head.load(std::memory_order_acquire) ) return NULL;
+
+  add(p, &p->_stub);                // re-put stub behind the last one
+  next = tail->_next.load(std::memory_order_acquire);
+  if( next ){
+    p->_tail  = next;
+    return tail;
+  }
+  return NULL;
+}
+
+/*! check if there is no child; only the consumer thread gets exact result. */
+bool Queue::empty(Parent* p){
+  if( p==NULL ) return true;
+  Child* tail = p->_tail;
+  return tail == &p->_stub
+      && tail->_next.load(std::memory_order_acquire) == NULL;
+}
+
+}; // jj
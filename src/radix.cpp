@@ -0,0 +1,457 @@
+/*!
+\file   radix.cpp
+\brief  Ordered holder-entry relation by string key in adaptive radix tree
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "jj/errno.h"
+#include "jj/radix.h"
+
+
+namespace jj {
+
+static Errno      g_eh;
+
+enum Error {
+  radix_del_internal_error  = 1
+};
+
+/*!
+\class  Radix
+\brief  define holder-entry relation searched by string key and prefix.
+
+Radix is a holder-entry relation like jj::Hash keyed by a NUL-terminated
+string which key_base() returns from the entry itself, but the entries
+are kept in key (strcmp) order so that:
+
+* sel() finds the entry of the key.
+* scan() (or range(h, prefix)) iterates only the entries whose key starts
+  with a prefix, without looking at the others.
+* Iter, first() and next() walk all entries in key order.
+
+Keys must be unique while added; add() ignores an entry of the same key
+as an added one (check by sel() before).  A key must not be changed while
+the entry is added.
+
+### Data structure
+
+Adaptive radix tree (ART).  The entries are the leaves; inner nodes
+branch by one key byte at their depth and are sized by the number of
+children (4, 16, 48 or 256), growing and shrinking with add() and del().
+The trailing NUL is a key byte too, so no key ends at an inner node.
+
+Paths are compressed: an inner node of one child is never made, and the
+key bytes between a node and its parent are not stored (nor copied); they
+are checked against the key of a leaf below when needed.  Only the inner
+nodes are allocated, at most one per entry.
+
+Entries and inner nodes know their parent and the byte under it, so that
+next() needs no stack and an entry can be del()-ed once Iter has passed
+it.  A prefix scan() ends at its subtree node, which del() may free;
+don't del() while scanning a prefix.
+
+### Example
+
+    #include <jj/radix.h>
+    #include "ex.b"
+
+    class App  : INHERIT_App  {...};
+    class Atom : INHERIT_Atom {...};
+
+    jjRadix (atoms, App, Atom);
+
+    const char* atoms_class::key_base(Entry *e){ return ((Atom*)e)->str(); }
+
+    for(Atom* a : atoms.range(&app, "atom-01")) ...
+
+See [radix_test.cpp](../test/pattern/radix_test.cpp) source as actual sample.
+*/
+
+/*!
+\class  Radix::Entry
+\brief  Entry base class for jj::Radix pattern.
+*/
+
+/*!
+\class  Radix::Iter
+\brief  Iterator class for jj::Radix pattern.
+*/
+
+/*----------------------------------------------------------------------
+inner node
+----------------------------------------------------------------------*/
+enum Kind { n4, n16, n48, n256 };
+
+static const int kind_max[] = { 4, 16, 48, 256 };
+
+static inline bool            is_leaf (void* c){ return ((uintptr_t)c & 1) != 0; }
+static inline Radix::Entry*   as_leaf (void* c){ return (Radix::Entry*)((uintptr_t)c & ~(uintptr_t)1); }
+static inline void*           leaf    (Radix::Entry* e){ return (void*)((uintptr_t)e | 1); }
+
+class Radix::Inner {
+public:
+  unsigned char   kind;
+  unsigned char   byte;       /* key byte under parent */
+  short           num;
+  int             depth;      /* index of the key byte to branch */
+  Inner*          parent;
+
+  static Inner*   make        (int kind, int depth);
+  void**          find        (int b);
+  void*           child_after (int b, int* got);
+  void            put         (int b, void* c);
+  void            remove      (int b);
+
+  static void     set_parent  (void* c, Inner* p, int b);
+  static Entry*   min_leaf    (void* c);
+  static void     free_all    (void* c);
+};
+
+struct N4   : Radix::Inner { unsigned char key[4];    void* child[4];   };
+struct N16  : Radix::Inner { unsigned char key[16];   void* child[16];  };
+struct N48  : Radix::Inner { unsigned char index[256]; void* child[48]; };  /* index: slot+1 */
+struct N256 : Radix::Inner { void* child[256]; };
+
+Radix::Inner* Radix::Inner::make(int kind, int depth){
+  static const size_t size[] = { sizeof(N4), sizeof(N16), sizeof(N48), sizeof(N256) };
+  Inner* n  = (Inner*)calloc(1, size[kind]);
+  n->kind   = kind;
+  n->depth  = depth;
+  return n;
+}
+
+/* slot of child of byte b; NULL if none */
+void** Radix::Inner::find(int b){
+  switch( kind ){
+  case n4: {
+    N4* n = (N4*)this;
+    for(int i=0; i < num; i++) if( n->key[i] == b ) return &n->child[i];
+    return NULL; }
+  case n16: {
+    N16* n = (N16*)this;
+    for(int i=0; i < num; i++) if( n->key[i] == b ) return &n->child[i];
+    return NULL; }
+  case n48: {
+    N48* n = (N48*)this;
+    return n->index[b] ? &n->child[n->index[b] - 1] : NULL; }
+  default: {
+    N256* n = (N256*)this;
+    return n->child[b] ? &n->child[b] : NULL; }
+  }
+}
+
+/* first child of byte > b (b=-1: the first); NULL if none */
+void* Radix::Inner::child_after(int b, int* got){
+  switch( kind ){
+  case n4: {
+    N4* n = (N4*)this;
+    for(int i=0; i < num; i++) if( n->key[i] > b ){ *got = n->key[i]; return n->child[i]; }
+    return NULL; }
+  case n16: {
+    N16* n = (N16*)this;
+    for(int i=0; i < num; i++) if( n->key[i] > b ){ *got = n->key[i]; return n->child[i]; }
+    return NULL; }
+  case n48: {
+    N48* n = (N48*)this;
+    for(int k=b+1; k < 256; k++) if( n->index[k] ){ *got = k; return n->child[n->index[k] - 1]; }
+    return NULL; }
+  default: {
+    N256* n = (N256*)this;
+    for(int k=b+1; k < 256; k++) if( n->child[k] ){ *got = k; return n->child[k]; }
+    return NULL; }
+  }
+}
+
+/* add child c of byte b; the node must have room */
+void Radix::Inner::put(int b, void* c){
+  switch( kind ){
+  case n4:
+  case n16: {
+    unsigned char*  key   = kind == n4 ? ((N4*)this)->key   : ((N16*)this)->key;
+    void**          child = kind == n4 ? ((N4*)this)->child : ((N16*)this)->child;
+    int i = num;
+    for(; i > 0 && key[i-1] > b; i--){ key[i] = key[i-1]; child[i] = child[i-1]; }
+    key[i]    = b;
+    child[i]  = c;
+    break; }
+  case n48: {
+    N48* n = (N48*)this;
+    int i = 0;
+    while( n->child[i] ) i++;
+    n->child[i]   = c;
+    n->index[b]   = i + 1;
+    break; }
+  default:
+    ((N256*)this)->child[b] = c;
+  }
+  num++;
+  set_parent(c, this, b);
+}
+
+void Radix::Inner::remove(int b){
+  switch( kind ){
+  case n4:
+  case n16: {
+    unsigned char*  key   = kind == n4 ? ((N4*)this)->key   : ((N16*)this)->key;
+    void**          child = kind == n4 ? ((N4*)this)->child : ((N16*)this)->child;
+    int i = 0;
+    while( key[i] != b ) i++;
+    for(; i < num - 1; i++){ key[i] = key[i+1]; child[i] = child[i+1]; }
+    break; }
+  case n48: {
+    N48* n = (N48*)this;
+    n->child[n->index[b] - 1] = NULL;
+    n->index[b] = 0;
+    break; }
+  default:
+    ((N256*)this)->child[b] = NULL;
+  }
+  num--;
+}
+
+void Radix::Inner::set_parent(void* c, Inner* p, int b){
+  if( is_leaf(c) ){
+    as_leaf(c)->_parent = p;
+    as_leaf(c)->_byte   = b;
+  }else{
+    ((Inner*)c)->parent = p;
+    ((Inner*)c)->byte   = b;
+  }
+}
+
+Radix::Entry* Radix::Inner::min_leaf(void* c){
+  int b;
+  while( c && !is_leaf(c) ) c = ((Inner*)c)->child_after(-1, &b);
+  return c ? as_leaf(c) : NULL;
+}
+
+/* free inner nodes under c and detach the entries */
+void Radix::Inner::free_all(void* c){
+  if( c == NULL ) return;
+  if( is_leaf(c) ){
+    as_leaf(c)->_parent = NULL;
+    as_leaf(c)->_byte   = -1;
+    return;
+  }
+  Inner*  n = (Inner*)c;
+  int     b = -1;
+  for(void* d; (d = n->child_after(b, &b)); ) free_all(d);
+  free(n);
+}
+
+/* slot pointing to n */
+static void** slot_of(void** root, Radix::Inner* n){
+  return n->parent ? n->parent->find(n->byte) : root;
+}
+
+/* replace n by a node of kind (grow or shrink) */
+static Radix::Inner* resize(void** root, Radix::Inner* n, int kind){
+  Radix::Inner* m = Radix::Inner::make(kind, n->depth);
+  m->parent = n->parent;
+  m->byte   = n->byte;
+  *slot_of(root, n) = m;
+  int b = -1;
+  for(void* c; (c = n->child_after(b, &b)); ) m->put(b, c);
+  free(n);
+  return m;
+}
+
+/*----------------------------------------------------------------------
+holder
+----------------------------------------------------------------------*/
+/*!
+\class  Radix::Holder
+\brief  Holder base class for jj::Radix pattern.
+*/
+Radix::Holder::Holder(){
+  _root = NULL;
+  _num  = 0;
+}
+
+/*! free inner nodes; entries still added are detached */
+Radix::Holder::~Holder(){
+  Inner::free_all(_root);
+}
+
+/* put a new inner node at depth 'at' into slot holding c, with children c
+   (whose key is ck) and entry e */
+void Radix::split(void** slot, Inner* parent, int byte, void* c,
+                  const unsigned char* ck, Entry* e, int at){
+  Inner* n  = Inner::make(n4, at);
+  n->parent = parent;
+  n->byte   = byte;
+  n->put(ck[at], c);
+  n->put(key(e)[at], leaf(e));
+  *slot = n;
+}
+
+/*! add entry to holder; ignored if the key is already added */
+void Radix::add(Holder* h, Entry* e){
+/* require */
+  if( h==NULL || e==NULL ) return;
+
+/* check */
+  if( e->_byte >= 0 ) return;
+
+  const unsigned char*  k       = key(e);
+  void**                slot    = &h->_root;
+  Inner*                parent  = NULL;
+  int                   from    = 0;      /* key bytes before are matched */
+
+  for(;;){
+    void* c = *slot;
+    if( c == NULL ){
+      *slot = leaf(e);
+      Inner::set_parent(leaf(e), parent, parent ? k[parent->depth] : 0);
+      break;
+    }
+    int pb = parent ? k[parent->depth] : 0;
+    if( is_leaf(c) ){
+      /* from the byte under parent, which may be the NUL of both */
+      const unsigned char* ck = key(as_leaf(c));
+      int i = parent ? parent->depth : 0;
+      for(; ck[i] == k[i]; i++) if( k[i] == 0 ) return;   /* same key */
+      split(slot, parent, pb, c, ck, e, i);
+      break;
+    }
+    Inner* n = (Inner*)c;
+    if( n->depth > from ){
+      const unsigned char* ck = key(Inner::min_leaf(n));
+      int i = from;
+      while( i < n->depth && ck[i] == k[i] ) i++;
+      if( i < n->depth ){
+        split(slot, parent, pb, c, ck, e, i);
+        break;
+      }
+    }
+    void** s = n->find(k[n->depth]);
+    if( s == NULL ){
+      if( n->num == kind_max[n->kind] ) n = resize(&h->_root, n, n->kind + 1);
+      n->put(k[n->depth], leaf(e));
+      break;
+    }
+    parent  = n;
+    from    = n->depth + 1;
+    slot    = s;
+  }
+  h->_num++;
+}
+
+/*! delete entry from holder */
+void Radix::del(Holder* h, Entry* e){
+/* require */
+  if( h==NULL || e==NULL ) return;
+
+/* check */
+  if( e->_byte < 0 ) return;
+
+  Inner* n = e->_parent;
+  if( n == NULL ){
+    if( h->_root != leaf(e) ){
+      ::jj::raise(g_eh, radix_del_internal_error);
+      return;
+    }
+    h->_root = NULL;
+  }else{
+    void** s = n->find(e->_byte);
+    if( s == NULL || *s != leaf(e) ){
+      ::jj::raise(g_eh, radix_del_internal_error);
+      return;
+    }
+    n->remove(e->_byte);
+    if( n->num == 1 ){                    /* path compression */
+      int   b;
+      void* c = n->child_after(-1, &b);
+      *slot_of(&h->_root, n) = c;
+      Inner::set_parent(c, n->parent, n->byte);
+      free(n);
+    }else if( n->kind > n4 && n->num <= kind_max[n->kind - 1] * 3 / 4 ){
+      resize(&h->_root, n, n->kind - 1);
+    }
+  }
+  e->_parent  = NULL;
+  e->_byte    = -1;
+  h->_num--;
+}
+
+/*! find the entry of the key; NULL if not found */
+Radix::Entry *Radix::sel(Holder* h, const char* key_){
+  if( h==NULL || key_==NULL ) return NULL;
+  const unsigned char*  k   = (const unsigned char*)key_;
+  int                   len = strlen(key_);
+  void*                 c   = h->_root;
+
+  while( c && !is_leaf(c) ){
+    Inner* n = (Inner*)c;
+    if( n->depth > len ) return NULL;
+    void** s = n->find(k[n->depth]);
+    c = s ? *s : NULL;
+  }
+  if( c == NULL ) return NULL;
+  Entry* e = as_leaf(c);
+  return strcmp((const char*)key(e), key_) == 0 ? e : NULL;
+}
+
+/*! get the entry of the smallest key */
+Radix::Entry *Radix::first(Holder* h){
+  return h ? Inner::min_leaf(h->_root) : NULL;
+}
+
+/* next entry in key order under top (NULL: whole tree) */
+Radix::Entry *Radix::next_in(Entry* e, void* top){
+  if( e==NULL || e->_byte < 0 || top == leaf(e) ) return NULL;
+  Inner*  n = e->_parent;
+  int     b = e->_byte;
+  while( n ){
+    void* c = n->child_after(b, &b);
+    if( c ) return Inner::min_leaf(c);
+    if( n == top ) break;
+    b = n->byte;
+    n = n->parent;
+  }
+  return NULL;
+}
+
+/*! get the entry next to e in key order; NULL at the last */
+Radix::Entry *Radix::next(Entry* e){
+  return next_in(e, NULL);
+}
+
+/*! get number of entries */
+int Radix::num(Holder* h){
+  if( h==NULL ) return 0;
+  return h->_num;
+}
+
+/*! start i for the entries whose key starts with prefix, in key order */
+void Radix::scan(Holder* h, const char* prefix, Iter* i){
+  if( i==NULL ) return;
+  i->_curr  = NULL;
+  i->_top   = NULL;
+  if( h==NULL || prefix==NULL ) return;
+
+  const unsigned char*  p   = (const unsigned char*)prefix;
+  int                   len = strlen(prefix);
+  void*                 c   = h->_root;
+
+  while( c && !is_leaf(c) && ((Inner*)c)->depth < len ){
+    void** s = ((Inner*)c)->find(p[((Inner*)c)->depth]);
+    c = s ? *s : NULL;
+  }
+  if( c == NULL ) return;
+  Entry* e = Inner::min_leaf(c);
+  if( strncmp((const char*)key(e), prefix, len) != 0 ) return;
+  i->_curr  = e;
+  i->_top   = c;
+}
+
+/*! get entry and go to the next */
+Radix::Entry *Radix::Iter::operator++(){
+  Entry* e = _curr;
+  _curr = next_in(e, _top);
+  return e;
+}
+
+}; // jj
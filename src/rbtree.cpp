@@ -0,0 +1,397 @@
+/*!
+\file   rbtree.cpp
+\brief  Ordered holder-entry relation by intrusive red-black tree
+*/
+
+#include <stdlib.h>
+#include "jj/errno.h"
+#include "jj/rbtree.h"
+
+
+namespace jj {
+
+static Errno      g_eh;
+
+enum Error {
+  rbtree_del_internal_error = 1
+};
+
+enum Color {
+  none  = -1,   /* not added */
+  black = 0,
+  red   = 1
+};
+
+/*!
+\class  RBTree
+\brief  define holder-entry relation kept in key order.
+
+RBTree is the same holder-entry relation as jj::Hash, but the entries are
+kept sorted by cmp_base(), so that in addition to sel() (find) it answers:
+
+* first(), last(), next(), prev() - in-order walk
+* lower_bound() - first entry of key >= the given one
+* upper_bound() - first entry of key >  the given one
+* range(h, lo, hi) - entries of lo <= key <= hi for range-for
+
+add(), del(), sel() and the bounds are O(log n).  Entries of the same key
+are allowed; add() puts a new one after the existing ones.
+
+### Data structure
+
+Red-black tree.  Entry has left, right and parent links and a color; no
+memory is allocated by the pattern.  next() and prev() follow the parent
+links, so iterators need no stack and an entry can be del()-ed once the
+iterator has passed it.
+
+### Example
+
+    #include <jj/rbtree.h>
+    #include "ex.b"
+
+    class Calendar : INHERIT_Calendar {...};
+    class Event    : INHERIT_Event    {...};
+
+    jjRBTree (events, Calendar, Event);
+
+    int events_class::cmp_base(Entry *e1, Entry *e2){
+      return ((Event*)e1)->time - ((Event*)e2)->time;
+    }
+
+    Event from(t0), to(t1);
+    for(Event* e : events.range(&cal, &from, &to)) ...
+
+See [rbtree_test.cpp](../test/pattern/rbtree_test.cpp) source as actual sample.
+*/
+
+/*!
+\class  RBTree::Holder
+\brief  Holder base class for jj::RBTree pattern.
+*/
+RBTree::Holder::Holder(){
+  _root = NULL;
+  _num  = 0;
+}
+
+/*!
+\class  RBTree::Entry
+\brief  Entry base class for jj::RBTree pattern.
+*/
+
+/*!
+\class  RBTree::Iter
+\brief  Iterator class for jj::RBTree pattern.
+*/
+
+#define RED(e)  ((e) && (e)->_color == red)
+
+void RBTree::rotate_left(Holder* h, Entry* x){
+  Entry* y = x->_right;
+  x->_right = y->_left;
+  if( y->_left ) y->_left->_parent = x;
+  y->_parent = x->_parent;
+  if( x->_parent == NULL )              h->_root = y;
+  else if( x == x->_parent->_left )     x->_parent->_left  = y;
+  else                                  x->_parent->_right = y;
+  y->_left   = x;
+  x->_parent = y;
+}
+
+void RBTree::rotate_right(Holder* h, Entry* x){
+  Entry* y = x->_left;
+  x->_left = y->_right;
+  if( y->_right ) y->_right->_parent = x;
+  y->_parent = x->_parent;
+  if( x->_parent == NULL )              h->_root = y;
+  else if( x == x->_parent->_right )    x->_parent->_right = y;
+  else                                  x->_parent->_left  = y;
+  y->_right  = x;
+  x->_parent = y;
+}
+
+/* put v at the place of u */
+void RBTree::transplant(Holder* h, Entry* u, Entry* v){
+  if( u->_parent == NULL )              h->_root = v;
+  else if( u == u->_parent->_left )     u->_parent->_left  = v;
+  else                                  u->_parent->_right = v;
+  if( v ) v->_parent = u->_parent;
+}
+
+/*! add entry to holder in key order */
+void RBTree::add(Holder* h, Entry* e){
+/* require */
+  if( h==NULL || e==NULL ) return;
+
+/* check */
+  if( e->_color != none ) return;
+
+  Entry*  p = NULL;
+  Entry*  c = h->_root;
+  bool    left = false;
+  while( c ){
+    p     = c;
+    left  = cmp_base(e, c) < 0;
+    c     = left ? c->_left : c->_right;
+  }
+  e->_parent  = p;
+  e->_left    = e->_right = NULL;
+  e->_color   = red;
+  if( p == NULL )   h->_root    = e;
+  else if( left )   p->_left    = e;
+  else              p->_right   = e;
+  h->_num++;
+  add_fixup(h, e);
+}
+
+void RBTree::add_fixup(Holder* h, Entry* e){
+  Entry* p;
+  while( (p = e->_parent) && p->_color == red ){
+    Entry* g = p->_parent;              /* exists since root is black */
+    if( p == g->_left ){
+      Entry* u = g->_right;
+      if( RED(u) ){
+        p->_color = u->_color = black;
+        g->_color = red;
+        e = g;
+      }else{
+        if( e == p->_right ){ e = p; rotate_left(h, e); p = e->_parent; }
+        p->_color = black;
+        g->_color = red;
+        rotate_right(h, g);
+      }
+    }else{
+      Entry* u = g->_left;
+      if( RED(u) ){
+        p->_color = u->_color = black;
+        g->_color = red;
+        e = g;
+      }else{
+        if( e == p->_left ){ e = p; rotate_right(h, e); p = e->_parent; }
+        p->_color = black;
+        g->_color = red;
+        rotate_left(h, g);
+      }
+    }
+  }
+  h->_root->_color = black;
+}
+
+/*! delete entry from holder */
+void RBTree::del(Holder* h, Entry* e){
+/* require */
+  if( h==NULL || e==NULL ) return;
+
+/* check */
+  if( e->_color == none ) return;
+  if( h->_num <= 0 ){
+    ::jj::raise(g_eh, rbtree_del_internal_error);
+    return;
+  }
+
+  Entry*  y       = e;
+  int     y_color = y->_color;
+  Entry*  x, *xp;               /* x (may be NULL) replaces y; xp is its parent */
+
+  if( e->_left == NULL ){
+    x   = e->_right;
+    xp  = e->_parent;
+    transplant(h, e, e->_right);
+  }else if( e->_right == NULL ){
+    x   = e->_left;
+    xp  = e->_parent;
+    transplant(h, e, e->_left);
+  }else{
+    y = e->_right;                      /* successor */
+    while( y->_left ) y = y->_left;
+    y_color = y->_color;
+    x       = y->_right;
+    if( y->_parent == e ){
+      xp = y;
+    }else{
+      xp = y->_parent;
+      transplant(h, y, y->_right);
+      y->_right           = e->_right;
+      y->_right->_parent  = y;
+    }
+    transplant(h, e, y);
+    y->_left          = e->_left;
+    y->_left->_parent = y;
+    y->_color         = e->_color;
+  }
+  if( y_color == black ) del_fixup(h, x, xp);
+
+  //set NULL for later add()
+  e->_left = e->_right = e->_parent = NULL;
+  e->_color = none;
+  h->_num--;
+}
+
+void RBTree::del_fixup(Holder* h, Entry* x, Entry* xp){
+  while( x != h->_root && !RED(x) ){
+    if( x == xp->_left ){
+      Entry* w = xp->_right;
+      if( RED(w) ){
+        w->_color   = black;
+        xp->_color  = red;
+        rotate_left(h, xp);
+        w = xp->_right;
+      }
+      if( !RED(w->_left) && !RED(w->_right) ){
+        w->_color = red;
+        x  = xp;
+        xp = x->_parent;
+      }else{
+        if( !RED(w->_right) ){
+          w->_left->_color  = black;
+          w->_color         = red;
+          rotate_right(h, w);
+          w = xp->_right;
+        }
+        w->_color         = xp->_color;
+        xp->_color        = black;
+        w->_right->_color = black;
+        rotate_left(h, xp);
+        x = h->_root;
+      }
+    }else{
+      Entry* w = xp->_left;
+      if( RED(w) ){
+        w->_color   = black;
+        xp->_color  = red;
+        rotate_right(h, xp);
+        w = xp->_left;
+      }
+      if( !RED(w->_left) && !RED(w->_right) ){
+        w->_color = red;
+        x  = xp;
+        xp = x->_parent;
+      }else{
+        if( !RED(w->_left) ){
+          w->_right->_color = black;
+          w->_color         = red;
+          rotate_left(h, w);
+          w = xp->_left;
+        }
+        w->_color         = xp->_color;
+        xp->_color        = black;
+        w->_left->_color  = black;
+        rotate_right(h, xp);
+        x = h->_root;
+      }
+    }
+  }
+  if( x ) x->_color = black;
+}
+
+/*! find the first entry of the same key; NULL if not found */
+RBTree::Entry *RBTree::sel(Holder* h, Entry* key){
+  Entry* e = lower_bound(h, key);
+  return (e && cmp_base(e, key) == 0) ? e : NULL;
+}
+
+/*! get the first entry of key >= the given key; NULL if none */
+RBTree::Entry *RBTree::lower_bound(Holder* h, Entry* key){
+  if( h==NULL || key==NULL ) return NULL;
+  Entry* r = NULL;
+  for(Entry* c = h->_root; c; ){
+    if( cmp_base(c, key) < 0 ){ c = c->_right; }
+    else                      { r = c; c = c->_left; }
+  }
+  return r;
+}
+
+/*! get the first entry of key > the given key; NULL if none */
+RBTree::Entry *RBTree::upper_bound(Holder* h, Entry* key){
+  if( h==NULL || key==NULL ) return NULL;
+  Entry* r = NULL;
+  for(Entry* c = h->_root; c; ){
+    if( cmp_base(c, key) <= 0 ){ c = c->_right; }
+    else                       { r = c; c = c->_left; }
+  }
+  return r;
+}
+
+/*! get the entry of the smallest key */
+RBTree::Entry *RBTree::first(Holder* h){
+  if( h==NULL || h->_root==NULL ) return NULL;
+  Entry* e = h->_root;
+  while( e->_left ) e = e->_left;
+  return e;
+}
+
+/*! get the entry of the largest key */
+RBTree::Entry *RBTree::last(Holder* h){
+  if( h==NULL || h->_root==NULL ) return NULL;
+  Entry* e = h->_root;
+  while( e->_right ) e = e->_right;
+  return e;
+}
+
+/*! get the entry next to e in key order; NULL at the last */
+RBTree::Entry *RBTree::next(Entry* e){
+  if( e==NULL ) return NULL;
+  if( e->_right ){
+    e = e->_right;
+    while( e->_left ) e = e->_left;
+    return e;
+  }
+  Entry* p = e->_parent;
+  while( p && e == p->_right ){ e = p; p = p->_parent; }
+  return p;
+}
+
+/*! get the entry previous to e in key order; NULL at the first */
+RBTree::Entry *RBTree::prev(Entry* e){
+  if( e==NULL ) return NULL;
+  if( e->_left ){
+    e = e->_left;
+    while( e->_right ) e = e->_right;
+    return e;
+  }
+  Entry* p = e->_parent;
+  while( p && e == p->_left ){ e = p; p = p->_parent; }
+  return p;
+}
+
+/*! get number of entries */
+int RBTree::num(Holder* h){
+  if( h==NULL ) return 0;
+  return h->_num;
+}
+
+/* black height of the subtree e of lo <= key <= hi; -1 if broken */
+int RBTree::check_sub(Entry* e, Entry* lo, Entry* hi){
+  if( e == NULL ) return 0;
+  if( e->_color != red && e->_color != black )      return -1;
+  if( lo && cmp_base(e, lo) < 0 )                   return -1;
+  if( hi && cmp_base(e, hi) > 0 )                   return -1;
+  if( e->_color == red && (RED(e->_left) || RED(e->_right)) ) return -1;
+  if( e->_left  && e->_left->_parent  != e )        return -1;
+  if( e->_right && e->_right->_parent != e )        return -1;
+
+  int l = check_sub(e->_left,  lo, e);
+  int r = check_sub(e->_right, e,  hi);
+  if( l < 0 || l != r ) return -1;
+  return l + (e->_color == black ? 1 : 0);
+}
+
+/*! verify order and red-black rules (for test); returns black height of
+    the tree, or -1 if broken */
+int RBTree::check(Holder* h){
+  if( h==NULL ) return -1;
+  if( h->_root && (h->_root->_parent || h->_root->_color != black) ) return -1;
+  int n = 0;
+  for(Entry* e = first(h); e; e = next(e)) n++;
+  if( n != h->_num ) return -1;
+  return check_sub(h->_root, NULL, NULL);
+}
+
+/*! get entry and go to the next */
+RBTree::Entry *RBTree::Iter::operator++(){
+  Entry* e = _curr;
+  if( e == NULL || e == _end ) return NULL;
+  _curr = next(e);
+  return e;
+}
+
+}; // jj
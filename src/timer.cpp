@@ -0,0 +1,243 @@
+/*!
+\file   timer.cpp
+\brief  hierarchical timer wheel pattern on DCollect rings
+*/
+
+#include "jj/timer.h"
+
+
+namespace jj {
+
+/*!
+\class  TimerWheel
+\brief  define wheel-timer relation; O(1) schedule and cancel.
+
+TimerWheel keeps timers (Entry) by their deadline in `levels` wheels of
+`slots` rings (jj::DCollect) each.  A timer is put in the level of the
+highest 6-bit digit where its deadline differs from the current time of
+the wheel, and in the slot of that digit:
+
+* schedule() is O(1): a few bit operations and a ring add.
+* cancel() is O(1): the timer unlinks itself from its ring by its own
+  links, wherever the ring is.
+* advance(now) moves the time forward.  It finds the next non-empty slot
+  by a 64-bit occupancy mask per level, so that empty ticks are skipped
+  (no scan per tick), and cascades that slot down to the lower levels.
+  A slot of the lowest level is due as a whole and is taken as it is.
+  Expired timers are returned in batches into the caller's buffer; the
+  rest stays due for the next call.
+
+Ticks are whatever unit the user choses (ms, us, ...).  The 6 levels
+cover 2^36 ticks ahead; farther timers are kept in an overflow ring and
+cascaded when the time comes near them.  A deadline not later than the
+current time is due at once.
+
+### Example
+
+    #include <jj/timer.h>
+    #include "ex.b"
+
+    class Loop : INHERIT_Loop {...};
+    class Conn : INHERIT_Conn {...};
+
+    jjTimerWheel (timeouts, Loop, Conn);
+
+    timeouts.schedule(&loop, conn, now + 30000);
+    ...
+    timeouts.cancel(&loop, conn);       // got reply in time
+    ...
+    Conn* buf[256];
+    int   n;
+    while( (n = timeouts.advance(&loop, now, buf, 256)) > 0 )
+      for(int i=0; i < n; i++) buf[i]->timeout();
+
+See [timer_test.cpp](../test/pattern/timer_test.cpp) source as actual sample.
+*/
+
+/*!
+\class  TimerWheel::Entry
+\brief  Entry (timer) base class for jj::TimerWheel pattern.
+*/
+
+/*!
+\class  TimerWheel::Wheel
+\brief  Wheel base class for jj::TimerWheel pattern.
+*/
+TimerWheel::Wheel::Wheel(){
+  for(int l=0; l < levels; l++) _occ[l] = 0;
+  _now  = 0;
+  _omin = 0;
+  _num  = 0;
+}
+
+/* link scheduled entry into the ring for its deadline */
+void TimerWheel::place(Wheel* w, Entry* e){
+  unsigned long x = e->_when ^ w->_now;
+
+  if( e->_when <= w->_now ){
+    e->_slot = &w->_due;
+  }else{
+    int l = (63 - __builtin_clzl(x)) / bits;
+    if( l >= levels ){
+      if( _ring.num(&w->_over) == 0 || e->_when < w->_omin )
+        w->_omin = e->_when;
+      e->_slot = &w->_over;
+    }else{
+      int s = (e->_when >> (l * bits)) & (slots - 1);
+      w->_occ[l] |= 1ULL << s;
+      e->_slot = &w->_slot[l * slots + s];
+    }
+  }
+  _ring.add(e->_slot, e);
+}
+
+/* unlink entry from its ring; clear the occupancy of emptied slot */
+void TimerWheel::unlink(Wheel* w, Entry* e){
+  DCollect::Parent* p = e->_slot;
+
+  _ring.unlink(p, e);
+  e->_slot = NULL;
+  if( p >= w->_slot && p < w->_slot + levels * slots && _ring.num(p) == 0 ){
+    int i = p - w->_slot;
+    w->_occ[i / slots] &= ~(1ULL << (i % slots));
+  }
+}
+
+/* find the next tick where a slot (or overflow) is to be cascaded */
+bool TimerWheel::next_tick(Wheel* w, unsigned long* t, DCollect::Parent** p){
+  for(int l=0; l < levels; l++){
+    int                 idx = (w->_now >> (l * bits)) & (slots - 1);
+    unsigned long long  m   = (idx == slots - 1) ? 0 : w->_occ[l] & (~0ULL << (idx + 1));
+
+    if( m ){
+      int           s   = __builtin_ctzll(m);
+      int           up  = (l + 1) * bits;
+      *t  = ((w->_now >> up) << up) | ((unsigned long)s << (l * bits));
+      *p  = &w->_slot[l * slots + s];
+      return true;
+    }
+  }
+  if( _ring.num(&w->_over) ){
+    int up = levels * bits;
+    *t  = (w->_omin >> up) << up;
+    if( *t <= w->_now ) *t = ((w->_now >> up) + 1) << up;
+    *p  = &w->_over;
+    return true;
+  }
+  return false;
+}
+
+/*! schedule entry at the deadline (tick); reschedule if already pending */
+void TimerWheel::schedule(Wheel* w, Entry* e, unsigned long when){
+/* require */
+  if( w==NULL || e==NULL ) return;
+
+  if( e->_slot )
+    unlink(w, e);
+  else
+    w->_num++;
+  e->_when = when;
+  place(w, e);
+}
+
+/*! cancel pending entry in O(1) */
+void TimerWheel::cancel(Wheel* w, Entry* e){
+/* require */
+  if( w==NULL || e==NULL ) return;
+
+/* check */
+  if( e->_slot == NULL ) return;
+
+  unlink(w, e);
+  w->_num--;
+}
+
+/* take up to n entries of ring p into buf */
+int TimerWheel::take(Wheel* w, DCollect::Parent* p, Entry** buf, int n){
+  int               k = 0;
+  DCollect::Child*  c;
+
+  while( k < n && (c = _ring.child(p)) != NULL ){
+    Entry* e = static_cast<Entry*>(c);
+    _ring.unlink(p, e);
+    e->_slot = NULL;
+    buf[k++] = e;
+  }
+  w->_num -= k;
+  return k;
+}
+
+/*! move time forward to now and take up to n expired entries into buf.
+    returns number of entries taken; call again until 0 to take all.
+    the time never goes back; now earlier than now(w) takes due ones only. */
+int TimerWheel::advance(Wheel* w, unsigned long now, Entry** buf, int n){
+/* require */
+  if( w==NULL || buf==NULL || n <= 0 ) return 0;
+
+  unsigned long       t;
+  DCollect::Parent*   p;
+  DCollect::Child*    c;
+  int                 k = 0;
+
+  for(;;){
+    /* due ones, then the level 0 slot of current tick (all of it is due) */
+    k += take(w, &w->_due, buf + k, n - k);
+    if( k < n ){
+      int s = w->_now & (slots - 1);
+      if( w->_occ[0] & (1ULL << s) ){
+        k += take(w, &w->_slot[s], buf + k, n - k);
+        if( _ring.num(&w->_slot[s]) == 0 ) w->_occ[0] &= ~(1ULL << s);
+      }
+    }
+    if( k >= n ) break;
+
+    if( !next_tick(w, &t, &p) || t > now ){
+      if( now > w->_now ) w->_now = now;
+      break;
+    }
+    w->_now = t;
+    if( p >= w->_slot && p < w->_slot + slots ) continue;  /* level 0: taken above */
+
+    DCollect::Parent  tmp;
+    if( p == &w->_over ){
+      /* far ones go back to _over; take all out first */
+      while( (c = _ring.child(p)) != NULL ){
+        _ring.unlink(p, c);
+        _ring.add(&tmp, c);
+      }
+      p = &tmp;
+    }else{
+      int i = p - w->_slot;
+      w->_occ[i / slots] &= ~(1ULL << (i % slots));
+    }
+    /* cascade down; each lands in a lower level or _due */
+    while( (c = _ring.child(p)) != NULL ){
+      Entry* e = static_cast<Entry*>(c);
+      _ring.unlink(p, e);
+      place(w, e);
+    }
+  }
+  return k;
+}
+
+/*! get current time of the wheel */
+unsigned long TimerWheel::now(Wheel* w){
+  return w ? w->_now : 0;
+}
+
+/*! get number of pending entries (including expired but not taken) */
+int TimerWheel::num(Wheel* w){
+  return w ? w->_num : 0;
+}
+
+/*! true if entry is scheduled and not yet taken by advance() */
+bool TimerWheel::pending(Entry* e){
+  return e && e->_slot != NULL;
+}
+
+/*! get deadline of entry */
+unsigned long TimerWheel::when(Entry* e){
+  return e ? e->_when : 0;
+}
+
+}; // jj
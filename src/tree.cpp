@@ -0,0 +1,370 @@
+/*!
+\file   tree.cpp
+\brief  Indexes over Aggregate tree for fast ancestor and subtree queries
+*/
+
+#include <malloc.h>
+#include "jj/errno.h"     /* before <thread>, which defines errno macro */
+#include <thread>
+#include <vector>
+#include "jj/tree.h"
+
+
+namespace jj {
+
+/*!
+\class  Euler
+\brief  number the nodes of a tree in DFS order for O(1) subtree queries.
+
+The nodes of the tree under root are numbered in pre-order.  A subtree is
+then a contiguous range `[in(n), out(n))` of the numbers, so that:
+
+* "is n under a" is two compares: `in(a) <= in(n) && in(n) < out(a)`
+* a value per node kept in an array indexed by in() is summed up (or
+  scanned) over a subtree as one contiguous slice; see sum().
+* at(i) gives the node of number i back.
+
+The index remembers Aggregate::version() at build.  Any add() or del() on
+the tree changes it, and the next query rebuilds the index by a stackless
+walk (lazy rebuild).  Call refresh() to rebuild it at a convenient time;
+a node which is no longer under root answers -1 (in/out) or false.
+
+The version is one counter of the whole Aggregate pattern, not of the
+tree under root: add() or del() on any tree of the pattern makes every
+index over it rebuild all of its nodes (O(n)) on the next query.  So the
+index suits trees which are queried much more often than changed; keep a
+busy forest in a pattern of its own.
+
+### Example
+
+    class Node : INHERIT_Node {...};
+    class Org  : INHERIT_Org  {...};
+
+    jjAggregate (tree,  Node, Node);
+    jjEuler     (euler, Org,  Node);
+
+    euler.build(&org, &tree, &root);
+    if( euler.under(&org, &alice, &sales) ) ...
+
+See [euler_test.cpp](../test/pattern/euler_test.cpp) source as actual sample.
+*/
+
+/*!
+\class  Euler::Entry
+\brief  Entry base class for jj::Euler pattern (tree node).
+*/
+
+/*!
+\class  Euler::Index
+\brief  Index base class for jj::Euler pattern.
+*/
+Euler::Index::Index(){
+  _tree   = NULL;
+  _root   = NULL;
+  _conv   = NULL;
+  _ver    = 0;
+  _order  = NULL;
+  _num    = 0;
+  _cap    = 0;
+  _builds = 0;
+}
+
+Euler::Index::~Index(){
+  free(_order);
+}
+
+/*! build index of the tree under root; conv is given by jjEuler */
+void Euler::build(Index* x, Aggregate* tree, Aggregate::Parent* root, Conv conv){
+  if( x==NULL ) return;
+  x->_tree  = tree;
+  x->_root  = root;
+  x->_conv  = conv;
+  x->_ver   = tree ? tree->version() - 1 : 0;   /* force */
+  refresh(x);
+}
+
+/*! rebuild index if the tree has been changed; returns true if rebuilt */
+bool Euler::refresh(Index* x){
+  if( x==NULL || x->_tree==NULL ) return false;
+  if( x->_ver == x->_tree->version() ) return false;
+
+  int*  open  = NULL;       /* ancestors of the current; index is depth */
+  int   top   = 0,
+        ocap  = 0;
+
+  x->_num = 0;
+  Aggregate::PreIter i(x->_tree, x->_root);
+  for(Aggregate::Parent* p; (p = ++i); ){
+    int     d = i.depth();
+    Entry*  n = x->_conv(p);
+
+    while( top > d ){
+      top--;
+      x->_order[open[top]]->_out = x->_num;
+    }
+    if( top == ocap ){
+      ocap  = ocap ? ocap * 2 : 64;
+      open  = (int*)realloc(open, sizeof(int) * ocap);
+    }
+    open[top++] = x->_num;
+
+    if( x->_num == x->_cap ){
+      x->_cap   = x->_cap ? x->_cap * 2 : 64;
+      x->_order = (Entry**)realloc(x->_order, sizeof(Entry*) * x->_cap);
+    }
+    n->_in = x->_num;
+    x->_order[x->_num++] = n;
+  }
+  while( top > 0 ){
+    top--;
+    x->_order[open[top]]->_out = x->_num;
+  }
+  free(open);
+
+  x->_ver = x->_tree->version();
+  x->_builds++;
+  return true;
+}
+
+/*! get number of nodes in the index */
+int Euler::num(Index* x){
+  if( x==NULL ) return 0;
+  refresh(x);
+  return x->_num;
+}
+
+/*! get how many times the index has been built */
+int Euler::builds(Index* x){
+  return x ? x->_builds : 0;
+}
+
+/*! get node of DFS number i */
+Euler::Entry *Euler::at(Index* x, int i){
+  if( x==NULL ) return NULL;
+  refresh(x);
+  return (i >= 0 && i < x->_num) ? x->_order[i] : NULL;
+}
+
+/*! get DFS entry number of n; -1 if n is not under root */
+int Euler::in(Index* x, Entry* n){
+  if( x==NULL || n==NULL ) return -1;
+  refresh(x);
+  if( n->_in < 0 || n->_in >= x->_num || x->_order[n->_in] != n ) return -1;
+  return n->_in;
+}
+
+/*! get in() + subtree size of n; -1 if n is not under root */
+int Euler::out(Index* x, Entry* n){
+  return in(x, n) < 0 ? -1 : n->_out;
+}
+
+/*! get number of nodes in the subtree of n (including n) */
+int Euler::size(Index* x, Entry* n){
+  return in(x, n) < 0 ? 0 : n->_out - n->_in;
+}
+
+/*! check if n is in the subtree of ancestor (n itself is included) */
+bool Euler::under(Index* x, Entry* n, Entry* ancestor){
+  if( in(x, n) < 0 || in(x, ancestor) < 0 ) return false;
+  return ancestor->_in <= n->_in && n->_in < ancestor->_out;
+}
+
+/*! sum val[in(m)] of all m in the subtree of n */
+long Euler::sum(Index* x, Entry* n, const long* val){
+  if( val==NULL || in(x, n) < 0 ) return 0;
+  long s = 0;
+  for(int i=n->_in; i < n->_out; i++) s += val[i];
+  return s;
+}
+
+/*!
+\class  Lift
+\brief  answer depth, k-th ancestor and lowest common ancestor in O(log n).
+
+Aggregate::parent() goes up one level at a time, so these questions take
+O(depth).  Lift keeps, for every node i and k, the 2^k-th ancestor
+`up[k][i]` in flat arrays; then any k-th ancestor is found by at most
+log2(k) jumps, and lca() by O(log n) jumps from both sides.
+
+build() numbers the tree under root by a stackless pre-order walk (so
+parent numbers are known from the depth), then fills `up[k]` from
+`up[k-1]`; each of these log2(depth) rounds is split among threads.
+
+Like Euler, the index is rebuilt lazily on the first query after add() or
+del() changed the tree, and by a change of any other tree of the same
+Aggregate pattern as well; it suits trees which rarely change.
+
+### Example
+
+    jjAggregate (tree, Node, Node);
+    jjLift      (lift, Org,  Node);
+
+    lift.build(&org, &tree, &root);
+    Node* boss = lift.lca(&org, &alice, &bob);
+
+See [lift_test.cpp](../test/pattern/lift_test.cpp) source as actual sample.
+*/
+
+/*!
+\class  Lift::Entry
+\brief  Entry base class for jj::Lift pattern (tree node).
+*/
+
+/*!
+\class  Lift::Index
+\brief  Index base class for jj::Lift pattern.
+*/
+Lift::Index::Index(){
+  _tree     = NULL;
+  _root     = NULL;
+  _conv     = NULL;
+  _ver      = 0;
+  _threads  = 1;
+  _order    = NULL;
+  _depth    = NULL;
+  _up       = NULL;
+  _num      = 0;
+  _cap      = 0;
+  _log      = 0;
+  _builds   = 0;
+}
+
+Lift::Index::~Index(){
+  free(_order);
+  free(_depth);
+  free(_up);
+}
+
+/*!
+build index of the tree under root; conv is given by jjLift.  threads=0
+uses the number of hardware threads.
+*/
+void Lift::build(Index* x, Aggregate* tree, Aggregate::Parent* root, Conv conv,
+                 int threads){
+  if( x==NULL ) return;
+  if( threads <= 0 ) threads = std::thread::hardware_concurrency();
+  x->_tree    = tree;
+  x->_root    = root;
+  x->_conv    = conv;
+  x->_threads = threads > 0 ? threads : 1;
+  x->_ver     = tree ? tree->version() - 1 : 0;   /* force */
+  refresh(x);
+}
+
+/*! rebuild index if the tree has been changed; returns true if rebuilt */
+bool Lift::refresh(Index* x){
+  if( x==NULL || x->_tree==NULL ) return false;
+  if( x->_ver == x->_tree->version() ) return false;
+
+  /* 1. number nodes in pre-order */
+  int max_depth = 0;
+
+  x->_num = 0;
+  Aggregate::PreIter i(x->_tree, x->_root);
+  for(Aggregate::Parent* p; (p = ++i); ){
+    int d = i.depth();
+    if( x->_num == x->_cap ){
+      x->_cap   = x->_cap ? x->_cap * 2 : 64;
+      x->_order = (Entry**)realloc(x->_order, sizeof(Entry*) * x->_cap);
+      x->_depth = (int*)   realloc(x->_depth, sizeof(int)    * x->_cap);
+    }
+    Entry* n = x->_conv(p);
+    n->_ix                = x->_num;
+    x->_order[x->_num]    = n;
+    x->_depth[x->_num]    = d;
+    if( d > max_depth ) max_depth = d;
+    x->_num++;
+  }
+
+  /* 2. up[0] is parent (root: itself); up[k] = up[k-1][up[k-1]] */
+  int n = x->_num;
+  x->_log = 1;
+  while( (1 << x->_log) <= max_depth ) x->_log++;
+  free(x->_up);
+  x->_up = (int*)malloc(sizeof(int) * (size_t)x->_log * (n ? n : 1));
+
+  /* parent is the last node seen one level above */
+  std::vector<int> open;            /* ancestors of the current by depth */
+  for(int j=0; j < n; j++){
+    int d = x->_depth[j];
+    open.resize(d);
+    x->_up[j] = d ? open[d-1] : j;
+    open.push_back(j);
+  }
+  for(int k=1; k < x->_log; k++){
+    int*        prev  = x->_up + (size_t)(k-1) * n;
+    int*        curr  = x->_up + (size_t)k * n;
+    int         t     = (n < 65536) ? 1 : x->_threads;
+    std::vector<std::thread> team;
+
+    auto fill = [=](int b, int e){
+      for(int j=b; j < e; j++) curr[j] = prev[prev[j]];
+    };
+    for(int w=1; w < t; w++) team.emplace_back(fill, (long)n * w / t, (long)n * (w+1) / t);
+    fill(0, n / t);
+    for(auto& th : team) th.join();
+  }
+
+  x->_ver = x->_tree->version();
+  x->_builds++;
+  return true;
+}
+
+/* number of n in the index; -1 if n is not under root */
+int Lift::ix(Index* x, Entry* n){
+  if( x==NULL || n==NULL ) return -1;
+  refresh(x);
+  if( n->_ix < 0 || n->_ix >= x->_num || x->_order[n->_ix] != n ) return -1;
+  return n->_ix;
+}
+
+/*! get number of nodes in the index */
+int Lift::num(Index* x){
+  if( x==NULL ) return 0;
+  refresh(x);
+  return x->_num;
+}
+
+/*! get how many times the index has been built */
+int Lift::builds(Index* x){
+  return x ? x->_builds : 0;
+}
+
+/*! get depth of n from root (root is 0); -1 if n is not under root */
+int Lift::depth(Index* x, Entry* n){
+  int i = ix(x, n);
+  return i < 0 ? -1 : x->_depth[i];
+}
+
+/*! get k-th ancestor of n (0: n itself); NULL if above root */
+Lift::Entry *Lift::ancestor(Index* x, Entry* n, int k){
+  int i = ix(x, n);
+  if( i < 0 || k < 0 || k > x->_depth[i] ) return NULL;
+
+  for(int b=0; k; b++, k >>= 1){
+    if( k & 1 ) i = x->_up[(size_t)b * x->_num + i];
+  }
+  return x->_order[i];
+}
+
+/*! get the lowest common ancestor of a and b; NULL if not in the index */
+Lift::Entry *Lift::lca(Index* x, Entry* a, Entry* b){
+  int i = ix(x, a), j = ix(x, b);
+  if( i < 0 || j < 0 ) return NULL;
+
+  int n = x->_num;
+  if( x->_depth[i] < x->_depth[j] ){ int t = i; i = j; j = t; }
+  for(int k=0, diff = x->_depth[i] - x->_depth[j]; diff; k++, diff >>= 1){
+    if( diff & 1 ) i = x->_up[(size_t)k * n + i];
+  }
+  if( i == j ) return x->_order[i];
+
+  for(int k=x->_log-1; k >= 0; k--){
+    int ui = x->_up[(size_t)k * n + i],
+        uj = x->_up[(size_t)k * n + j];
+    if( ui != uj ){ i = ui; j = uj; }
+  }
+  return x->_order[x->_up[i]];
+}
+
+}; // jj
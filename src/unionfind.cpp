@@ -0,0 +1,141 @@
+/*!
+\file   unionfind.cpp
+\brief  intrusive disjoint-set (union-find) pattern
+*/
+
+#include "jj/unionfind.h"
+
+
+namespace jj {
+
+/*!
+\class  UnionFind
+\brief  define forest-entry relation of disjoint sets (union-find).
+
+Each entry carries its parent pointer, the size of its set (at the root)
+and a link of the ring of the members, so that connected components are
+kept on the objects themselves without a separate index nor id mapping:
+
+* add() puts an entry as a set of its own.
+* find() returns the root (representative) of the set, halving the path
+  on the way (path compression).
+* unite() merges two sets by size, the smaller under the larger, and
+  splices their rings in O(1).  Together with path compression, a
+  sequence of m operations is O(m α(n)).
+* Iter walks all the members of the set of an entry along the ring, in
+  O(size) without find().
+
+A member can't be removed from its set; sets() is the number of sets in
+the forest, i.e. connected components so far.
+
+### Example
+
+    #include <jj/unionfind.h>
+    #include "ex.b"
+
+    class Net  : INHERIT_Net  {...};
+    class Host : INHERIT_Host {...};
+
+    jjUnionFind (comps, Net, Host);
+
+    for(...) comps.add(&net, host);
+    for(each link a-b) comps.unite(&net, a, b);
+
+    if( comps.same(a, b) ) ...              // reachable
+    comps_class::Iter i(a);                 // hosts reachable from a
+    for(Host* h; (h = ++i); ) ...
+
+See [unionfind_test.cpp](../test/pattern/unionfind_test.cpp) source as actual sample.
+*/
+
+/*!
+\class  UnionFind::Entry
+\brief  Entry base class for jj::UnionFind pattern.
+*/
+
+/*!
+\class  UnionFind::Forest
+\brief  Forest base class for jj::UnionFind pattern.
+*/
+
+/*! add entry as a set of its own */
+void UnionFind::add(Forest* f, Entry* e){
+/* require */
+  if( f==NULL || e==NULL ) return;
+
+/* check */
+  if( e->_parent != NULL ) return;      /* already added */
+
+  e->_parent  = e;
+  e->_next    = e;
+  e->_size    = 1;
+  f->_num++;
+  f->_sets++;
+}
+
+/*! get root of the set of entry; NULL if not added */
+UnionFind::Entry *UnionFind::find(Entry* e){
+  if( e==NULL || e->_parent==NULL ) return NULL;
+
+  while( e->_parent != e ){             /* path halving */
+    e->_parent  = e->_parent->_parent;
+    e           = e->_parent;
+  }
+  return e;
+}
+
+/*! merge the sets of a and b; false if already the same (or not added) */
+bool UnionFind::unite(Forest* f, Entry* a, Entry* b){
+/* require */
+  if( f==NULL ) return false;
+
+  a = find(a);
+  b = find(b);
+  if( a==NULL || b==NULL || a==b ) return false;
+
+  if( a->_size < b->_size ){
+    Entry* t = a;  a = b;  b = t;
+  }
+  b->_parent  = a;
+  a->_size   += b->_size;
+
+  Entry* n    = a->_next;               /* splice the rings */
+  a->_next    = b->_next;
+  b->_next    = n;
+  f->_sets--;
+  return true;
+}
+
+/*! true if a and b are in the same set */
+bool UnionFind::same(Entry* a, Entry* b){
+  Entry* r = find(a);
+  return r != NULL && r == find(b);
+}
+
+/*! get number of members of the set of entry */
+int UnionFind::size(Entry* e){
+  e = find(e);
+  return e ? e->_size : 0;
+}
+
+/*! get number of entries added */
+long UnionFind::num(Forest* f){
+  return f ? f->_num : 0;
+}
+
+/*! get number of sets */
+long UnionFind::sets(Forest* f){
+  return f ? f->_sets : 0;
+}
+
+/*! get member, then go to the next around the ring */
+UnionFind::Entry *UnionFind::Iter::operator++(){
+  Entry* result = _curr;
+  if( _curr ){
+    _curr = _curr->_next;
+    if( _curr == _first ) _curr = NULL;
+  }
+  return result;
+}
+
+}; // jj
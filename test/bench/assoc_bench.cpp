@@ -0,0 +1,177 @@
+/*
+= NAME
+assoc_bench  - Assoc pattern vs. link objects in two DCollects vs. std maps
+
+= SYNOPSIS
+make bench [BENCH_OPT="users groups links"]
+
+= DESCRIPTION
+Ties random user-group pairs (4M links of 1M users and 100K groups by
+default), iterates the groups of every user, unlinks a quarter of links
+one by one, then removes every user with all its links.  Shows million
+links/sec of each phase for:
+
+* Assoc:    jjAssoc(members, User, Group); pooled link records
+* DCollect: Member objects by new/delete, in jjDCollect of the User and
+            of the Group (what had to be written before)
+* std:      unordered_map<User*, unordered_multiset<Group*>> and the
+            reverse map
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "jj/pattern.h"
+#include "jj/assoc.h"
+#include "assoc_bench.b" /* include Part-B */
+
+class User  : INHERIT_User  {};
+class Group : INHERIT_Group {};
+
+class Member : INHERIT_Member {
+public:
+  User*   user;
+  Group*  group;
+};
+
+jjAssoc   (members, User,  Group);
+jjDCollect(ugroups, User,  Member);
+jjDCollect(gusers,  Group, Member);
+members_class members;
+ugroups_class ugroups;
+gusers_class  gusers;
+
+template<class F>
+static double mops(long n, F f){
+  auto beg = std::chrono::steady_clock::now();
+  f();
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - beg).count();
+  return n / sec / 1e6;
+}
+
+int main(int argc, char** argv){
+  long              nu  = argc > 1 ? atol(argv[1]) : 1000000;
+  long              ng  = argc > 2 ? atol(argv[2]) : 100000;
+  long              nl  = argc > 3 ? atol(argv[3]) : 4000000;
+  std::vector<int>  pu(nl), pg(nl);
+  std::mt19937_64   rnd(1);
+  long              sum;
+
+  for(long i=0; i < nl; i++){ pu[i] = rnd() % nu; pg[i] = rnd() % ng; }
+
+  printf("users: %ld, groups: %ld, links: %ld\n", nu, ng, nl);
+  printf("%-9s %10s %10s %10s %10s\n", "", "link", "iterate", "unlink", "remove");
+
+/* Assoc */
+  {
+    std::vector<User>             u(nu);
+    std::vector<Group>            g(ng);
+    std::vector<jj::Assoc::Link*> k(nl);
+    double l = mops(nl, [&]{
+      for(long i=0; i < nl; i++) k[i] = members.link(&u[pu[i]], &g[pg[i]]);
+    });
+    sum = 0;
+    double it = mops(nl, [&]{
+      for(long i=0; i < nu; i++){
+        members_class::Rights r(&u[i]);
+        for(Group* p; (p = ++r); ) sum += p - &g[0];
+      }
+    });
+    double un = mops(nl / 4, [&]{
+      for(long i=0; i < nl; i += 4) members.unlink(k[i]);
+    });
+    double rm = mops(nl - nl / 4, [&]{
+      for(long i=0; i < nu; i++) members.unlink_left(&u[i]);
+    });
+    printf("%-9s %10.2f %10.2f %10.2f %10.2f  (sum %ld)\n", "Assoc", l, it, un, rm, sum);
+  }
+
+/* Member objects in two DCollects */
+  {
+    std::vector<User>     u(nu);
+    std::vector<Group>    g(ng);
+    std::vector<Member*>  k(nl);
+    double l = mops(nl, [&]{
+      for(long i=0; i < nl; i++){
+        Member* m = new Member;
+        m->user   = &u[pu[i]];
+        m->group  = &g[pg[i]];
+        ugroups.add(m->user, m);
+        gusers.add(m->group, m);
+        k[i] = m;
+      }
+    });
+    sum = 0;
+    double it = mops(nl, [&]{
+      for(long i=0; i < nu; i++){
+        ugroups_class::Iter r(&u[i]);
+        for(Member* m; (m = ++r); ) sum += m->group - &g[0];
+      }
+    });
+    double un = mops(nl / 4, [&]{
+      for(long i=0; i < nl; i += 4){
+        Member* m = k[i];
+        ugroups.del(m->user, m);
+        gusers.del(m->group, m);
+        delete m;
+      }
+    });
+    double rm = mops(nl - nl / 4, [&]{
+      for(long i=0; i < nu; i++){
+        for(Member* m; (m = ugroups.child(&u[i])); ){
+          ugroups.del(m->user, m);
+          gusers.del(m->group, m);
+          delete m;
+        }
+      }
+    });
+    printf("%-9s %10.2f %10.2f %10.2f %10.2f  (sum %ld)\n", "DCollect", l, it, un, rm, sum);
+  }
+
+/* std maps both ways */
+  {
+    std::vector<User>     u(nu);
+    std::vector<Group>    g(ng);
+    std::unordered_map<User*,  std::unordered_multiset<Group*> > ug;
+    std::unordered_map<Group*, std::unordered_multiset<User*> >  gu;
+    double l = mops(nl, [&]{
+      for(long i=0; i < nl; i++){
+        ug[&u[pu[i]]].insert(&g[pg[i]]);
+        gu[&g[pg[i]]].insert(&u[pu[i]]);
+      }
+    });
+    sum = 0;
+    double it = mops(nl, [&]{
+      for(long i=0; i < nu; i++){
+        auto f = ug.find(&u[i]);
+        if( f == ug.end() ) continue;
+        for(Group* p : f->second) sum += p - &g[0];
+      }
+    });
+    double un = mops(nl / 4, [&]{
+      for(long i=0; i < nl; i += 4){
+        auto& s1 = ug[&u[pu[i]]];
+        s1.erase(s1.find(&g[pg[i]]));
+        auto& s2 = gu[&g[pg[i]]];
+        s2.erase(s2.find(&u[pu[i]]));
+      }
+    });
+    double rm = mops(nl - nl / 4, [&]{
+      for(long i=0; i < nu; i++){
+        auto f = ug.find(&u[i]);
+        if( f == ug.end() ) continue;
+        for(Group* p : f->second){
+          auto& s = gu[p];
+          s.erase(s.find(&u[i]));
+        }
+        ug.erase(f);
+      }
+    });
+    printf("%-9s %10.2f %10.2f %10.2f %10.2f  (sum %ld)\n", "std", l, it, un, rm, sum);
+  }
+  return 0;
+}
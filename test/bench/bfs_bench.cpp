@@ -0,0 +1,94 @@
+/*
+= NAME
+bfs_bench  - Parallel::bfs() scaling over Graph and tree
+
+= SYNOPSIS
+make bench [BENCH_OPT="nodes [degree [max_threads]]"]
+
+= DESCRIPTION
+Builds a random graph (nodes x degree edges) by Graph pattern and a random
+tree of the same node number by Aggregate, then runs BFS from node 0 by
+1, 2, 4, ... max_threads threads (default: hardware threads):
+
+* graph, top-down only
+* graph, direction-optimizing (all nodes given)
+* tree
+
+and a sequential BFS on the live pattern as baseline (ns per edge).
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#include "jj/parallel.h"
+#include "bfs_bench.b" /* include Part-B */
+
+class Vertex : INHERIT_Vertex {
+public:
+  int   mark;
+  Vertex() { mark = 0; }
+};
+
+class Arc : INHERIT_Arc {};
+
+class Dir : INHERIT_Dir {};
+
+jjGraph     (g,    Vertex, Arc);
+jjAggregate (tree, Dir,    Dir);
+g_class     g;
+tree_class  tree;
+
+template<class F>
+static double ns_per(long n, F f){
+  static long sink;
+  auto beg = std::chrono::steady_clock::now();
+  sink += f();
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - beg).count();
+  return sec * 1e9 / n;
+}
+
+int main(int argc, char **argv){
+  int   n       = argc > 1 ? atoi(argv[1]) : 4000000;
+  int   degree  = argc > 2 ? atoi(argv[2]) : 8;
+  int   maxt    = argc > 3 ? atoi(argv[3]) : std::thread::hardware_concurrency();
+  long  m       = (long)n * degree;
+
+  std::mt19937                  rnd(1);
+  std::vector<Vertex>           vs(n);
+  std::vector<Arc>              arcs(m);
+  std::vector<Dir>              dirs(n);
+  std::vector<jj::Graph::Node*> all(n);
+
+  for(int i=0; i < n; i++) all[i] = (g_Node *)&vs[i];
+  for(long k=0; k < m; k++) g.add(&vs[k / degree], &vs[rnd() % n], &arcs[k]);
+  for(int i=1; i < n; i++) tree.add(&dirs[rnd() % i], &dirs[i]);
+
+  double seq = ns_per(m, [&]{
+    std::vector<Vertex*> q;  q.reserve(n);
+    q.push_back(&vs[0]); vs[0].mark = 1;
+    for(size_t h=0; h < q.size(); h++){
+      for(Arc* a : g.outs(q[h])){
+        Vertex* t = g.to(a);
+        if( !t->mark ){ t->mark = 1; q.push_back(t); }
+      }
+    }
+    return (long)q.size(); });
+
+  printf("# nodes=%d edges=%ld hardware_threads=%u  (ns/edge)\n",
+         n, m, std::thread::hardware_concurrency());
+  printf("%-8s %12s %12s %12s\n", "threads", "top-down", "dir-opt", "tree");
+  printf("%-8s %12.2f %12s %12s\n", "seq", seq, "-", "-");
+  for(int t=1; t <= (maxt > 0 ? maxt : 1); t *= 2){
+    jj::Parallel p(t);
+    double td = ns_per(m, [&]{ return (long)p.bfs(&g, all[0], all.data(), n, jj::Parallel::top_down); });
+    double dop = ns_per(m, [&]{ return (long)p.bfs(&g, all[0], all.data(), n); });
+    double tr = ns_per(n, [&]{ return (long)p.bfs(&tree, (tree_Parent *)&dirs[0]); });
+    printf("%-8d %12.2f %12.2f %12.2f\n", t, td, dop, tr);
+  }
+
+  for(int i=n-1; i > 0; i--) tree.del(&dirs[i]);
+  return 0;
+}
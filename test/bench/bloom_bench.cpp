@@ -0,0 +1,80 @@
+/*
+= NAME
+bloom_bench  - Hash::sel() with and without filter() by miss rate
+
+= SYNOPSIS
+make bench [BENCH_OPT="keys [lookups]"]
+
+= DESCRIPTION
+Looks up 'lookups' (10M by default) string keys in a Hash of 'keys' (1M
+by default), as a dedup path does, where 50% to 99% of the lookups miss.
+Shows ns per sel() with filter() off and on, and the filter size per
+entry.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "jj/pattern.h"
+#include "bloom_bench.b" /* include Part-B */
+
+class Seen : INHERIT_Seen {};
+
+class Rec : INHERIT_Rec {
+public:
+  char  str[24];
+};
+
+jjHash (recs, Seen, Rec);
+recs_class recs;
+
+int recs_class::hash_base(Entry* e){
+  unsigned long h = 0;
+  for(const char* s = ((Rec*)e)->str; *s; s++) h = (h ^ (unsigned char)*s) * 0x100000001b3UL;
+  return (int)((h ^ (h >> 29)) & 0x7fffffff);
+}
+
+int recs_class::cmp_base(Entry* e1, Entry* e2){
+  return strcmp(((Rec*)e1)->str, ((Rec*)e2)->str);
+}
+
+int main(int argc, char **argv){
+  long          n = argc > 1 ? atol(argv[1]) : 1000000;
+  long          m = argc > 2 ? atol(argv[2]) : 10000000;
+  std::mt19937  rnd(9);
+
+  std::vector<Rec>  r(n), key(2 * n);     /* key[0..n) hit, key[n..2n) miss */
+  for(long i=0; i < n; i++)     snprintf(r[i].str,   sizeof(r[i].str),   "rec-%09ld", i);
+  for(long i=0; i < 2 * n; i++) snprintf(key[i].str, sizeof(key[i].str), "rec-%09ld", i);
+
+  printf("keys: %ld, lookups: %ld  (ns/sel)\n", n, m);
+  printf("%-6s %10s %10s %12s\n", "miss", "filter off", "filter on", "bytes/entry");
+  for(int pct : {50, 90, 99}){
+    std::vector<int> q(m);
+    for(long k=0; k < m; k++)
+      q[k] = (long)(rnd() % 100) < pct ? n + rnd() % n : rnd() % n;
+
+    double  ns[2];
+    double  bytes = 0;
+    for(int on=0; on < 2; on++){
+      Seen  s;
+      long  found = 0;
+      recs.filter(&s, on);
+      for(long i=0; i < n; i++) recs.add(&s, &r[i]);
+      if( on ) bytes = (double)s._fblocks * 64 / n;
+      auto beg = std::chrono::steady_clock::now();
+      for(long k=0; k < m; k++) found += recs.sel(&s, &key[q[k]]) != NULL;
+      double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - beg).count();
+      ns[on] = sec * 1e9 / m;
+      long expect = 0;
+      for(long k=0; k < m; k++) expect += q[k] < n;
+      if( found != expect ) printf("error: found %ld, expected %ld\n", found, expect);
+      for(long i=0; i < n; i++) recs.del(&s, &r[i]);
+    }
+    printf("%5d%% %10.1f %10.1f %12.1f\n", pct, ns[0], ns[1], bytes);
+  }
+  return 0;
+}
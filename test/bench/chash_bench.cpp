@@ -0,0 +1,122 @@
+/*
+= NAME
+chash_bench  - CHash vs. mutex-wrapped Hash throughput
+
+= SYNOPSIS
+make bench [BENCH_OPT="ops_per_thread [max_threads]"]
+
+= DESCRIPTION
+Each thread runs sel() on random keys and, for the given write ratio,
+toggles (del or add) one of its own entries.  Mixes are read-mostly (5%
+writes) and write-heavy (50% writes), at 1..64 threads.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "jj/pattern.h"
+#include "jj/chash.h"
+#include "chash_bench.b" /* include Part-B */
+
+class App  : INHERIT_App  {};
+
+class Item : INHERIT_Item {
+public:
+  int key;
+  Item(int k) { key = k; }
+};
+
+jjHash  (plain,   App, Item);
+jjCHash (striped, App, Item);
+
+int plain_class::hash_base(Entry *e)              { return ((Item*)e)->key & 0x7fffffff; }
+int plain_class::cmp_base(Entry *e1, Entry *e2)   { return ((Item*)e1)->key - ((Item*)e2)->key; }
+int striped_class::hash_base(Entry *e)            { return ((Item*)e)->key & 0x7fffffff; }
+int striped_class::cmp_base(Entry *e1, Entry *e2) { return ((Item*)e1)->key - ((Item*)e2)->key; }
+
+plain_class   plain;
+striped_class striped;
+std::mutex    plain_lock;
+
+static const int nkey = 1 << 16;    /* keys per run; half are per-thread own */
+
+static inline unsigned next_rand(unsigned& s){
+  s ^= s << 13; s ^= s >> 17; s ^= s << 5;
+  return s;
+}
+
+/* run one mix; returns Mops/sec */
+template<class Sel, class Toggle>
+static double run(int nthread, long ops, int write_pct, Sel sel, Toggle toggle){
+  std::vector<std::thread> threads;
+  auto beg = std::chrono::steady_clock::now();
+  for(int t=0; t < nthread; t++){
+    threads.emplace_back([=]{
+      unsigned  seed = 2463534242u + t * 7919;
+      for(long i=0; i < ops; i++){
+        unsigned r = next_rand(seed);
+        if( (int)(r % 100) < write_pct )
+          toggle(t, nthread, r);
+        else
+          sel(r % nkey);
+      }
+    });
+  }
+  for(auto& th : threads) th.join();
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - beg).count();
+  return nthread * ops / sec / 1e6;
+}
+
+int main(int argc, char **argv){
+  long  ops         = argc > 1 ? atol(argv[1]) : 200000;
+  int   max_threads = argc > 2 ? atoi(argv[2]) : 64;
+
+  std::vector<Item*>  items;
+  std::vector<char>   in_plain(nkey), in_striped(nkey);
+  App   plain_app, striped_app;
+
+  for(int k=0; k < nkey; k++){
+    items.push_back(new Item(k));
+    plain.add(&plain_app, items[k]);     in_plain[k]   = 1;
+    striped.add(&striped_app, items[k]); in_striped[k] = 1;
+  }
+
+  printf("# ops/thread=%ld keys=%d  (Mops/sec)\n", ops, nkey);
+  printf("%-8s %-8s %12s %12s\n", "mix", "threads", "Hash+mutex", "CHash");
+  const int   pcts[]  = {5, 50};
+  const char* names[] = {"read95", "write50"};
+  for(int m=0; m < 2; m++){
+    for(int n=1; n <= max_threads; n *= 2){
+      /* thread t toggles keys k with k % nthread == t only */
+      double a = run(n, ops, pcts[m],
+        [&](int k){
+          Item key(k);
+          std::lock_guard<std::mutex> lock(plain_lock);
+          plain.sel(&plain_app, &key);
+        },
+        [&](int t, int nt, unsigned r){
+          int k = (int)(r % (nkey / nt)) * nt + t;
+          std::lock_guard<std::mutex> lock(plain_lock);
+          if( in_plain[k] ) plain.del(&plain_app, items[k]);
+          else              plain.add(&plain_app, items[k]);
+          in_plain[k] ^= 1;
+        });
+      double b = run(n, ops, pcts[m],
+        [&](int k){
+          Item key(k);
+          striped.sel(&striped_app, &key);
+        },
+        [&](int t, int nt, unsigned r){
+          int k = (int)(r % (nkey / nt)) * nt + t;
+          if( in_striped[k] ) striped.del(&striped_app, items[k]);
+          else                striped.add(&striped_app, items[k]);
+          in_striped[k] ^= 1;
+        });
+      printf("%-8s %-8d %12.2f %12.2f\n", names[m], n, a, b);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,132 @@
+/*
+= NAME
+csr_bench  - live Graph / tree traversal vs. CSR snapshot
+
+= SYNOPSIS
+make bench [BENCH_OPT="nodes [degree]"]
+
+= DESCRIPTION
+Builds a random graph (nodes x degree edges) by Graph pattern and a random
+tree of the same node number by Aggregate, then measures on the live
+patterns and on their CSR snapshot:
+
+* bfs from node 0 (ns per edge)
+* 10 PageRank iterations (ns per edge and iteration)
+* subtree sum of every node of the tree (ns per node)
+
+The time of freeze() is shown, too, to see how many runs pay for it.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "jj/pattern.h"
+#include "csr_bench.b" /* include Part-B */
+
+class Vertex : INHERIT_Vertex {
+public:
+  int     mark;
+  double  rank, next;
+  Vertex() { mark = 0; rank = next = 0; }
+};
+
+class Arc : INHERIT_Arc {};
+
+class Dir : INHERIT_Dir {
+public:
+  long  size, sum;
+  Dir() { size = 1; sum = 0; }
+};
+
+jjGraph     (g,    Vertex, Arc);
+jjAggregate (tree, Dir,    Dir);
+g_class     g;
+tree_class  tree;
+
+template<class F>
+static double ns_per(long n, F f){
+  static long sink;
+  auto beg = std::chrono::steady_clock::now();
+  sink += f();
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - beg).count();
+  return sec * 1e9 / n;
+}
+
+static long live_sum(Dir* d){
+  long s = d->size;
+  for(Dir* c : tree.range(d)) s += live_sum(c);
+  d->sum = s;
+  return s;
+}
+
+int main(int argc, char **argv){
+  int   n       = argc > 1 ? atoi(argv[1]) : 1000000;
+  int   degree  = argc > 2 ? atoi(argv[2]) : 8;
+  long  m       = (long)n * degree;
+  const int iter = 10;
+  const double d = 0.85;
+
+  std::mt19937          rnd(1);
+  std::vector<Vertex>   vs(n);
+  std::vector<Vertex*>  vp(n);
+  std::vector<Arc>      arcs(m);
+  std::vector<Dir>      dirs(n);
+
+  for(int i=0; i < n; i++) vp[i] = &vs[i];
+  for(long k=0; k < m; k++) g.add(&vs[k / degree], &vs[rnd() % n], &arcs[k]);
+  for(int i=1; i < n; i++) tree.add(&dirs[rnd() % i], &dirs[i]);
+
+  jj::CSR gs, ts;
+  double freeze_g = ns_per(m, [&]{ g.freeze(&gs, vp.data(), n); return 0L; });
+  double freeze_t = ns_per(n, [&]{ tree.freeze(&ts, &dirs[0]); return 0L; });
+
+  /* bfs */
+  double bfs_l = ns_per(m, [&]{
+    std::vector<Vertex*> q;  q.reserve(n);
+    q.push_back(&vs[0]); vs[0].mark = 1;
+    for(size_t h=0; h < q.size(); h++){
+      for(Arc* a : g.outs(q[h])){
+        Vertex* t = g.to(a);
+        if( !t->mark ){ t->mark = 1; q.push_back(t); }
+      }
+    }
+    return (long)q.size(); });
+  std::vector<int> dist(n);
+  double bfs_s = ns_per(m, [&]{ return (long)gs.bfs(0, dist.data()); });
+
+  /* pagerank */
+  double pr_l = ns_per(m * iter, [&]{
+    for(auto& v : vs) v.rank = 1.0 / n;
+    for(int it=0; it < iter; it++){
+      double dangling = 0;
+      for(auto& v : vs) if( g.num_out(&v) == 0 ) dangling += v.rank;
+      for(auto& v : vs) v.next = (1 - d + d * dangling) / n;
+      for(auto& v : vs){
+        int deg = g.num_out(&v);
+        if( deg == 0 ) continue;
+        double share = d * v.rank / deg;
+        for(Arc* a : g.outs(&v)) g.to(a)->next += share;
+      }
+      for(auto& v : vs) v.rank = v.next;
+    }
+    return 0L; });
+  std::vector<double> rank(n);
+  double pr_s = ns_per(m * iter, [&]{ gs.pagerank(rank.data(), iter, d); return 0L; });
+
+  /* subtree sum */
+  double sum_l = ns_per(n, [&]{ return live_sum(&dirs[0]); });
+  std::vector<long> val(n), sum(n);
+  for(int i=0; i < n; i++) val[i] = tree.node(&ts, i)->size;
+  double sum_s = ns_per(n, [&]{ ts.subtree_sum(val.data(), sum.data()); return sum[0]; });
+
+  printf("# nodes=%d edges=%ld\n", n, m);
+  printf("%-20s %10s %10s %10s\n", "op", "live", "CSR", "freeze");
+  printf("%-20s %10.2f %10.2f %10.2f\n", "bfs (ns/edge)",      bfs_l, bfs_s, freeze_g);
+  printf("%-20s %10.2f %10.2f %10s\n",   "pagerank (ns/edge)", pr_l,  pr_s,  "-");
+  printf("%-20s %10.2f %10.2f %10.2f\n", "subtree (ns/node)",  sum_l, sum_s, freeze_t);
+
+  for(int i=n-1; i > 0; i--) tree.del(&dirs[i]);
+  return 0;
+}
@@ -0,0 +1,131 @@
+/*
+= NAME
+expire_bench  - one-pass expiry by Iter::del() vs. a side vector
+
+= SYNOPSIS
+make bench [BENCH_OPT="entries"]
+
+= DESCRIPTION
+Deletes the expired entries (10%, 50%, 90% of them, chosen at random) out
+of a Hash of 'entries' (1M by default) and a Collect of 'entries'/20:
+
+* Iter::del(): one pass; the current one is deleted in O(1)
+* vector:      pointers of the expired ones are pushed into a
+               std::vector during the walk, then del() of the pattern
+               each (what had to be written before)
+
+Collect::del() searches the ring for the one before the child, so the
+vector way is quadratic there; hence the smaller Collect.  Times are ns
+per entry walked.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "jj/pattern.h"
+#include "expire_bench.b" /* include Part-B */
+
+class Table : INHERIT_Table {};
+class Queue : INHERIT_Queue {};
+
+class HItem : INHERIT_HItem {
+public:
+  long  key;
+  int   stamp;
+};
+
+class CItem : INHERIT_CItem {
+public:
+  int   stamp;
+};
+
+jjHash    (table, Table, HItem);
+jjCollect (queue, Queue, CItem);
+table_class table;
+queue_class queue;
+
+int table_class::hash_base(Entry* e){
+  unsigned long k = ((HItem*)e)->key * 0x9e3779b97f4a7c15UL;
+  return (int)(k >> 33);
+}
+
+int table_class::cmp_base(Entry* e1, Entry* e2){
+  long d = ((HItem*)e1)->key - ((HItem*)e2)->key;
+  return d < 0 ? -1 : d > 0;
+}
+
+template<class F>
+static double ns_per(long n, F f){
+  auto beg = std::chrono::steady_clock::now();
+  f();
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - beg).count();
+  return sec * 1e9 / n;
+}
+
+int main(int argc, char **argv){
+  long            n   = argc > 1 ? atol(argv[1]) : 1000000;
+  long            nc  = n / 20;
+  std::mt19937    rnd(3);
+  Table           t;
+  Queue           q;
+  std::vector<HItem>  h(n);
+  std::vector<CItem>  c(nc);
+
+  for(long i=0; i < n; i++){
+    h[i].key   = i;
+    h[i].stamp = rnd() % 100;
+    table.add(&t, &h[i]);
+  }
+  for(long i=0; i < nc; i++){
+    c[i].stamp = rnd() % 100;
+    queue.add(&q, &c[i]);
+  }
+
+  printf("entries: Hash %ld, Collect %ld\n", n, nc);
+  printf("%-10s %8s %12s %12s\n", "", "expired", "Iter::del()", "vector");
+  for(int pct : {10, 50, 90}){
+    double  d[2];
+    long    left[2];
+
+  /* Hash */
+    for(int way=0; way < 2; way++){
+      d[way] = ns_per(n, [&]{
+        table_class::Iter i(&t);
+        if( way == 0 ){
+          for(HItem* e; (e = (HItem*)++i); )
+            if( e->stamp < pct ) i.del();
+        }else{
+          std::vector<HItem*> v;
+          for(HItem* e; (e = (HItem*)++i); )
+            if( e->stamp < pct ) v.push_back(e);
+          for(HItem* e : v) table.del(&t, e);
+        }
+      });
+      left[way] = table.num(&t);
+      for(long k=0; k < n; k++) table.add(&t, &h[k]);   /* refill; no-op if there */
+    }
+    printf("%-10s %7d%% %12.2f %12.2f  (left %ld, %ld)\n", "Hash", pct, d[0], d[1], left[0], left[1]);
+
+  /* Collect */
+    for(int way=0; way < 2; way++){
+      d[way] = ns_per(nc, [&]{
+        queue_class::Iter i(&q);
+        if( way == 0 ){
+          for(CItem* e; (e = ++i); )
+            if( e->stamp < pct ) i.del();
+        }else{
+          std::vector<CItem*> v;
+          for(CItem* e; (e = ++i); )
+            if( e->stamp < pct ) v.push_back(e);
+          for(CItem* e : v) queue.del(&q, e);
+        }
+      });
+      left[way] = queue.num(&q);
+      for(long k=0; k < nc; k++) queue.add(&q, &c[k]);
+    }
+    printf("%-10s %7d%% %12.2f %12.2f  (left %ld, %ld)\n", "Collect", pct, d[0], d[1], left[0], left[1]);
+  }
+  return 0;
+}
@@ -0,0 +1,86 @@
+/*
+= NAME
+fold_bench  - Parallel::fold() over deep and wide trees
+
+= SYNOPSIS
+make bench [BENCH_OPT="nodes [max_threads [cutoff]]"]
+
+= DESCRIPTION
+Builds two trees by jjAggregate(tree, Dir, Dir):
+
+* wide: parent of node i is random in 0..i-1 (depth ~ log n)
+* deep: parent of node i is random in i-4..i-1 (depth ~ n/2.5)
+
+and computes the size sum of every subtree by fold() with 1, 2, 4, ...
+max_threads threads (ns per node).  Recursion is shown for the wide tree
+as baseline; it overflows the stack on the deep one.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#include "jj/parallel.h"
+#include "fold_bench.b" /* include Part-B */
+
+class Dir : INHERIT_Dir {
+public:
+  long  size, sum;
+  Dir() { size = 1; sum = 0; }
+};
+
+jjAggregate (tree, Dir, Dir);
+tree_class  tree;
+
+class Sum : public jj::Parallel {
+public:
+  Sum(int threads) : jj::Parallel(threads) {}
+protected:
+  long post_base(jj::Aggregate::Parent* p, long children){
+    Dir* d = static_cast<Dir*>(static_cast<tree_Parent*>(p));
+    return d->sum = d->size + children;
+  }
+};
+
+template<class F>
+static double ns_per(long n, F f){
+  static long sink;
+  auto beg = std::chrono::steady_clock::now();
+  sink += f();
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - beg).count();
+  return sec * 1e9 / n;
+}
+
+static long rec_sum(Dir* d){
+  long s = d->size;
+  for(Dir* c : tree.range(d)) s += rec_sum(c);
+  return d->sum = s;
+}
+
+int main(int argc, char **argv){
+  int   n       = argc > 1 ? atoi(argv[1]) : 2000000;
+  int   maxt    = argc > 2 ? atoi(argv[2]) : std::thread::hardware_concurrency();
+  int   cutoff  = argc > 3 ? atoi(argv[3]) : 0;
+
+  std::mt19937      rnd(1);
+  std::vector<Dir>  wide(n), deep(n);
+
+  for(int i=1; i < n; i++) tree.add(&wide[rnd() % i], &wide[i]);
+  for(int i=1; i < n; i++) tree.add(&deep[i - 1 - (i > 4 ? rnd() % 4 : 0)], &deep[i]);
+
+  printf("# nodes=%d hardware_threads=%u cutoff=%d  (ns/node)\n",
+         n, std::thread::hardware_concurrency(), cutoff);
+  printf("%-10s %10s %10s\n", "threads", "wide", "deep");
+  printf("%-10s %10.2f %10s\n", "recursion", ns_per(n, [&]{ return rec_sum(&wide[0]); }), "-");
+  for(int t=1; t <= (maxt > 0 ? maxt : 1); t *= 2){
+    Sum s(t);
+    double w = ns_per(n, [&]{ return s.fold(&tree, (tree_Parent *)&wide[0], cutoff); });
+    double d = ns_per(n, [&]{ return s.fold(&tree, (tree_Parent *)&deep[0], cutoff); });
+    printf("%-10d %10.2f %10.2f\n", t, w, d);
+  }
+
+  for(int i=n-1; i > 0; i--){ tree.del(&wide[i]); tree.del(&deep[i]); }
+  return 0;
+}
@@ -0,0 +1,108 @@
+/*
+= NAME
+graph_bench  - Graph traversal vs. std::vector<std::vector<int>>
+
+= SYNOPSIS
+make bench [BENCH_OPT="nodes [degree]"]
+
+= DESCRIPTION
+Builds the same random graph (nodes x degree edges) in a Graph pattern and
+in an adjacency vector, then measures BFS from node 0 and a sum of
+neighbor values over all nodes (ns per edge), and del() of all edges.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "jj/pattern.h"
+#include "graph_bench.b" /* include Part-B */
+
+class Vertex : INHERIT_Vertex {
+public:
+  int   id;
+  int   mark;
+  long  val;
+  Vertex(int i=0) { id = i; mark = 0; val = i; }
+};
+
+class Arc : INHERIT_Arc {};
+
+jjGraph (g, Vertex, Arc);
+g_class g;
+
+template<class F>
+static double ns_per(long n, F f){
+  static long sink;
+  auto beg = std::chrono::steady_clock::now();
+  sink += f();
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - beg).count();
+  return sec * 1e9 / n;
+}
+
+int main(int argc, char **argv){
+  int   n       = argc > 1 ? atoi(argv[1]) : 1000000;
+  int   degree  = argc > 2 ? atoi(argv[2]) : 8;
+  long  m       = (long)n * degree;
+
+  std::mt19937                      rnd(1);
+  std::vector<Vertex>               vs(n);
+  std::vector<Arc>                  arcs(m);
+  std::vector<std::vector<int> >    adj(n);
+  std::vector<long>                 val(n);
+
+  for(int i=0; i < n; i++){ vs[i].id = i; vs[i].val = val[i] = i; }
+  double build_g = ns_per(m, [&]{
+    std::mt19937 r(1);
+    for(long k=0; k < m; k++) g.add(&vs[k / degree], &vs[r() % n], &arcs[k]);
+    return 0L; });
+  double build_v = ns_per(m, [&]{
+    std::mt19937 r(1);
+    for(long k=0; k < m; k++) adj[k / degree].push_back(r() % n);
+    return 0L; });
+
+  double bfs_g = ns_per(m, [&]{
+    std::vector<Vertex*> q;  q.reserve(n);
+    q.push_back(&vs[0]); vs[0].mark = 1;
+    for(size_t h=0; h < q.size(); h++){
+      for(Arc* a : g.outs(q[h])){
+        Vertex* t = g.to(a);
+        if( !t->mark ){ t->mark = 1; q.push_back(t); }
+      }
+    }
+    return (long)q.size(); });
+  double bfs_v = ns_per(m, [&]{
+    std::vector<char> mark(n);
+    std::vector<int>  q;  q.reserve(n);
+    q.push_back(0); mark[0] = 1;
+    for(size_t h=0; h < q.size(); h++){
+      for(int t : adj[q[h]]){
+        if( !mark[t] ){ mark[t] = 1; q.push_back(t); }
+      }
+    }
+    return (long)q.size(); });
+
+  double sum_g = ns_per(m, [&]{
+    long s = 0;
+    for(int i=0; i < n; i++)
+      for(Arc* a : g.outs(&vs[i])) s += g.to(a)->val;
+    return s; });
+  double sum_v = ns_per(m, [&]{
+    long s = 0;
+    for(int i=0; i < n; i++)
+      for(int t : adj[i]) s += val[t];
+    return s; });
+
+  double del_g = ns_per(m, [&]{
+    for(long k=0; k < m; k++) g.del(&arcs[k]);
+    return 0L; });
+
+  printf("# nodes=%d edges=%ld  (ns/edge)\n", n, m);
+  printf("%-14s %10s %10s\n", "op", "Graph", "vector");
+  printf("%-14s %10.2f %10.2f\n", "build",      build_g, build_v);
+  printf("%-14s %10.2f %10.2f\n", "bfs",        bfs_g,   bfs_v);
+  printf("%-14s %10.2f %10.2f\n", "sum-neighbor", sum_g, sum_v);
+  printf("%-14s %10.2f %10s\n",   "del",        del_g,   "-");
+  return 0;
+}
@@ -0,0 +1,147 @@
+/*
+= NAME
+heap_bench  - Heap pattern vs. std::priority_queue with lazy deletion
+
+= SYNOPSIS
+make bench [BENCH_OPT="jobs [ops]"]
+
+= DESCRIPTION
+Keeps jobs (1M by default) queued by key, then runs ops (4M by default)
+of a scheduler-like mix: 40% decrease-key, 20% erase and re-add of a
+random job, 40% pop-min and re-add with a later key.  Finally pops all.
+Shows million ops/sec of:
+
+* Heap: jjHeap(runq, Sched, Job); decrease() and del() on the entry
+* pq:   std::priority_queue of (key, job, version); a changed or erased
+        job pushes a new version and stale ones are skipped at pop
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <functional>
+#include <queue>
+#include <random>
+#include <tuple>
+#include <vector>
+#include "jj/heap.h"
+#include "heap_bench.b" /* include Part-B */
+
+class Sched : INHERIT_Sched {};
+
+class Job : INHERIT_Job {
+public:
+  long  key;
+  int   ver;          /* for pq: valid version; -1 if not queued */
+};
+
+jjHeap (runq, Sched, Job);
+runq_class runq;
+
+int runq_class::cmp_base(Entry *e1, Entry *e2){
+  return ((Job*)e1)->key < ((Job*)e2)->key ? -1 : ((Job*)e1)->key > ((Job*)e2)->key;
+}
+
+template<class F>
+static double mops(long n, F f){
+  auto beg = std::chrono::steady_clock::now();
+  f();
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - beg).count();
+  return n / sec / 1e6;
+}
+
+int main(int argc, char** argv){
+  long              n   = argc > 1 ? atol(argv[1]) : 1000000;
+  long              ops = argc > 2 ? atol(argv[2]) : 4000000;
+  std::vector<Job>  j(n);
+  std::vector<long> key0(n);
+  std::vector<unsigned> op(ops);
+  std::mt19937_64   rnd(1);
+  long              sum;
+
+  for(long i=0; i < n; i++) key0[i] = rnd() % (n * 16);
+  for(long k=0; k < ops; k++) op[k] = rnd();
+
+  printf("jobs: %ld, ops: %ld\n", n, ops);
+  printf("%-6s %10s %10s %10s\n", "", "add", "mix", "pop all");
+
+/* Heap */
+  {
+    Sched s;
+    for(long i=0; i < n; i++) j[i].key = key0[i];
+    double a = mops(n, [&]{
+      for(long i=0; i < n; i++) runq.add(&s, &j[i]);
+    });
+    double m = mops(ops, [&]{
+      for(long k=0; k < ops; k++){
+        unsigned  r = op[k];
+        Job*      x = &j[(r >> 8) % n];
+        switch( r % 5 ){
+        case 0: case 1:
+          x->key -= r % 64;
+          runq.decrease(&s, x);
+          break;
+        case 2:
+          runq.del(&s, x);
+          runq.add(&s, x);
+          break;
+        default:
+          x = runq.pop(&s);
+          x->key += r % 1024;
+          runq.add(&s, x);
+        }
+      }
+    });
+    sum = 0;
+    double p = mops(n, [&]{
+      for(Job* x; (x = runq.pop(&s)); ) sum += x->key;
+    });
+    printf("%-6s %10.2f %10.2f %10.2f  (sum %ld)\n", "Heap", a, m, p, sum);
+  }
+
+/* std::priority_queue with lazy deletion */
+  {
+    typedef std::tuple<long, int, Job*> Item;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item> > q;
+    for(long i=0; i < n; i++){ j[i].key = key0[i]; j[i].ver = 0; }
+
+    auto push = [&](Job* x){ q.push(Item(x->key, x->ver, x)); };
+    auto pop  = [&]() -> Job* {
+      while( !q.empty() ){
+        Item t = q.top();
+        q.pop();
+        Job* x = std::get<2>(t);
+        if( std::get<1>(t) == x->ver ){ x->ver++; return x; }   /* stale ones skipped */
+      }
+      return NULL;
+    };
+    double a = mops(n, [&]{
+      for(long i=0; i < n; i++) push(&j[i]);
+    });
+    double m = mops(ops, [&]{
+      for(long k=0; k < ops; k++){
+        unsigned  r = op[k];
+        Job*      x = &j[(r >> 8) % n];
+        switch( r % 5 ){
+        case 0: case 1:
+          x->key -= r % 64;
+          x->ver++;   push(x);
+          break;
+        case 2:
+          x->ver++;   push(x);            /* erase + re-add */
+          break;
+        default:
+          x = pop();
+          x->key += r % 1024;
+          push(x);
+        }
+      }
+    });
+    sum = 0;
+    double p = mops(n, [&]{
+      for(Job* x; (x = pop()); ) sum += x->key;
+    });
+    printf("%-6s %10.2f %10.2f %10.2f  (sum %ld)\n", "pq", a, m, p, sum);
+  }
+  return 0;
+}
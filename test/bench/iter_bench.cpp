@@ -0,0 +1,104 @@
+/*
+= NAME
+iter_bench  - Iter loop vs. STL iterator over patterns
+
+= SYNOPSIS
+make bench [BENCH_OPT="children [repeat]"]
+
+= DESCRIPTION
+Sums a member over all children by the hand-written 'while((c = ++i))'
+loop, by range-for and by std::accumulate().  Times are ns per child.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <numeric>
+#include <vector>
+#include "jj/pattern.h"
+#include "iter_bench.b" /* include Part-B */
+
+class Owner : INHERIT_Owner {};
+
+class Item  : INHERIT_Item {
+public:
+  long  val;
+  Item(long v) { val = v; }
+};
+
+jjAggregate (agg,   Owner, Item);
+jjCollect   (col,   Owner, Item);
+jjDCollect  (dcol,  Owner, Item);
+jjHash      (hash,  Owner, Item);
+
+int hash_class::hash_base(Entry *e)             { return ((Item*)e)->val & 0x7fffffff; }
+int hash_class::cmp_base(Entry *e1, Entry *e2)  { return ((Item*)e1)->val - ((Item*)e2)->val; }
+
+agg_class   agg;
+col_class   col;
+dcol_class  dcol;
+hash_class  hash;
+
+static long g_sink;
+
+template<class F>
+static double ns_per(long n, int repeat, F f){
+  auto beg = std::chrono::steady_clock::now();
+  for(int r=0; r < repeat; r++) g_sink += f();
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - beg).count();
+  return sec * 1e9 / n / repeat;
+}
+
+#define BENCH(name, pat)                                                        \
+  {                                                                             \
+    double a = ns_per(n, repeat, [&]{                                           \
+      long s = 0; Item* c; pat##_class::Iter i(&owner);                         \
+      while( (c = ++i) ) s += c->val;                                           \
+      return s; });                                                             \
+    double b = ns_per(n, repeat, [&]{                                           \
+      long s = 0;                                                               \
+      for(Item* c : pat.range(&owner)) s += c->val;                             \
+      return s; });                                                             \
+    double c = ns_per(n, repeat, [&]{                                           \
+      return std::accumulate(pat.begin(&owner), pat.end(&owner), 0L,           \
+                             [](long s, Item* c){ return s + c->val; }); });    \
+    printf("%-10s %10.2f %10.2f %10.2f\n", name, a, b, c);                      \
+  }
+
+int main(int argc, char **argv){
+  long  n       = argc > 1 ? atol(argv[1]) : 1000000;
+  int   repeat  = argc > 2 ? atoi(argv[2]) : 20;
+  Owner owner;
+  std::vector<Item*> items;
+
+  for(long k=0; k < n; k++){
+    Item* it = new Item(k);
+    items.push_back(it);
+    agg.add(&owner, it);
+    col.add(&owner, it);
+    dcol.add(&owner, it);
+    hash.add(&owner, it);
+  }
+
+  printf("# children=%ld repeat=%d  (ns/child)\n", n, repeat);
+  printf("%-10s %10s %10s %10s\n", "pattern", "Iter", "range-for", "accumulate");
+  BENCH("Aggregate",  agg);
+  BENCH("Collect",    col);
+  BENCH("DCollect",   dcol);
+  {
+    /* Hash::Iter returns jj::Hash::Entry*, so cast as users do */
+    double a = ns_per(n, repeat, [&]{
+      long s = 0; Item* c; hash_class::Iter i(&owner);
+      while( (c = (Item*)++i) ) s += c->val;
+      return s; });
+    double b = ns_per(n, repeat, [&]{
+      long s = 0;
+      for(Item* c : hash.range(&owner)) s += c->val;
+      return s; });
+    double c = ns_per(n, repeat, [&]{
+      return std::accumulate(hash.begin(&owner), hash.end(&owner), 0L,
+                             [](long s, Item* c){ return s + c->val; }); });
+    printf("%-10s %10.2f %10.2f %10.2f\n", "Hash", a, b, c);
+  }
+  return g_sink == 42;
+}
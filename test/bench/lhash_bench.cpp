@@ -0,0 +1,119 @@
+/*
+= NAME
+lhash_bench  - LHash ordered scan vs. Hash scan and sort
+
+= SYNOPSIS
+make bench [BENCH_OPT="entries [scans]"]
+
+= DESCRIPTION
+Adds entries (1M by default) to a Hash and to an LHash, then takes a
+deterministic (insertion order) snapshot of them some times (10 by
+default).  Also evicts all of them in FIFO order.  Shows million
+entries/sec of:
+
+* Hash:  jjHash; Iter in bucket order, then sort by a sequence number;
+         FIFO by a std::deque kept beside
+* LHash: jjLHash; Iter in insertion order, pop() for FIFO
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <vector>
+#include "jj/lhash.h"
+#include "lhash_bench.b" /* include Part-B */
+
+class Conf : INHERIT_Conf {};
+
+class HItem : INHERIT_HItem {
+public:
+  int   key;
+  long  seq;          /* insertion order, for sort */
+};
+
+class LItem : INHERIT_LItem {
+public:
+  int   key;
+};
+
+jjHash  (hitems, Conf, HItem);
+jjLHash (litems, Conf, LItem);
+hitems_class hitems;
+litems_class litems;
+
+int hitems_class::hash_base(Entry *e)            { return ((HItem*)e)->key & 0x7fffffff; }
+int hitems_class::cmp_base(Entry *e1, Entry *e2) { return ((HItem*)e1)->key - ((HItem*)e2)->key; }
+int litems_class::hash_base(Entry *e)            { return ((LItem*)e)->key & 0x7fffffff; }
+int litems_class::cmp_base(Entry *e1, Entry *e2) { return ((LItem*)e1)->key - ((LItem*)e2)->key; }
+
+template<class F>
+static double mops(long n, F f){
+  auto beg = std::chrono::steady_clock::now();
+  f();
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - beg).count();
+  return n / sec / 1e6;
+}
+
+int main(int argc, char** argv){
+  long              n     = argc > 1 ? atol(argv[1]) : 1000000;
+  int               scans = argc > 2 ? atoi(argv[2]) : 10;
+  std::vector<HItem>  hi(n);
+  std::vector<LItem>  li(n);
+  std::vector<HItem*> hsnap(n);
+  std::vector<LItem*> lsnap(n);
+  long                sum;
+
+  for(long i=0; i < n; i++){
+    hi[i].key = li[i].key = (int)((i * 2654435761UL) & 0x3fffffff);
+    hi[i].seq = i;
+  }
+  printf("entries: %ld, scans: %d\n", n, scans);
+  printf("%-6s %10s %10s %10s\n", "", "add", "snapshot", "fifo");
+
+/* Hash + sort */
+  {
+    Conf            c;
+    std::deque<HItem*> fifo;
+    double a = mops(n, [&]{
+      for(long i=0; i < n; i++){ hitems.add(&c, &hi[i]); fifo.push_back(&hi[i]); }
+    });
+    sum = 0;
+    double s = mops(n * scans, [&]{
+      for(int k=0; k < scans; k++){
+        long m = 0;
+        hitems_class::Iter i(&c);
+        for(HItem* p; (p = (HItem*)++i); ) hsnap[m++] = p;
+        std::sort(hsnap.begin(), hsnap.begin() + m, [](HItem* x, HItem* y){ return x->seq < y->seq; });
+        sum += hsnap[m / 2]->key;
+      }
+    });
+    double f = mops(n, [&]{
+      while( !fifo.empty() ){ hitems.del(&c, fifo.front()); fifo.pop_front(); }
+    });
+    printf("%-6s %10.2f %10.2f %10.2f  (sum %ld)\n", "Hash", a, s, f, sum);
+  }
+
+/* LHash */
+  {
+    Conf  c;
+    double a = mops(n, [&]{
+      for(long i=0; i < n; i++) litems.add(&c, &li[i]);
+    });
+    sum = 0;
+    double s = mops(n * scans, [&]{
+      for(int k=0; k < scans; k++){
+        long m = 0;
+        litems_class::Iter i(&c);
+        for(LItem* p; (p = ++i); ) lsnap[m++] = p;
+        sum += lsnap[m / 2]->key;
+      }
+    });
+    double f = mops(n, [&]{
+      while( litems.pop(&c) ) ;
+    });
+    printf("%-6s %10.2f %10.2f %10.2f  (sum %ld)\n", "LHash", a, s, f, sum);
+  }
+  return 0;
+}
@@ -0,0 +1,99 @@
+/*
+= NAME
+lift_bench  - Lift build and lca() over deep and wide trees
+
+= SYNOPSIS
+make bench [BENCH_OPT="nodes [max_threads [queries]]"]
+
+= DESCRIPTION
+Builds two trees by jjAggregate(tree, Dir, Dir):
+
+* wide: parent of node i is random in 0..i-1 (depth ~ log n)
+* deep: parent of node i is random in i-4..i-1 (depth ~ n/2.5)
+
+and shows the build time of jjLift with 1, 2, 4, ... max_threads threads
+(ns per node), then random lca() queries against climbing parent links
+(ns per query).  Naive lca on the deep tree is O(n) per query; it is
+measured with queries/1000 pairs.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#include "jj/tree.h"
+#include "lift_bench.b" /* include Part-B */
+
+class Dir : INHERIT_Dir {
+};
+
+class Org : INHERIT_Org {
+};
+
+jjAggregate (tree, Dir, Dir);
+jjLift      (lift, Org, Dir);
+tree_class  tree;
+lift_class  lift;
+
+template<class F>
+static double ns_per(long n, F f){
+  static long sink;
+  auto beg = std::chrono::steady_clock::now();
+  sink += f();
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - beg).count();
+  return sec * 1e9 / n;
+}
+
+static Dir* naive_lca(Dir* root, Dir* a, Dir* b){
+  int da = 0, db = 0;
+  for(Dir* p=a; p != root; p = tree.parent(p)) da++;
+  for(Dir* p=b; p != root; p = tree.parent(p)) db++;
+  for(; da > db; da--) a = tree.parent(a);
+  for(; db > da; db--) b = tree.parent(b);
+  while( a != b ){ a = tree.parent(a); b = tree.parent(b); }
+  return a;
+}
+
+int main(int argc, char **argv){
+  int   n     = argc > 1 ? atoi(argv[1]) : 2000000;
+  int   maxt  = argc > 2 ? atoi(argv[2]) : std::thread::hardware_concurrency();
+  int   q     = argc > 3 ? atoi(argv[3]) : 1000000;
+
+  std::mt19937      rnd(1);
+  std::vector<Dir>  wide(n), deep(n);
+
+  for(int i=1; i < n; i++) tree.add(&wide[rnd() % i], &wide[i]);
+  for(int i=1; i < n; i++) tree.add(&deep[i - 1 - (i > 4 ? rnd() % 4 : 0)], &deep[i]);
+
+  printf("# nodes=%d hardware_threads=%u  build (ns/node)\n",
+         n, std::thread::hardware_concurrency());
+  printf("%-10s %10s %10s\n", "threads", "wide", "deep");
+  for(int t=1; t <= (maxt > 0 ? maxt : 1); t *= 2){
+    Org   w, d;
+    double bw = ns_per(n, [&]{ lift.build(&w, &tree, &wide[0], t); return lift.num(&w); });
+    double bd = ns_per(n, [&]{ lift.build(&d, &tree, &deep[0], t); return lift.num(&d); });
+    printf("%-10d %10.2f %10.2f\n", t, bw, bd);
+  }
+
+  Org   w, d;
+  lift.build(&w, &tree, &wide[0]);
+  lift.build(&d, &tree, &deep[0]);
+
+  std::vector<int> pick(2 * q);
+  for(auto& k : pick) k = rnd() % n;
+  int qd = q / 1000 > 0 ? q / 1000 : 1;
+
+  printf("# lca queries=%d (deep naive: %d)  (ns/query)\n", q, qd);
+  printf("%-10s %10s %10s\n", "", "wide", "deep");
+  printf("%-10s %10.2f %10.2f\n", "naive",
+    ns_per(q,  [&]{ long s=0; for(int i=0; i < q;  i++) s += (long)naive_lca(&wide[0], &wide[pick[2*i]], &wide[pick[2*i+1]]); return s; }),
+    ns_per(qd, [&]{ long s=0; for(int i=0; i < qd; i++) s += (long)naive_lca(&deep[0], &deep[pick[2*i]], &deep[pick[2*i+1]]); return s; }));
+  printf("%-10s %10.2f %10.2f\n", "lift",
+    ns_per(q,  [&]{ long s=0; for(int i=0; i < q; i++) s += (long)lift.lca(&w, &wide[pick[2*i]], &wide[pick[2*i+1]]); return s; }),
+    ns_per(q,  [&]{ long s=0; for(int i=0; i < q; i++) s += (long)lift.lca(&d, &deep[pick[2*i]], &deep[pick[2*i+1]]); return s; }));
+
+  for(int i=n-1; i > 0; i--){ tree.del(&wide[i]); tree.del(&deep[i]); }
+  return 0;
+}
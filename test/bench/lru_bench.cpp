@@ -0,0 +1,107 @@
+/*
+= NAME
+lru_bench  - LRU pattern vs. std::unordered_map + std::list
+
+= SYNOPSIS
+make bench [BENCH_OPT="keys [capacity [ops]]"]
+
+= DESCRIPTION
+Looks up random keys (uniform, and Zipf s=1.0 over the same key space);
+a miss adds the entry, evicting the least recently used over capacity.
+Shows hit rate and million ops/sec of:
+
+* LRU:  jjLRU(lru, Store, Page); no allocation per op
+* std:  unordered_map<int, list::iterator> + list<Page*> kept by hand
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <list>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include "jj/lru.h"
+#include "lru_bench.b" /* include Part-B */
+
+class Store : INHERIT_Store {};
+
+class Page : INHERIT_Page {
+public:
+  int   no;
+};
+
+jjLRU (lru, Store, Page);
+lru_class lru;
+
+int  lru_class::hash_base(Entry *e)            { return ((Page*)e)->no & 0x7fffffff; }
+int  lru_class::cmp_base(Entry *e1, Entry *e2) { return ((Page*)e1)->no - ((Page*)e2)->no; }
+void lru_class::evict_base(Cache *, Entry *)   {}
+
+template<class F>
+static double mops(long n, F f){
+  auto beg = std::chrono::steady_clock::now();
+  f();
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - beg).count();
+  return n / sec / 1e6;
+}
+
+/* keys of Zipf(s=1) by inverse CDF */
+static std::vector<int> zipf(int keys, long n, std::mt19937& rnd){
+  std::vector<double> cdf(keys);
+  double s = 0;
+  for(int k=0; k < keys; k++) cdf[k] = (s += 1.0 / (k + 1));
+  std::uniform_real_distribution<double> u(0, s);
+  std::vector<int> v(n);
+  for(auto& x : v) x = std::lower_bound(cdf.begin(), cdf.end(), u(rnd)) - cdf.begin();
+  std::vector<int> perm(keys);        /* scatter hot keys */
+  for(int k=0; k < keys; k++) perm[k] = k;
+  std::shuffle(perm.begin(), perm.end(), rnd);
+  for(auto& x : v) x = perm[x];
+  return v;
+}
+
+int main(int argc, char **argv){
+  int   keys  = argc > 1 ? atoi(argv[1]) : 1000000;
+  int   cap   = argc > 2 ? atoi(argv[2]) : keys / 10;
+  long  ops   = argc > 3 ? atol(argv[3]) : 10000000;
+
+  std::mt19937        rnd(1);
+  std::vector<Page>   pages(keys);
+  for(int k=0; k < keys; k++) pages[k].no = k;
+
+  std::vector<int>    uni(ops);
+  for(auto& x : uni) x = rnd() % keys;
+  std::vector<int>    zip = zipf(keys, ops, rnd);
+
+  printf("# keys=%d capacity=%d ops=%ld\n", keys, cap, ops);
+  printf("%-10s %10s %10s %10s\n", "workload", "hit%", "LRU Mops", "std Mops");
+  for(auto* w : {&uni, &zip}){
+    Store s;
+    lru.capacity(&s, cap);
+    double a = mops(ops, [&]{
+      Page key;
+      for(int k : *w){
+        key.no = k;
+        if( lru.sel(&s, &key) == NULL ) lru.add(&s, &pages[k]);
+      } });
+    double hit = 100.0 * lru.hits(&s) / ops;
+    while( lru.evict(&s) );
+
+    std::list<Page*>  list;
+    std::unordered_map<int, std::list<Page*>::iterator> map;
+    double b = mops(ops, [&]{
+      for(int k : *w){
+        auto i = map.find(k);
+        if( i != map.end() ){
+          list.splice(list.end(), list, i->second);
+        }else{
+          if( (int)map.size() == cap ){ map.erase(list.front()->no); list.pop_front(); }
+          map[k] = list.insert(list.end(), &pages[k]);
+        }
+      } });
+    printf("%-10s %10.2f %10.2f %10.2f\n", w == &uni ? "uniform" : "zipf", hit, a, b);
+  }
+  return 0;
+}
@@ -0,0 +1,81 @@
+/*
+= NAME
+move_bench  - reparent children of wide parents
+
+= SYNOPSIS
+make bench [BENCH_OPT="max_children [moves]"]
+
+= DESCRIPTION
+Moves random children between two parents with fan-out 10, 100, ...
+max_children and shows ns per move by:
+
+* Collect:  del() (singly linked ring; scans siblings) and add()
+* move:     Aggregate::move() (doubly linked ring; O(1))
+
+then moves all children of one parent to another by Aggregate::move_all()
+(ns per child; the rings are spliced, `_parent` is fixed in one pass).
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "jj/pattern.h"
+#include "move_bench.b" /* include Part-B */
+
+class Dept : INHERIT_Dept {};
+class Emp  : INHERIT_Emp  {};
+
+jjAggregate (agg, Dept, Emp);
+jjCollect   (col, Dept, Emp);
+agg_class   agg;
+col_class   col;
+
+template<class F>
+static double ns_per(long n, F f){
+  auto beg = std::chrono::steady_clock::now();
+  f();
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - beg).count();
+  return sec * 1e9 / n;
+}
+
+int main(int argc, char **argv){
+  long  maxn  = argc > 1 ? atol(argv[1]) : 1000000;
+  long  moves = argc > 2 ? atol(argv[2]) : 10000;
+  std::mt19937  rnd(1);
+
+  printf("# moves=%ld  (ns/move)\n", moves);
+  printf("%-10s %12s %12s\n", "children", "Collect", "move");
+  for(long n=10; n <= maxn; n *= 10){
+    std::vector<Emp>  emps(n);
+    std::vector<long> pick(moves);
+    Dept  a, b;
+    for(auto& e : emps){ agg.add(&a, &e); col.add(&a, &e); }
+    for(auto& k : pick) k = rnd() % n;
+
+    std::vector<Dept*> in(n, &a);           /* Collect has no parent() */
+    double c = ns_per(moves, [&]{
+      for(long k : pick){
+        Emp*  e   = &emps[k];
+        Dept* to  = in[k] == &a ? &b : &a;
+        col.del(in[k], e); col.add(to, e); in[k] = to;
+      } });
+    double m = ns_per(moves, [&]{
+      for(long k : pick){
+        Emp* e = &emps[k];
+        agg.move(e, agg.parent(e) == &a ? &b : &a);
+      } });
+    printf("%-10ld %12.2f %12.2f\n", n, c, m);
+
+    for(long k=0; k < n; k++){ agg.del(&emps[k]); col.del(in[k], &emps[k]); }
+  }
+
+  std::vector<Emp> emps(maxn);
+  Dept  a, b;
+  for(auto& e : emps) agg.add(&a, &e);
+  printf("# move_all children=%ld  %.2f ns/child\n", maxn,
+         ns_per(maxn, [&]{ agg.move_all(&a, &b); }));
+  for(auto& e : emps) agg.del(&e);
+  return 0;
+}
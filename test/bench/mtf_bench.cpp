@@ -0,0 +1,112 @@
+/*
+= NAME
+mtf_bench  - Hash::sel() and sel_mtf() (move to front) by key skew
+
+= SYNOPSIS
+make bench [BENCH_OPT="keys [lookups]"]
+
+= DESCRIPTION
+Looks up 'lookups' (10M by default) string keys out of 'keys' (1M by
+default) in a Hash, keys drawn Zipf (s=1.1, 0.8) or uniform, by sel()
+and by sel_mtf().  Hot keys are scattered over the slots.
+
+Two hash functions show when the policy pays off:
+
+* mixed:    well mixed hash; chains are 1-2 long, so there is nothing
+            to gain
+* hash_str: jj::hash_str(); its low bits are weak for keys like
+            "key-00001234", so chains on the power-of-2 array are long
+
+Shows ns per lookup.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "jj/pattern.h"
+#include "mtf_bench.b" /* include Part-B */
+
+class Dict : INHERIT_Dict {};
+
+class Word : INHERIT_Word {
+public:
+  char  str[24];
+};
+
+jjHash (words, Dict, Word);
+words_class words;
+
+static bool g_mixed;
+
+int words_class::hash_base(Entry* e){
+  const char* s = ((Word*)e)->str;
+  if( !g_mixed ) return jj::hash_str(s);
+  unsigned long h = 0;
+  for(; *s; s++) h = (h ^ (unsigned char)*s) * 0x100000001b3UL;
+  return (int)((h ^ (h >> 29)) & 0x7fffffff);
+}
+
+int words_class::cmp_base(Entry* e1, Entry* e2){
+  return strcmp(((Word*)e1)->str, ((Word*)e2)->str);
+}
+
+/* rank r (0: hottest) is drawn with weight 1/(r+1)^s */
+static std::vector<int> zipf(long n, long m, double s, std::mt19937& rnd){
+  std::vector<double> cdf(n);
+  double sum = 0;
+  for(long r=0; r < n; r++) cdf[r] = (sum += 1.0 / pow(r + 1, s));
+  std::uniform_real_distribution<double> u(0, sum);
+  std::vector<int> v(m);
+  for(long k=0; k < m; k++) v[k] = std::lower_bound(cdf.begin(), cdf.end(), u(rnd)) - cdf.begin();
+  return v;
+}
+
+int main(int argc, char **argv){
+  long          n = argc > 1 ? atol(argv[1]) : 1000000;
+  long          m = argc > 2 ? atol(argv[2]) : 10000000;
+  std::mt19937  rnd(7);
+
+  std::vector<Word> w(n), key(n);
+  std::vector<int>  perm(n);            /* rank -> key; hot keys scattered */
+  for(long i=0; i < n; i++){
+    snprintf(w[i].str,   sizeof(w[i].str),   "key-%08ld", i);
+    snprintf(key[i].str, sizeof(key[i].str), "key-%08ld", i);
+    perm[i] = i;
+  }
+  std::shuffle(perm.begin(), perm.end(), rnd);
+
+  struct { const char* name; std::vector<int> ranks; } dist[3];
+  dist[0].name = "zipf 1.1";  dist[0].ranks = zipf(n, m, 1.1, rnd);
+  dist[1].name = "zipf 0.8";  dist[1].ranks = zipf(n, m, 0.8, rnd);
+  dist[2].name = "uniform";
+  for(long k=0; k < m; k++) dist[2].ranks.push_back(rnd() % n);
+
+  printf("keys: %ld, lookups: %ld  (ns/lookup)\n", n, m);
+  printf("%-9s %-9s %10s %10s\n", "hash", "keys", "sel", "sel_mtf");
+  for(int mixed=1; mixed >= 0; mixed--){
+    g_mixed = mixed;
+    for(auto& d : dist){
+      double ns[2];
+      for(int on=0; on < 2; on++){
+        Dict  dict;
+        long  found = 0;
+        for(long i=0; i < n; i++) words.add(&dict, &w[i]);
+        auto beg = std::chrono::steady_clock::now();
+        for(long k=0; k < m; k++)
+          found += (on ? words.sel_mtf(&dict, &key[perm[d.ranks[k]]])
+                       : words.sel(&dict, &key[perm[d.ranks[k]]])) != NULL;
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - beg).count();
+        ns[on] = sec * 1e9 / m;
+        if( found != m ) printf("error: found %ld\n", found);
+        for(long i=0; i < n; i++) words.del(&dict, &w[i]);
+      }
+      printf("%-9s %-9s %10.1f %10.1f\n", mixed ? "mixed" : "hash_str", d.name, ns[0], ns[1]);
+    }
+  }
+  return 0;
+}
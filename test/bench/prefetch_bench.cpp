@@ -0,0 +1,108 @@
+/*
+= NAME
+prefetch_bench  - Iter with prefetch() and fetch() on a ring over L2
+
+= SYNOPSIS
+make bench [BENCH_OPT="children [work]"]
+
+= DESCRIPTION
+Children (64 bytes each) are linked in random order so that every step
+of the ring is a cache miss.  Each child also points to a random cache
+line out of the ring (its payload).  Sums the payload with 'work' rounds
+of extra arithmetic per child by plain operator++, by prefetch(d) and by
+fetch() in 64 child batches, where the caller first prefetches every
+payload of the batch.  Times are ns per child.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "jj/pattern.h"
+#include "prefetch_bench.b" /* include Part-B */
+
+class Owner : INHERIT_Owner {};
+
+class Item  : INHERIT_Item {
+public:
+  long  val;
+  long* ext;
+  char  pad[32];
+  Item(long v) { val = v; ext = NULL; }
+};
+
+jjCollect (col, Owner, Item);
+col_class col;
+
+static int  g_work;
+
+static inline long work(Item* c){
+  long v = c->val + *c->ext;
+  for(int k=0; k < g_work; k++) v = v * 2862933555777941757L + 3037000493L;
+  return v;
+}
+
+template<class F>
+static double ns_per(long n, F f){
+  static long sink;
+  auto beg = std::chrono::steady_clock::now();
+  sink += f();
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - beg).count();
+  return sec * 1e9 / n;
+}
+
+int main(int argc, char **argv){
+  long  n = argc > 1 ? atol(argv[1]) : 2000000;
+  g_work  = argc > 2 ? atoi(argv[2]) : 8;
+
+  Owner               owner;
+  std::vector<Item*>  items;
+  std::vector<long>   ext(n * 8);
+  for(long k=0; k < n; k++) items.push_back(new Item(k));
+  std::shuffle(items.begin(), items.end(), std::mt19937(2));
+  for(long k=0; k < n; k++) items[k]->ext = &ext[k * 8];
+  std::shuffle(items.begin(), items.end(), std::mt19937(1));
+  for(auto it : items) col.add(&owner, it);
+
+  printf("# children=%ld (%ld MB) work=%d  (ns/child)\n", n, n * (long)sizeof(Item) >> 20, g_work);
+  printf("%-16s %10s\n", "mode", "ns");
+
+  auto plain = [&](int d){
+    return ns_per(n, [&]{
+      long s = 0; Item* c; col_class::Iter i;
+      i.prefetch(d);
+      i.start(&owner);
+      while( (c = ++i) ) s += work(c);
+      return s; });
+  };
+  printf("%-16s %10.2f\n", "operator++", plain(0));
+  for(int d : {2, 4, 8, 16}){
+    char name[32];
+    sprintf(name, "prefetch(%d)", d);
+    printf("%-16s %10.2f\n", name, plain(d));
+  }
+  printf("%-16s %10.2f\n", "fetch(64)", ns_per(n, [&]{
+    long s = 0; Item* buf[64]; int m; col_class::Iter i(&owner);
+    while( (m = i.fetch(buf, 64)) > 0 )
+      for(int k=0; k < m; k++) s += work(buf[k]);
+    return s; }));
+  printf("%-16s %10.2f\n", "fetch(64)+ext", ns_per(n, [&]{
+    long s = 0; Item* buf[64]; int m; col_class::Iter i(&owner);
+    while( (m = i.fetch(buf, 64)) > 0 ){
+      for(int k=0; k < m; k++) __builtin_prefetch(buf[k]->ext);
+      for(int k=0; k < m; k++) s += work(buf[k]);
+    }
+    return s; }));
+  printf("%-16s %10.2f\n", "fetch+ext+pf(8)", ns_per(n, [&]{
+    long s = 0; Item* buf[64]; int m; col_class::Iter i;
+    i.prefetch(8);
+    i.start(&owner);
+    while( (m = i.fetch(buf, 64)) > 0 ){
+      for(int k=0; k < m; k++) __builtin_prefetch(buf[k]->ext);
+      for(int k=0; k < m; k++) s += work(buf[k]);
+    }
+    return s; }));
+  return 0;
+}
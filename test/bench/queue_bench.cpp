@@ -0,0 +1,80 @@
+/*
+= NAME
+queue_bench  - Queue vs. mutex-wrapped Collect handoff throughput
+
+= SYNOPSIS
+make bench [BENCH_OPT="items_per_producer [max_producers]"]
+
+= DESCRIPTION
+N producers hand preallocated items to one consumer thread.  The consumer
+takes items one by one: Queue::get() for Queue, and child() + del() under
+the same mutex as add() for Collect.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "jj/pattern.h"
+#include "jj/queue.h"
+#include "queue_bench.b" /* include Part-B */
+
+class Worker  : INHERIT_Worker  {};
+class Job     : INHERIT_Job     {};
+
+jjCollect (locked,    Worker, Job);
+jjQueue   (lockfree,  Worker, Job);
+
+locked_class    locked;
+lockfree_class  lockfree;
+std::mutex      locked_mutex;
+
+template<class Add, class Get>
+static double run(int nproducer, long nitem, Add add, Get get){
+  std::vector<Job>          jobs(nproducer * nitem);
+  std::vector<std::thread>  producers;
+  long                      total = nproducer * nitem, got = 0;
+
+  auto beg = std::chrono::steady_clock::now();
+  for(int p=0; p < nproducer; p++){
+    producers.emplace_back([&, p]{
+      for(long i=0; i < nitem; i++) add(&jobs[p * nitem + i]);
+    });
+  }
+  while( got < total ){
+    if( get() ) got++;
+    else        std::this_thread::yield();
+  }
+  for(auto& t : producers) t.join();
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - beg).count();
+  return total / sec / 1e6;
+}
+
+int main(int argc, char **argv){
+  long  nitem         = argc > 1 ? atol(argv[1]) : 1000000;
+  int   max_producers = argc > 2 ? atoi(argv[2]) : 8;
+  Worker  w1, w2;
+
+  printf("# items/producer=%ld  (Mitems/sec)\n", nitem);
+  printf("%-10s %14s %14s\n", "producers", "Collect+mutex", "Queue");
+  for(int n=1; n <= max_producers; n *= 2){
+    double a = run(n, nitem,
+      [&](Job* j){
+        std::lock_guard<std::mutex> lock(locked_mutex);
+        locked.add(&w1, j);
+      },
+      [&]() -> Job* {
+        std::lock_guard<std::mutex> lock(locked_mutex);
+        Job* j = locked.child(&w1);
+        if( j ) locked.del(&w1, j);
+        return j;
+      });
+    double b = run(n, nitem,
+      [&](Job* j){ lockfree.add(&w2, j); },
+      [&]() -> Job* { return lockfree.get(&w2); });
+    printf("%-10d %14.2f %14.2f\n", n, a, b);
+  }
+  return 0;
+}
@@ -0,0 +1,93 @@
+/*
+= NAME
+radix_bench  - Radix vs. Hash by string key
+
+= SYNOPSIS
+make bench [BENCH_OPT="entries [prefix_queries]"]
+
+= DESCRIPTION
+Adds entries keyed "atom-%08d" of random numbers to jjRadix and to jjHash
+(by jj::hash_str()), then shows:
+
+* add:    ns per entry
+* sel:    ns per point lookup of every key
+* prefix: ns per query of the entries starting with "atom-NNNNN" (about
+          1000 of 1M entries); Hash has to scan all entries by Iter.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "jj/pattern.h"
+#include "jj/radix.h"
+#include "radix_bench.b" /* include Part-B */
+
+class App : INHERIT_App {};
+
+class Atom : INHERIT_Atom {
+public:
+  char  name[16];
+};
+
+jjRadix (radix, App, Atom);
+jjHash  (hash,  App, Atom);
+radix_class radix;
+hash_class  hash;
+
+const char* radix_class::key_base(Entry *e)     { return ((Atom*)e)->name; }
+int hash_class::hash_base(Entry *e)             { return jj::hash_str(((Atom*)e)->name); }
+int hash_class::cmp_base(Entry *e1, Entry *e2)  { return strcmp(((Atom*)e1)->name, ((Atom*)e2)->name); }
+
+static long g_sink;
+
+template<class F>
+static double ns_per(long n, F f){
+  auto beg = std::chrono::steady_clock::now();
+  g_sink += f();
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - beg).count();
+  return sec * 1e9 / n;
+}
+
+int main(int argc, char **argv){
+  long  n   = argc > 1 ? atol(argv[1]) : 1000000;
+  int   q   = argc > 2 ? atoi(argv[2]) : 100;
+
+  std::mt19937        rnd(1);
+  std::vector<Atom>   atoms(n);
+  for(auto& a : atoms) snprintf(a.name, sizeof(a.name), "atom-%08u", (unsigned)(rnd() % 100000000));
+
+  std::vector<std::vector<char>> prefix(q);
+  for(auto& p : prefix){
+    p.resize(16);
+    snprintf(p.data(), 16, "atom-%05u", (unsigned)(rnd() % 100000));
+  }
+
+  App r, h;
+  printf("# entries=%ld prefix_queries=%d\n", n, q);
+  printf("%-10s %12s %12s %12s\n", "", "add", "sel", "prefix");
+
+  double a = ns_per(n, [&]{ for(auto& x : atoms) radix.add(&r, &x); return radix.num(&r); });
+  double b = ns_per(n, [&]{ long s=0; for(auto& x : atoms) s += radix.sel(&r, x.name) != NULL; return s; });
+  double c = ns_per(q, [&]{
+    long s = 0;
+    for(auto& p : prefix) for(Atom* x : radix.range(&r, p.data())) s += x->name[12];
+    return s; });
+  printf("%-10s %12.2f %12.2f %12.2f\n", "Radix", a, b, c);
+
+  a = ns_per(n, [&]{ for(auto& x : atoms) hash.add(&h, &x); return hash.num(&h); });
+  b = ns_per(n, [&]{ long s=0; for(auto& x : atoms) s += hash.sel(&h, &x) != NULL; return s; });
+  c = ns_per(q, [&]{
+    long s = 0;
+    for(auto& p : prefix){
+      size_t len = strlen(p.data());
+      for(Atom* x : hash.range(&h)) if( strncmp(x->name, p.data(), len) == 0 ) s += x->name[12];
+    }
+    return s; });
+  printf("%-10s %12.2f %12.2f %12.2f\n", "Hash", a, b, c);
+
+  for(auto& x : atoms){ radix.del(&r, &x); hash.del(&h, &x); }
+  return g_sink == 42;
+}
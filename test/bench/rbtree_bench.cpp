@@ -0,0 +1,100 @@
+/*
+= NAME
+rbtree_bench  - RBTree vs. std::set of pointers
+
+= SYNOPSIS
+make bench [BENCH_OPT="entries [scan_length]"]
+
+= DESCRIPTION
+Inserts entries of random keys, finds each once, scans scan_length
+entries from lower_bound() of random keys, and erases all, by:
+
+* RBTree:   jjRBTree(tree, Calendar, Event)
+* std::set: std::set<Event*, by key> (a node is allocated per insert)
+
+Times are ns per operation (scan: per visited entry).
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <random>
+#include <set>
+#include <vector>
+#include "jj/rbtree.h"
+#include "rbtree_bench.b" /* include Part-B */
+
+class Calendar : INHERIT_Calendar {};
+
+class Event : INHERIT_Event {
+public:
+  long  time;
+  Event(long t=0) { time = t; }
+};
+
+jjRBTree    (tree, Calendar, Event);
+tree_class  tree;
+
+int tree_class::cmp_base(Entry *e1, Entry *e2){
+  long d = ((Event*)e1)->time - ((Event*)e2)->time;
+  return d < 0 ? -1 : d > 0;
+}
+
+struct ByTime {
+  bool operator()(const Event* a, const Event* b) const { return a->time < b->time; }
+};
+
+static long g_sink;
+
+template<class F>
+static double ns_per(long n, F f){
+  auto beg = std::chrono::steady_clock::now();
+  g_sink += f();
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - beg).count();
+  return sec * 1e9 / n;
+}
+
+int main(int argc, char **argv){
+  long  n     = argc > 1 ? atol(argv[1]) : 1000000;
+  int   scan  = argc > 2 ? atoi(argv[2]) : 100;
+  long  nscan = n / scan;
+
+  std::mt19937_64     rnd(1);
+  std::vector<Event>  ev(n);
+  std::vector<Event>  key(nscan);
+  for(auto& e : ev)  e.time = rnd();
+  for(auto& k : key) k.time = rnd();
+
+  Calendar                cal;
+  std::set<Event*, ByTime> set;
+
+  printf("# entries=%ld scan_length=%d  (ns/op)\n", n, scan);
+  printf("%-10s %10s %10s %10s %10s\n", "", "insert", "find", "scan", "erase");
+
+  double a = ns_per(n, [&]{ for(auto& e : ev) tree.add(&cal, &e); return tree.num(&cal); });
+  double b = ns_per(n, [&]{ long s=0; for(auto& e : ev) s += tree.sel(&cal, &e) != NULL; return s; });
+  double c = ns_per(nscan * scan, [&]{
+    long s = 0;
+    for(auto& k : key){
+      tree_class::Iter i;
+      i.start(tree.lower_bound(&cal, &k));
+      Event* e;
+      for(int j=0; j < scan && (e = ++i); j++) s += e->time;
+    }
+    return s; });
+  double d = ns_per(n, [&]{ for(auto& e : ev) tree.del(&cal, &e); return tree.num(&cal); });
+  printf("%-10s %10.2f %10.2f %10.2f %10.2f\n", "RBTree", a, b, c, d);
+
+  a = ns_per(n, [&]{ for(auto& e : ev) set.insert(&e); return (long)set.size(); });
+  b = ns_per(n, [&]{ long s=0; for(auto& e : ev) s += set.find(&e) != set.end(); return s; });
+  c = ns_per(nscan * scan, [&]{
+    long s = 0;
+    for(auto& k : key){
+      auto i = set.lower_bound(&k);
+      for(int j=0; j < scan && i != set.end(); j++, ++i) s += (*i)->time;
+    }
+    return s; });
+  d = ns_per(n, [&]{ for(auto& e : ev) set.erase(&e); return (long)set.size(); });
+  printf("%-10s %10.2f %10.2f %10.2f %10.2f\n", "std::set", a, b, c, d);
+  return g_sink == 42;
+}
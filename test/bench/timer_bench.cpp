@@ -0,0 +1,101 @@
+/*
+= NAME
+timer_bench  - TimerWheel pattern vs. std::set ordered by deadline
+
+= SYNOPSIS
+make bench [BENCH_OPT="timers [horizon]"]
+
+= DESCRIPTION
+Schedules timers (10M by default) at random deadlines within horizon
+ticks (1M by default), cancels every other one, then advances the time
+in 1000 steps up to horizon taking expired timers in batches of 1024.
+Shows million ops/sec of each phase for:
+
+* wheel: jjTimerWheel(timeouts, Loop, Conn); O(1) schedule and cancel
+* set:   std::set<pair<deadline, Conn*>>; O(log n) each
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+#include "jj/timer.h"
+#include "timer_bench.b" /* include Part-B */
+
+class Loop : INHERIT_Loop {};
+
+class Conn : INHERIT_Conn {
+public:
+  unsigned long deadline;
+};
+
+jjTimerWheel (timeouts, Loop, Conn);
+timeouts_class timeouts;
+
+template<class F>
+static double mops(long n, F f){
+  auto beg = std::chrono::steady_clock::now();
+  f();
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - beg).count();
+  return n / sec / 1e6;
+}
+
+int main(int argc, char** argv){
+  long            n       = argc > 1 ? atol(argv[1]) : 10000000;
+  unsigned long   horizon = argc > 2 ? atol(argv[2]) : 1000000;
+  const int       steps   = 1000;
+  std::mt19937_64 rnd(1);
+  std::vector<Conn> c(n);
+  long            fired;
+
+  for(long i=0; i < n; i++) c[i].deadline = 1 + rnd() % horizon;
+
+  printf("timers: %ld, horizon: %lu ticks\n", n, horizon);
+  printf("%-8s %12s %12s %12s\n", "", "schedule", "cancel", "expire");
+
+/* wheel */
+  {
+    Loop  l;
+    Conn* buf[1024];
+    double s = mops(n, [&]{
+      for(long i=0; i < n; i++) timeouts.schedule(&l, &c[i], c[i].deadline);
+    });
+    double d = mops(n / 2, [&]{
+      for(long i=0; i < n; i += 2) timeouts.cancel(&l, &c[i]);
+    });
+    fired = 0;
+    double e = mops(n - n / 2, [&]{
+      for(int k=1; k <= steps; k++){
+        int m;
+        while( (m = timeouts.advance(&l, horizon * k / steps, buf, 1024)) > 0 ) fired += m;
+      }
+    });
+    printf("%-8s %12.2f %12.2f %12.2f  (fired %ld)\n", "wheel", s, d, e, fired);
+  }
+
+/* std::set */
+  {
+    std::set<std::pair<unsigned long, Conn*> > q;
+    double s = mops(n, [&]{
+      for(long i=0; i < n; i++) q.insert(std::make_pair(c[i].deadline, &c[i]));
+    });
+    double d = mops(n / 2, [&]{
+      for(long i=0; i < n; i += 2) q.erase(std::make_pair(c[i].deadline, &c[i]));
+    });
+    fired = 0;
+    double e = mops(n - n / 2, [&]{
+      for(int k=1; k <= steps; k++){
+        unsigned long now = horizon * k / steps;
+        while( !q.empty() && q.begin()->first <= now ){
+          q.erase(q.begin());
+          fired++;
+        }
+      }
+    });
+    printf("%-8s %12.2f %12.2f %12.2f  (fired %ld)\n", "set", s, d, e, fired);
+  }
+  return 0;
+}
@@ -0,0 +1,123 @@
+/*
+= NAME
+unionfind_bench  - UnionFind pattern vs. index arrays beside the objects
+
+= SYNOPSIS
+make bench [BENCH_OPT="nodes [edges]"]
+
+= DESCRIPTION
+Streams random edges (100M by default) over nodes (10M by default) and
+unites their ends as each edge arrives, then walks the members of every
+set.  Shows million edges/sec and number of sets of:
+
+* UnionFind: jjUnionFind(comps, Net, Host); parent, size and ring in Host
+* arrays:    Host has an id; parent[] and size[] are std::vector<int>
+             indexed by it (what had to be written before); members of a
+             set by grouping ids by root
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <vector>
+#include "jj/unionfind.h"
+#include "unionfind_bench.b" /* include Part-B */
+
+class Net  : INHERIT_Net {};
+
+class Host : INHERIT_Host {
+public:
+  int   id;
+};
+
+jjUnionFind (comps, Net, Host);
+comps_class comps;
+
+template<class F>
+static double mops(long n, F f){
+  auto beg = std::chrono::steady_clock::now();
+  f();
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - beg).count();
+  return n / sec / 1e6;
+}
+
+/* edge stream; cheap enough not to hide the unions */
+struct Stream {
+  unsigned long s;
+  Stream(){ s = 88172645463325252UL; }
+  unsigned long operator()(){ s ^= s << 13; s ^= s >> 7; s ^= s << 17; return s; }
+};
+
+static int root(std::vector<int>& parent, int i){
+  while( parent[i] != i ){
+    parent[i] = parent[parent[i]];
+    i = parent[i];
+  }
+  return i;
+}
+
+int main(int argc, char** argv){
+  long  n = argc > 1 ? atol(argv[1]) : 10000000;
+  long  m = argc > 2 ? atol(argv[2]) : 100000000;
+  long  sum;
+
+  printf("nodes: %ld, edges: %ld\n", n, m);
+  printf("%-10s %10s %10s %10s\n", "", "unite", "members", "sets");
+
+/* UnionFind */
+  {
+    std::vector<Host> h(n);
+    Net               net;
+    Stream            rnd;
+    for(long i=0; i < n; i++) comps.add(&net, &h[i]);
+    double u = mops(m, [&]{
+      for(long k=0; k < m; k++){
+        unsigned long r = rnd();
+        comps.unite(&net, &h[(r >> 32) % n], &h[(r & 0xffffffff) % n]);
+      }
+    });
+    sum = 0;
+    double w = mops(n, [&]{
+      for(long i=0; i < n; i++){
+        if( comps.find(&h[i]) != &h[i] ) continue;    /* once per set */
+        comps_class::Iter it(&h[i]);
+        for(Host* p; (p = ++it); ) sum++;
+      }
+    });
+    printf("%-10s %10.2f %10.2f %10ld  (members %ld)\n", "UnionFind", u, w, comps.sets(&net), sum);
+  }
+
+/* index arrays */
+  {
+    std::vector<Host> h(n);
+    std::vector<int>  parent(n), size(n, 1);
+    Stream            rnd;
+    long              sets = n;
+    for(long i=0; i < n; i++){ h[i].id = i; parent[i] = i; }
+    double u = mops(m, [&]{
+      for(long k=0; k < m; k++){
+        unsigned long r = rnd();
+        int a = root(parent, h[(r >> 32) % n].id);
+        int b = root(parent, h[(r & 0xffffffff) % n].id);
+        if( a == b ) continue;
+        if( size[a] < size[b] ){ int t = a; a = b; b = t; }
+        parent[b] = a;
+        size[a]  += size[b];
+        sets--;
+      }
+    });
+    sum = 0;
+    double w = mops(n, [&]{
+      std::vector<int> head(n, -1), next(n);     /* group ids by root */
+      for(long i=0; i < n; i++){
+        int r   = root(parent, i);
+        next[i] = head[r];
+        head[r] = i;
+      }
+      for(long i=0; i < n; i++)
+        for(int j = head[i]; j >= 0; j = next[j]) sum++;
+    });
+    printf("%-10s %10.2f %10.2f %10ld  (members %ld)\n", "arrays", u, w, sets, sum);
+  }
+  return 0;
+}
@@ -8,6 +8,8 @@ DESCRIPTION
 
 #include <stdio.h>
 #include <string.h>
+#include <algorithm>
+#include <vector>
 #include "gtest/gtest.h"
 #include "jj/pattern.h"
 #include "01_test.b" /* include Part-B */
@@ -69,6 +71,30 @@ TEST(Simplest, single_aggregate){
   ASSERT_EQ(NULL, b);
 }
 
+TEST(Simplest, aggregate_range){
+  Publisher p1("P1"), p2("P2");
+  Book      oosc("1-123", "Object Oriented S/W Construction"),
+            itpl("2-111", "Introduction to the Theory of Programming Lanugages");
+
+  ASSERT_TRUE(books.begin(&p1) == books.end(&p1));
+  books.add(&p1, &oosc);
+  books.add(&p1, &itpl);
+
+  std::vector<Book*> v;
+  for(Book* b : books.range(&p1)) v.push_back(b);
+  ASSERT_EQ(2u,     v.size());
+  ASSERT_EQ(&oosc,  v[0]);
+  ASSERT_EQ(&itpl,  v[1]);
+
+  books_class::iterator it = std::find_if(books.begin(&p1), books.end(&p1),
+      [](Book* b){ return strcmp(b->isbn, "2-111")==0; });
+  ASSERT_EQ(&itpl, *it);
+  ASSERT_EQ(2, std::distance(books.begin(&p1), books.end(&p1)));
+
+  books.del(&oosc);
+  books.del(&itpl);
+}
+
 int main(int argc, char **argv){
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
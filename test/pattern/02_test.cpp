@@ -8,6 +8,7 @@ DESCRIPTION
 
 #include <stdio.h>
 #include <string.h>
+#include <string>
 #include "gtest/gtest.h"
 #include "jj/pattern.h"
 #include "02_test.b" /* include Part-B */
@@ -73,6 +74,151 @@ TEST(Tree, aggregate_as_tree){
   child = ++i;  ASSERT_EQ(NULL,   child);
 }
 
+TEST(Tree, walk_whole_tree){
+  Node  root("root"),
+        n1("n1"),                                   n2("n2"),
+        n1a("n1a"),     n1b("n1b"),                 n2a("n2a"),   n2b("n2b"),
+                        n1bA("n1bA"), n1bB("n1bB"), n2aA("n2aA");
+
+  tree.add(&root, &n1);
+  tree.add(&root, &n2);
+  tree.add(&n1,   &n1a);    tree.add(&n1,   &n1b);
+  tree.add(&n2,   &n2a);    tree.add(&n2,   &n2b);
+  tree.add(&n1b,  &n1bA);   tree.add(&n1b,  &n1bB);
+  tree.add(&n2a,  &n2aA);
+
+  std::string s;
+  Node*       n;
+
+// pre-order with depth
+  tree_class::PreIter pre(&tree, &root);
+  while( (n = ++pre) ){ s += n->name; s += '0' + pre.depth(); s += ' '; }
+  ASSERT_EQ("root0 n11 n1a2 n1b2 n1bA3 n1bB3 n21 n2a2 n2aA3 n2b2 ", s);
+
+// subtree only
+  s = "";
+  pre.start(&tree, &n1);
+  while( (n = ++pre) ){ s += n->name; s += ' '; }
+  ASSERT_EQ("n1 n1a n1b n1bA n1bB ", s);
+
+// post-order
+  s = "";
+  tree_class::PostIter post(&tree, &root);
+  while( (n = ++post) ){ s += n->name; s += '0' + post.depth(); s += ' '; }
+  ASSERT_EQ("n1a2 n1bA3 n1bB3 n1b2 n11 n2aA3 n2a2 n2b2 n21 root0 ", s);
+
+// level-order
+  s = "";
+  tree_class::LevelIter level(&tree, &root);
+  while( (n = ++level) ){ s += n->name; s += '0' + level.depth(); s += ' '; }
+  ASSERT_EQ("root0 n11 n21 n1a2 n1b2 n2a2 n2b2 n1bA3 n1bB3 n2aA3 ", s);
+
+// leaf
+  pre.start(&tree, &n2aA);
+  ASSERT_EQ(&n2aA, ++pre);
+  ASSERT_EQ(NULL,  ++pre);
+
+// post-order allows del() of the got node
+  post.start(&tree, &root);
+  while( (n = ++post) ){
+    if( n != &root ) tree.del(n);
+  }
+  ASSERT_EQ(0, tree.num(&root));
+  ASSERT_EQ(0, tree.num(&n1b));
+}
+
+TEST(Tree, walk_deep_chain){
+  const int   n = 1000000;
+  Node**      nodes = new Node*[n];
+
+  for(int i=0; i < n; i++){
+    nodes[i] = new Node("");
+    if( i ) tree.add(nodes[i-1], nodes[i]);
+  }
+
+  tree_class::PreIter   pre(&tree, nodes[0]);
+  tree_class::PostIter  post(&tree, nodes[0]);
+  tree_class::LevelIter level(&tree, nodes[0]);
+  for(int i=0; i < n; i++){
+    ASSERT_EQ(nodes[i],       ++pre);
+    ASSERT_EQ(nodes[n-1-i],   ++post);
+    ASSERT_EQ(nodes[i],       ++level);
+  }
+  ASSERT_EQ(n-1, pre.depth());
+  ASSERT_EQ(NULL, ++pre);
+  ASSERT_EQ(NULL, ++post);
+  ASSERT_EQ(NULL, ++level);
+
+  post.start(&tree, nodes[0]);
+  for(Node* c; (c = ++post); ){
+    if( c != nodes[0] ) tree.del(c);
+  }
+  for(int i=0; i < n; i++) delete nodes[i];
+  delete[] nodes;
+}
+
+static std::string names(Node* p){
+  std::string s;
+  for(Node* c : tree.range(p)) s += std::string(c->name) + " ";
+  return s;
+}
+
+TEST(Tree, move_subtree){
+  Node  root("root"),
+        n1("n1"),               n2("n2"),
+        n1a("n1a"), n1b("n1b"), n1c("n1c"),   n2a("n2a"),
+        n1bA("n1bA");
+
+  tree.add(&root, &n1);   tree.add(&root, &n2);
+  tree.add(&n1,   &n1a);  tree.add(&n1,   &n1b);  tree.add(&n1, &n1c);
+  tree.add(&n2,   &n2a);  tree.add(&n1b,  &n1bA);
+
+// del() in the middle of ring keeps the rest in order
+  tree.del(&n1b);
+  ASSERT_EQ("n1a n1c ", names(&n1));
+  ASSERT_EQ(NULL, tree.parent(&n1b));
+  tree.del(&n1b);                         /* no-op */
+  tree.add(&n1, &n1b);
+  ASSERT_EQ("n1a n1c n1b ", names(&n1));
+
+// move() with its subtree; version changes
+  unsigned long v = tree.version();
+  tree.move(&n1b, &n2);
+  ASSERT_NE(v, tree.version());
+  ASSERT_EQ("n1a n1c ", names(&n1));
+  ASSERT_EQ("n2a n1b ", names(&n2));
+  ASSERT_EQ(&n2, tree.parent(&n1b));
+  ASSERT_EQ(&n1b, tree.parent(&n1bA));
+  ASSERT_EQ(2, tree.num(&n1));
+  ASSERT_EQ(2, tree.num(&n2));
+
+  tree.move(&n2a, &n2);                   /* to the last of the same parent */
+  ASSERT_EQ("n1b n2a ", names(&n2));
+
+// move_all() splices children of n1 after those of n2
+  ASSERT_EQ(2, tree.move_all(&n1, &n2));
+  ASSERT_EQ("", names(&n1));
+  ASSERT_EQ(NULL, tree.child(&n1));
+  ASSERT_EQ("n1b n2a n1a n1c ", names(&n2));
+  ASSERT_EQ(4, tree.num(&n2));
+  for(Node* c : tree.range(&n2)) ASSERT_EQ(&n2, tree.parent(c));
+  ASSERT_EQ(0, tree.move_all(&n1, &n2));
+
+// ... and into an empty parent
+  ASSERT_EQ(4, tree.move_all(&n2, &n1));
+  ASSERT_EQ("n1b n2a n1a n1c ", names(&n1));
+  ASSERT_EQ(&n1c, tree.last(&n1));
+  ASSERT_EQ(&n1, tree.parent(&n2a));
+
+  tree_class::PreIter i(&tree, &root);
+  std::string s;
+  for(Node* n; (n = ++i); ) s += std::string(n->name) + " ";
+  ASSERT_EQ("root n1 n1b n1bA n2a n1a n1c n2 ", s);
+
+  tree.del(&n1bA);  tree.del(&n1b);   tree.del(&n2a);
+  tree.del(&n1a);   tree.del(&n1c);   tree.del(&n2);    tree.del(&n1);
+}
+
 int main(int argc, char **argv){
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
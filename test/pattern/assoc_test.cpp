@@ -0,0 +1,164 @@
+/*
+NAME
+  assoc_test  - many-to-many association pattern test
+*/
+
+#include <stdio.h>
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+#include "gtest/gtest.h"
+#include "jj/assoc.h"
+#include "assoc_test.b" /* include Part-B */
+
+// define models
+class User : INHERIT_User {
+public:
+  int   no;
+  User(int n=0) { no=n; }
+};
+
+class Group : INHERIT_Group {
+public:
+  int   no;
+  Group(int n=0) { no=n; }
+};
+
+// define pattern between models
+jjAssoc (members, User,  Group);
+jjAssoc (follows, User,  User);       /* same class on both sides */
+members_class members;
+follows_class follows;
+
+static std::vector<int> groups(User* u){
+  std::vector<int> v;
+  members_class::Rights i(u);
+  for(Group* g; (g = ++i); ) v.push_back(g->no);
+  std::sort(v.begin(), v.end());
+  return v;
+}
+
+static std::vector<int> users(Group* g){
+  std::vector<int> v;
+  members_class::Lefts i(g);
+  for(User* u; (u = ++i); ) v.push_back(u->no);
+  std::sort(v.begin(), v.end());
+  return v;
+}
+
+/*----------------------------------------------------------------------------
+Test Section
+----------------------------------------------------------------------------*/
+TEST(Assoc, basic){
+  User  alice(1), bob(2), carol(3);
+  Group admin(10), staff(20);
+
+  members.link(&alice, &admin);
+  jj::Assoc::Link* as = members.link(&alice, &staff);
+  members.link(&bob,   &staff);
+  members.link(&carol, &staff);
+  ASSERT_EQ(4, members.num());
+  ASSERT_EQ(2, members.num_left(&alice));
+  ASSERT_EQ(3, members.num_right(&staff));
+  ASSERT_EQ((std::vector<int>{10, 20}), groups(&alice));
+  ASSERT_EQ((std::vector<int>{1, 2, 3}), users(&staff));
+
+// sel, left, right
+  ASSERT_EQ(as, members.sel(&alice, &staff));
+  ASSERT_EQ(NULL, members.sel(&bob, &admin));
+  ASSERT_EQ(&alice, members.left(as));
+  ASSERT_EQ(&staff, members.right(as));
+
+// unlink from either side
+  members.unlink(as);
+  members.unlink(as);                       /* ignored: already unlinked */
+  ASSERT_EQ((std::vector<int>{10}), groups(&alice));
+  ASSERT_EQ((std::vector<int>{2, 3}), users(&staff));
+
+// bulk
+  ASSERT_EQ(2, members.unlink_right(&staff));
+  ASSERT_EQ(0, members.num_left(&bob));
+  ASSERT_EQ(1, members.unlink_left(&alice));
+  ASSERT_EQ(0, members.num());
+  ASSERT_EQ((std::vector<int>{}), users(&admin));
+}
+
+TEST(Assoc, unlink_while_iterating){
+  User  u(1);
+  Group g[5] = {Group(0), Group(1), Group(2), Group(3), Group(4)};
+
+  for(int i=0; i < 5; i++) members.link(&u, &g[i]);
+  members_class::Rights i(&u);
+  for(Group* p; (p = ++i); )
+    if( p->no % 2 == 0 ) members.unlink(i.link());
+  ASSERT_EQ((std::vector<int>{1, 3}), groups(&u));
+  members.unlink_left(&u);
+}
+
+TEST(Assoc, same_class){
+  User  a(1), b(2), c(3);
+
+  follows.link(&a, &b);
+  follows.link(&a, &c);
+  follows.link(&b, &a);
+  ASSERT_EQ(2, follows.num_left(&a));       /* a follows 2 */
+  ASSERT_EQ(1, follows.num_right(&a));      /* a is followed by 1 */
+  follows_class::Lefts i(&c);
+  ASSERT_EQ(&a, ++i);
+  ASSERT_EQ(NULL, ++i);
+  ASSERT_EQ(1, follows.unlink_right(&a));
+  ASSERT_EQ(2, follows.unlink_left(&a));
+  ASSERT_EQ(0, follows.num());
+}
+
+/* random link / unlink against std::multiset of pairs */
+TEST(Assoc, random){
+  const int                     NU = 200, NG = 50;
+  std::vector<User>             u(NU);
+  std::vector<Group>            g(NG);
+  std::multiset<std::pair<int, int> >   ref;
+  std::vector<jj::Assoc::Link*> links;
+  std::mt19937                  rnd(3);
+
+  for(int i=0; i < NU; i++) u[i].no = i;
+  for(int i=0; i < NG; i++) g[i].no = i;
+
+  for(int round=0; round < 50000; round++){
+    int r = rnd() % 10;
+    if( r < 6 ){
+      int a = rnd() % NU, b = rnd() % NG;
+      links.push_back(members.link(&u[a], &g[b]));
+      ref.insert(std::make_pair(a, b));
+    }else if( r < 9 ){
+      if( links.empty() ) continue;
+      int               k = rnd() % links.size();
+      jj::Assoc::Link*  l = links[k];
+      if( members.left(l) ){
+        ref.erase(ref.find(std::make_pair(members.left(l)->no, members.right(l)->no)));
+        members.unlink(l);
+      }
+      links[k] = links.back();
+      links.pop_back();
+    }else{
+      int a = rnd() % NU;
+      int n = 0;
+      for(auto it = ref.begin(); it != ref.end(); )
+        if( it->first == a ){ it = ref.erase(it); n++; }else ++it;
+      ASSERT_EQ(n, members.unlink_left(&u[a]));
+      /* drop the links gone back to the pool before link() reuses them */
+      links.erase(std::remove_if(links.begin(), links.end(),
+        [&](jj::Assoc::Link* l){ return members.left(l) == NULL; }), links.end());
+    }
+    ASSERT_EQ((long)ref.size(), members.num());
+  }
+
+  for(int b=0; b < NG; b++){
+    std::vector<int> expect;
+    for(auto& p : ref) if( p.second == b ) expect.push_back(p.first);
+    ASSERT_EQ(expect, users(&g[b]));
+    ASSERT_EQ((int)expect.size(), members.num_right(&g[b]));
+  }
+  for(int a=0; a < NU; a++) members.unlink_left(&u[a]);
+  ASSERT_EQ(0, members.num());
+}
@@ -0,0 +1,162 @@
+/*
+NAME
+  chash_test  - CHash (concurrent Hash) pattern test
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "jj/pattern.h"
+#include "jj/chash.h"
+#include "chash_test.b" /* include Part-B */
+
+// define models
+class App : INHERIT_App {
+};
+
+class Atom : INHERIT_Atom {
+  char *_str;
+public:
+  Atom(const char *str);
+ ~Atom();
+
+  char* str(){ return _str; }
+};
+
+// define pattern between models
+jjCHash(atom_hash, App, Atom);
+
+int atom_hash_class::hash_base(Entry *e){
+  return jj::hash_str(((Atom*)e)->str());
+}
+
+int atom_hash_class::cmp_base(Entry *e1, Entry *e2){
+  return strcmp(((Atom*)e1)->str(), ((Atom*)e2)->str());
+}
+
+atom_hash_class atom_hash;
+
+/*----------------------------------------------------------------------------
+Implementation Section
+----------------------------------------------------------------------------*/
+Atom::Atom(const char *str){
+  _str = strdup(str);
+}
+
+Atom::~Atom(){
+  free(_str);
+}
+
+/*----------------------------------------------------------------------------
+Test Section
+----------------------------------------------------------------------------*/
+TEST(CHash, chash){
+  App   app;
+  Atom  atom_hello("hello"),
+        atom_world("world"),
+        atom_foo("foo");
+
+  atom_hash.add(&app, &atom_hello);
+  atom_hash.add(&app, &atom_world);
+  atom_hash.add(&app, &atom_foo);
+  ASSERT_EQ(3, atom_hash.num(&app));
+
+  Atom key("world");
+  ASSERT_EQ(&atom_world, atom_hash.sel(&app, &key));
+
+  atom_hash.del(&app, &atom_world);
+  ASSERT_EQ(2, atom_hash.num(&app));
+  ASSERT_EQ(NULL, atom_hash.sel(&app, &key));
+
+  int               n = 0;
+  atom_hash_class::Iter i(&app);
+  while( ++i ) n++;
+  ASSERT_EQ(2, n);
+}
+
+TEST(CHash, del_of_other_holder){
+  App   app, other;
+  Atom  atom("hello");
+
+  atom_hash.add(&app, &atom);
+  atom_hash.del(&other, &atom);           /* ignored: shard never filled */
+  ASSERT_EQ(1, atom_hash.num(&app));
+  ASSERT_EQ(&atom, atom_hash.sel(&app, &atom));
+  atom_hash.del(&app, &atom);
+  ASSERT_EQ(0, atom_hash.num(&app));
+}
+
+TEST(CHash, many_entry_to_expand){
+  App   app;
+  char  buf[16];
+  std::vector<Atom*> atoms;
+
+  for(int i=1; i <= 1000; i++){
+    sprintf(buf, "atom-%04d", i);
+    atoms.push_back(new Atom(buf));
+    atom_hash.add(&app, atoms.back());
+  }
+  ASSERT_EQ(1000, atom_hash.num(&app));
+
+  Atom  key("atom-0123");
+  Atom* hit = atom_hash.sel(&app, &key);
+  ASSERT_STREQ("atom-0123", hit->str());
+
+  for(auto a : atoms){
+    atom_hash.del(&app, a);
+    delete a;
+  }
+  ASSERT_EQ(0, atom_hash.num(&app));
+}
+
+/*
+readers must always find the stable entries while writers add/del their
+own entries and expand shards.
+*/
+TEST(CHash, concurrent_readers_and_writers){
+  const int nstable = 256, nwriter = 4, nown = 512;
+  App       app;
+  char      buf[32];
+  std::vector<Atom*>  stable, own;
+
+  for(int i=0; i < nstable; i++){
+    sprintf(buf, "stable-%d", i);
+    stable.push_back(new Atom(buf));
+    atom_hash.add(&app, stable.back());
+  }
+  for(int i=0; i < nwriter * nown; i++){
+    sprintf(buf, "own-%d", i);
+    own.push_back(new Atom(buf));
+  }
+
+  std::atomic<int>  misses(0);
+  std::vector<std::thread> threads;
+  for(int w=0; w < nwriter; w++){
+    threads.emplace_back([&, w]{
+      for(int round=0; round < 20; round++){
+        for(int i=0; i < nown; i++) atom_hash.add(&app, own[w*nown + i]);
+        for(int i=0; i < nown; i++) atom_hash.del(&app, own[w*nown + i]);
+      }
+    });
+  }
+  for(int r=0; r < 4; r++){
+    threads.emplace_back([&, r]{
+      for(int k=0; k < 20000; k++){
+        Atom* a = stable[(k * 7 + r) % nstable];
+        if( atom_hash.sel(&app, a) != a ) misses++;
+      }
+    });
+  }
+  for(auto& t : threads) t.join();
+
+  ASSERT_EQ(0,        misses.load());
+  ASSERT_EQ(nstable,  atom_hash.num(&app));
+  for(auto a : stable) atom_hash.del(&app, a);
+}
+
+int main(int argc, char **argv){
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
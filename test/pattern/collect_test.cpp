@@ -1,5 +1,7 @@
 #include <stdio.h>
 #include <string.h>
+#include <algorithm>
+#include <vector>
 #include "gtest/gtest.h"
 #include "jj/pattern.h"
 #include "collect_test.b" /* include Part-B */
@@ -59,6 +61,120 @@ TEST(Simplest, single_collect){
   ASSERT_EQ(NULL, b);
 }
 
+TEST(Simplest, collect_range){
+  Publisher p1("P1");
+  Book      oosc("1-123", "Object Oriented S/W Construction"),
+            itpl("2-111", "Introduction to the Theory of Programming Lanugages");
+
+  ASSERT_TRUE(books.begin(&p1) == books.end(&p1));
+  books.add(&p1, &oosc);
+  books.add(&p1, &itpl);
+
+  std::vector<Book*> v(books.begin(&p1), books.end(&p1));
+  ASSERT_EQ(2u,     v.size());
+  ASSERT_EQ(&oosc,  v[0]);
+  ASSERT_EQ(&itpl,  v[1]);
+
+  int n = std::count_if(books.begin(&p1), books.end(&p1),
+      [](Book* b){ return b->isbn[0] == '2'; });
+  ASSERT_EQ(1, n);
+
+  books.del(&p1, &oosc);
+  books.del(&p1, &itpl);
+}
+
+TEST(Simplest, collect_prefetch_and_fetch){
+  Publisher           p1("P1");
+  std::vector<Book*>  all;
+  char                buf[16];
+
+  for(int i=0; i < 100; i++){
+    sprintf(buf, "%d", i);
+    all.push_back(new Book(buf, buf));
+    books.add(&p1, all.back());
+  }
+
+  /* prefetch doesn't change the order */
+  for(int d : {1, 8, 200}){
+    books_class::Iter i;
+    Book*             b;
+    int               n = 0;
+    i.prefetch(d);
+    i.start(&p1);
+    while( (b = ++i) ){
+      ASSERT_EQ(all[n], b);
+      n++;
+    }
+    ASSERT_EQ(100, n);
+  }
+
+  /* fetch in batches of 30: 30, 30, 30, 10, 0 */
+  for(int d : {0, 4}){
+    books_class::Iter i(&p1);
+    Book*             batch[30];
+    int               n = 0, m;
+    i.prefetch(d);
+    while( (m = i.fetch(batch, 30)) > 0 ){
+      ASSERT_TRUE(m == 30 || (n == 90 && m == 10));
+      for(int k=0; k < m; k++) ASSERT_EQ(all[n++], batch[k]);
+    }
+    ASSERT_EQ(100, n);
+  }
+
+  for(auto b : all) books.del(&p1, b);
+}
+
+/* expiry in one pass: del() the current one, add() during the walk */
+TEST(Simplest, collect_iter_del){
+  Publisher           p1("P1");
+  std::vector<Book*>  all;
+  char                buf[16];
+
+  for(int i=0; i < 100; i++){
+    sprintf(buf, "%d", i);
+    all.push_back(new Book(buf, buf));
+    books.add(&p1, all.back());
+  }
+
+  /* every 3rd one including the first and the last */
+  Book              extra("x", "extra");
+  books_class::Iter i(&p1);
+  int               n = 0;
+  for(Book* b; (b = ++i); n++){
+    ASSERT_EQ(all[n], b);
+    if( n % 3 == 0 || n == 99 ){
+      i.del();
+      i.del();                              /* ignored: deleted already */
+    }
+    if( n == 50 ) books.add(&p1, &extra);   /* not visited */
+  }
+  ASSERT_EQ(100, n);
+  std::vector<Book*> expect;
+  for(int k=0; k < 100; k++) if( k % 3 != 0 && k != 99 ) expect.push_back(all[k]);
+  expect.push_back(&extra);
+  std::vector<Book*> v(books.begin(&p1), books.end(&p1));
+  ASSERT_EQ(expect, v);
+  ASSERT_EQ((int)expect.size(), books.num(&p1));
+  ASSERT_EQ(&extra, books.last(&p1));
+
+  /* last one of each fetch(), then the rest one by one */
+  Book* batch[10];
+  int   m;
+  i.start(&p1);
+  while( (m = i.fetch(batch, 10)) > 0 ) i.del();
+  ASSERT_EQ((int)expect.size() - ((int)expect.size() + 9) / 10, books.num(&p1));
+  i.start(&p1);
+  while( ++i ) i.del();
+  ASSERT_EQ(0, books.num(&p1));
+  ASSERT_EQ(NULL, books.child(&p1));
+
+  /* deleted ones can be added again */
+  books.add(&p1, all[0]);
+  ASSERT_EQ(1, books.num(&p1));
+  books.del(&p1, all[0]);
+  for(auto b : all) delete b;
+}
+
 int main(int argc, char **argv){
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,145 @@
+/*
+NAME
+  csr_test  - CSR snapshot of Graph and tree test
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "gtest/gtest.h"
+#include "jj/pattern.h"
+#include "csr_test.b" /* include Part-B */
+
+// define models
+class Node : INHERIT_Node {
+public:
+  long  size;
+  Node(long s) {size=s;}
+};
+
+class Host : INHERIT_Host {
+};
+
+class Link : INHERIT_Link {
+};
+
+// define pattern between models
+jjAggregate (tree, Node, Node);
+jjGraph     (net,  Host, Link);
+tree_class tree;
+net_class  net;
+
+/*----------------------------------------------------------------------------
+Test Section
+----------------------------------------------------------------------------*/
+TEST(CSR, tree){
+  Node  root(1),
+        n1(10),               n2(100),
+        n1a(1000), n1b(10000),  n2a(100000);
+
+  tree.add(&root, &n1);   tree.add(&root, &n2);
+  tree.add(&n1,   &n1a);  tree.add(&n1,   &n1b);
+  tree.add(&n2,   &n2a);
+
+  jj::CSR s;
+  tree.freeze(&s, &root);
+
+// BFS order; children are consecutive
+  ASSERT_EQ(6, s.num());
+  ASSERT_EQ(5, s.edges());
+  ASSERT_EQ(&root, tree.node(&s, 0));
+  ASSERT_EQ(&n1,   tree.node(&s, 1));
+  ASSERT_EQ(&n2,   tree.node(&s, 2));
+  ASSERT_EQ(&n1a,  tree.node(&s, 3));
+  ASSERT_EQ(&n1b,  tree.node(&s, 4));
+  ASSERT_EQ(&n2a,  tree.node(&s, 5));
+  ASSERT_EQ(2, s.degree(0));
+  ASSERT_EQ(2, s.degree(1));
+  ASSERT_EQ(1, s.degree(2));
+  ASSERT_EQ(0, s.degree(3));
+  ASSERT_EQ(5, s.adj(2)[0]);
+  ASSERT_EQ(-1, s.parent(0));
+  ASSERT_EQ(1,  s.parent(4));
+
+// subtree sum
+  long val[6], sum[6];
+  for(int i=0; i < s.num(); i++) val[i] = tree.node(&s, i)->size;
+  s.subtree_sum(val, sum);
+  ASSERT_EQ(111111, sum[0]);
+  ASSERT_EQ(11010,  sum[1]);
+  ASSERT_EQ(100100, sum[2]);
+  ASSERT_EQ(1000,   sum[3]);
+
+// bfs
+  int dist[6];
+  ASSERT_EQ(6, s.bfs(0, dist));
+  ASSERT_EQ(2, dist[5]);
+  ASSERT_EQ(3, s.bfs(1, dist));
+  ASSERT_EQ(-1, dist[2]);
+
+// snapshot is not changed by the tree
+  Node  n2b(7);
+  tree.add(&n2, &n2b);
+  ASSERT_EQ(6, s.num());
+  tree.freeze(&s, &root);
+  ASSERT_EQ(7, s.num());
+  ASSERT_EQ(&n2b, tree.node(&s, 6));
+
+  tree.del(&n2b);
+  tree.del(&n2a);   tree.del(&n1b);   tree.del(&n1a);
+  tree.del(&n2);    tree.del(&n1);
+}
+
+TEST(CSR, graph){
+  Host  h[5];
+  Link  l[6];
+  Host* nodes[4] = { &h[0], &h[1], &h[2], &h[3] };
+
+  net.add(&h[0], &h[1], &l[0]);
+  net.add(&h[0], &h[2], &l[1]);
+  net.add(&h[1], &h[2], &l[2]);
+  net.add(&h[2], &h[0], &l[3]);
+  net.add(&h[2], &h[4], &l[4]);     /* h[4] is not frozen */
+  net.add(&h[4], &h[3], &l[5]);
+
+  jj::CSR s;
+  net.freeze(&s, nodes, 4);
+
+  ASSERT_EQ(4, s.num());
+  ASSERT_EQ(4, s.edges());
+  ASSERT_EQ(&h[2], net.node(&s, 2));
+  ASSERT_EQ(2, s.degree(0));
+  ASSERT_EQ(1, s.adj(0)[0]);
+  ASSERT_EQ(2, s.adj(0)[1]);
+  ASSERT_EQ(1, s.degree(2));          /* edge to h[4] is dropped */
+  ASSERT_EQ(0, s.degree(3));
+  ASSERT_EQ(-1, s.parent(0));
+
+// bfs
+  int dist[4];
+  ASSERT_EQ(3, s.bfs(1, dist));
+  ASSERT_EQ(0,  dist[1]);
+  ASSERT_EQ(1,  dist[2]);
+  ASSERT_EQ(2,  dist[0]);
+  ASSERT_EQ(-1, dist[3]);
+
+// pagerank sums up to 1; dangling h[3] is spread
+  double rank[4], total = 0;
+  s.pagerank(rank, 50, 0.85);
+  for(int i=0; i < 4; i++) total += rank[i];
+  ASSERT_NEAR(1.0, total, 1e-9);
+  ASSERT_GT(rank[2], rank[1]);
+  ASSERT_GT(rank[0], rank[3]);
+
+// subtree_sum is for tree only
+  long val[4] = {1, 2, 3, 4}, sum[4] = {0, 0, 0, 0};
+  s.subtree_sum(val, sum);
+  ASSERT_EQ(0, sum[0]);
+
+  for(int i=0; i < 5; i++) net.isolate(&h[i]);
+}
+
+int main(int argc, char **argv){
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
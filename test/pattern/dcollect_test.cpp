@@ -1,5 +1,7 @@
 #include <stdio.h>
 #include <string.h>
+#include <algorithm>
+#include <vector>
 #include "gtest/gtest.h"
 #include "jj/pattern.h"
 #include "dcollect_test.b" /* include Part-B */
@@ -68,6 +70,56 @@ TEST(Simplest, dcollect){
   ASSERT_EQ(NULL, b);
 }
 
+TEST(Simplest, dcollect_range){
+  Publisher p1("P1");
+  Book      oosc("1-123", "Object Oriented S/W Construction"),
+            itpl("2-111", "Introduction to the Theory of Programming Lanugages"),
+            tcpp("3-333", "Taming C++");
+
+  books.add(&p1, &oosc);
+  books.add(&p1, &itpl);
+  books.add(&p1, &tcpp);
+
+  std::vector<Book*> v;
+  for(Book* b : books.range(&p1)) v.push_back(b);
+  ASSERT_EQ(3u,     v.size());
+  ASSERT_EQ(&tcpp,  v[2]);
+
+  /* backward by reverse_iterator */
+  typedef std::reverse_iterator<books_class::iterator> rev;
+  std::vector<Book*> r(rev(books.end(&p1)), rev(books.begin(&p1)));
+  ASSERT_EQ(3u,     r.size());
+  ASSERT_EQ(&tcpp,  r[0]);
+  ASSERT_EQ(&itpl,  r[1]);
+  ASSERT_EQ(&oosc,  r[2]);
+
+  books_class::iterator it = books.end(&p1);
+  --it;
+  ASSERT_EQ(&tcpp,  *it);
+
+  books.del(&p1, &oosc);
+  books.del(&p1, &itpl);
+  books.del(&p1, &tcpp);
+}
+
+TEST(Simplest, dcollect_del_of_other_parent){
+  Publisher p1("P1"), p2("P2");
+  Book      oosc("1-123", "Object Oriented S/W Construction"),
+            itpl("2-111", "Introduction to the Theory of Programming Lanugages");
+
+  books.add(&p1, &oosc);
+  books.add(&p1, &itpl);
+  books.del(&p2, &oosc);                  /* ignored: not a child of p2 */
+  ASSERT_EQ(2, books.num(&p1));
+  ASSERT_EQ(0, books.num(&p2));
+  ASSERT_EQ(&oosc, books.child(&p1));
+  ASSERT_EQ(&itpl, books.next(&oosc));
+
+  books.del(&p1, &oosc);
+  books.del(&p1, &itpl);
+  ASSERT_EQ(0, books.num(&p1));
+}
+
 int main(int argc, char **argv){
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
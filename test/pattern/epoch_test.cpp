@@ -0,0 +1,139 @@
+/*
+NAME
+  epoch_test  - Epoch (deferred reclamation) pattern test
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "jj/chash.h"
+#include "jj/epoch.h"
+#include "epoch_test.b" /* include Part-B */
+
+// define models
+class App : INHERIT_App {
+};
+
+class Item : INHERIT_Item {
+public:
+  int               key;
+  std::atomic<int>  alive;
+  Item(int k) { key = k; alive = 1; }
+};
+
+// define pattern between models
+jjCHash(items,  App, Item);
+jjEpoch(gc,     App, Item);
+
+int items_class::hash_base(Entry *e){
+  return ((Item*)e)->key;
+}
+
+int items_class::cmp_base(Entry *e1, Entry *e2){
+  return ((Item*)e1)->key - ((Item*)e2)->key;
+}
+
+/* instead of delete, mark it dead to check readers never see it */
+std::atomic<int>  g_reclaimed(0);
+
+void gc_class::reclaim_base(Node *n){
+  ((Item*)n)->alive = 0;
+  g_reclaimed++;
+}
+
+items_class items;
+gc_class    gc;
+
+/*----------------------------------------------------------------------------
+Test Section
+----------------------------------------------------------------------------*/
+TEST(Epoch, retire_without_reader){
+  App   app;
+  Item  a(1), b(2);
+
+  g_reclaimed = 0;
+  gc.retire(&app, &a);
+  gc.retire(&app, &b);
+  ASSERT_EQ(2, gc.num(&app));
+  ASSERT_EQ(1, a.alive.load());
+
+  gc.synchronize(&app);
+  ASSERT_EQ(0, gc.num(&app));
+  ASSERT_EQ(2, g_reclaimed.load());
+  ASSERT_EQ(0, a.alive.load());
+}
+
+TEST(Epoch, reader_blocks_reclaim){
+  App   app;
+  Item  a(1);
+
+  g_reclaimed = 0;
+  gc.enter(&app);
+  gc.retire(&app, &a);
+  for(int i=0; i < 10; i++) gc.reclaim(&app);
+  ASSERT_EQ(1, a.alive.load());     /* still in section */
+  gc.leave(&app);
+
+  gc.synchronize(&app);
+  ASSERT_EQ(0, a.alive.load());
+}
+
+TEST(Epoch, concurrent_del_and_retire){
+  const int nkey = 1024, nround = 20;
+  App       app;
+  std::vector<Item*>  all;
+  std::atomic<bool>   done(false);
+  std::vector<Item*>  retired;
+  std::atomic<int>    dead_seen(0), found(0);
+
+  g_reclaimed = 0;
+  for(int k=0; k < nkey; k++){
+    all.push_back(new Item(k));
+    items.add(&app, all.back());
+  }
+
+  std::vector<std::thread> readers;
+  for(int r=0; r < 3; r++){
+    readers.emplace_back([&, r]{
+      unsigned k = r;
+      while( !done ){
+        jj::Epoch::Guard g = gc.guard(&app);
+        Item  key(k++ % nkey);
+        Item* hit = items.sel(&app, &key);
+        if( hit ){
+          found++;
+          for(int i=0; i < 8; i++)
+            if( hit->alive.load() == 0 ) dead_seen++;
+        }
+      }
+    });
+  }
+
+  /* writer replaces every item by a new one nround times */
+  for(int round=0; round < nround; round++){
+    for(int k=0; k < nkey; k++){
+      Item* old = all[k];
+      items.del(&app, old);
+      gc.retire(&app, old);
+      retired.push_back(old);
+      all[k] = new Item(k);
+      items.add(&app, all[k]);
+    }
+  }
+  done = true;
+  for(auto& t : readers) t.join();
+  gc.synchronize(&app);
+
+  ASSERT_EQ(0,            dead_seen.load());
+  ASSERT_EQ(nkey*nround,  g_reclaimed.load());
+  ASSERT_LT(0,            found.load());
+  for(auto a : all){ items.del(&app, a); delete a; }
+  for(auto a : retired) delete a;           /* reclaim_base() only marks */
+}
+
+int main(int argc, char **argv){
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
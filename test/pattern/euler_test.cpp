@@ -0,0 +1,114 @@
+/*
+NAME
+  euler_test  - Euler tour index over Aggregate tree test
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "jj/tree.h"
+#include "euler_test.b" /* include Part-B */
+
+// define models
+class Node : INHERIT_Node {
+public:
+  long  size;
+  Node(long s=1) {size=s;}
+};
+
+class Org : INHERIT_Org {
+};
+
+// define pattern between models
+jjAggregate (tree,  Node, Node);
+jjEuler     (euler, Org,  Node);
+tree_class  tree;
+euler_class euler;
+
+/*----------------------------------------------------------------------------
+Test Section
+----------------------------------------------------------------------------*/
+TEST(Euler, basic){
+  Org   org;
+  Node  root(1),
+        n1(10),                 n2(100),
+        n1a(1000),  n1b(10000), n2a(100000);
+
+  tree.add(&root, &n1);   tree.add(&root, &n2);
+  tree.add(&n1,   &n1a);  tree.add(&n1,   &n1b);
+  tree.add(&n2,   &n2a);
+
+  euler.build(&org, &tree, &root);
+  ASSERT_EQ(1, euler.builds(&org));
+  ASSERT_EQ(6, euler.num(&org));
+
+// pre-order numbers; subtree is [in, out)
+  ASSERT_EQ(0, euler.in(&org, &root));
+  ASSERT_EQ(1, euler.in(&org, &n1));
+  ASSERT_EQ(4, euler.out(&org, &n1));
+  ASSERT_EQ(4, euler.in(&org, &n2));
+  ASSERT_EQ(6, euler.out(&org, &n2));
+  ASSERT_EQ(&n1b, euler.at(&org, 3));
+  ASSERT_EQ(3, euler.size(&org, &n1));
+  ASSERT_EQ(1, euler.size(&org, &n2a));
+
+// ancestor test
+  ASSERT_TRUE (euler.under(&org, &n1b, &n1));
+  ASSERT_TRUE (euler.under(&org, &n1b, &root));
+  ASSERT_TRUE (euler.under(&org, &n1,  &n1));
+  ASSERT_FALSE(euler.under(&org, &n1,  &n1b));
+  ASSERT_FALSE(euler.under(&org, &n2a, &n1));
+
+// subtree sum over a slice
+  long val[6];
+  for(int i=0; i < 6; i++) val[i] = euler.at(&org, i)->size;
+  ASSERT_EQ(11010,  euler.sum(&org, &n1, val));
+  ASSERT_EQ(111111, euler.sum(&org, &root, val));
+  ASSERT_EQ(1, euler.builds(&org));       /* no change, no rebuild */
+
+// lazy rebuild after add()/del()
+  Node n2b(7);
+  tree.add(&n2, &n2b);
+  ASSERT_TRUE(euler.under(&org, &n2b, &n2));
+  ASSERT_EQ(2, euler.builds(&org));
+  ASSERT_EQ(7, euler.num(&org));
+
+  tree.del(&n1b);
+  ASSERT_EQ(-1, euler.in(&org, &n1b));
+  ASSERT_FALSE(euler.under(&org, &n1b, &root));
+  ASSERT_EQ(2, euler.size(&org, &n1));
+  ASSERT_EQ(3, euler.builds(&org));
+
+  tree.del(&n2b);   tree.del(&n2a);   tree.del(&n1a);
+  tree.del(&n2);    tree.del(&n1);
+}
+
+TEST(Euler, random_tree){
+  const int n = 10000;
+  Org               org;
+  std::vector<Node> nodes(n);
+  std::mt19937      rnd(1);
+
+  for(int i=1; i < n; i++) tree.add(&nodes[rnd() % i], &nodes[i]);
+  euler.build(&org, &tree, &nodes[0]);
+
+// compare with parent links
+  for(int k=0; k < 2000; k++){
+    Node* a = &nodes[rnd() % n];
+    Node* b = &nodes[rnd() % n];
+    bool  expect = false;
+    for(Node* p=b; p; p = tree.parent(p)){
+      if( p == a ){ expect = true; break; }
+      if( p == &nodes[0] ) break;
+    }
+    ASSERT_EQ(expect, euler.under(&org, b, a));
+  }
+  for(int i=n-1; i > 0; i--) tree.del(&nodes[i]);
+}
+
+int main(int argc, char **argv){
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
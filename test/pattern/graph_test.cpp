@@ -0,0 +1,98 @@
+/*
+NAME
+  graph_test  - Graph pattern test
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "gtest/gtest.h"
+#include "jj/pattern.h"
+#include "graph_test.b" /* include Part-B */
+
+// define models
+class Task : INHERIT_Task {
+public:
+  char *name;
+  Task(const char *n) {name=strdup(n);}
+};
+
+class Dep : INHERIT_Dep {
+};
+
+// define pattern between models
+jjGraph (deps, Task, Dep);
+deps_class deps;
+
+/*----------------------------------------------------------------------------
+Test Section
+----------------------------------------------------------------------------*/
+TEST(Graph, graph){
+  Task  compile("compile"), link("link"), test("test"), doc("doc");
+  Dep   d1, d2, d3, d4;
+
+  deps.add(&compile, &link, &d1);
+  deps.add(&link,    &test, &d2);
+  deps.add(&compile, &test, &d3);
+  deps.add(&compile, &doc,  &d4);
+
+  ASSERT_EQ(3, deps.num_out(&compile));
+  ASSERT_EQ(0, deps.num_in(&compile));
+  ASSERT_EQ(2, deps.num_in(&test));
+  ASSERT_EQ(&compile, deps.from(&d3));
+  ASSERT_EQ(&test,    deps.to(&d3));
+
+// out-edges in added order
+  deps_class::OutIter o(&compile);
+  ASSERT_EQ(&d1,  ++o);
+  ASSERT_EQ(&d3,  ++o);
+  ASSERT_EQ(&d4,  ++o);
+  ASSERT_EQ(NULL, ++o);
+
+// in-edges
+  deps_class::InIter  i(&test);
+  ASSERT_EQ(&d2,  ++i);
+  ASSERT_EQ(&d3,  ++i);
+  ASSERT_EQ(NULL, ++i);
+
+// del in the middle of rings
+  deps.del(&d3);
+  ASSERT_EQ(2, deps.num_out(&compile));
+  ASSERT_EQ(1, deps.num_in(&test));
+  o.start(&compile);
+  ASSERT_EQ(&d1,  ++o);
+  ASSERT_EQ(&d4,  ++o);
+  ASSERT_EQ(NULL, ++o);
+  ASSERT_EQ(&d2,  deps.in(&test));
+
+// del tail, then re-add
+  deps.del(&d4);
+  ASSERT_EQ(&d1,  deps.out(&compile));
+  ASSERT_EQ(&d1,  deps.next_out(&d1));
+  deps.add(&doc, &compile, &d4);
+  ASSERT_EQ(&d4,  deps.in(&compile));
+
+// range
+  std::vector<Task*> v;
+  for(Dep* d : deps.outs(&link)) v.push_back(deps.to(d));
+  ASSERT_EQ(1u,     v.size());
+  ASSERT_EQ(&test,  v[0]);
+  v.clear();
+  for(Dep* d : deps.ins(&compile)) v.push_back(deps.from(d));
+  ASSERT_EQ(1u,     v.size());
+  ASSERT_EQ(&doc,   v[0]);
+
+// isolate
+  deps.isolate(&compile);
+  ASSERT_EQ(0,    deps.num_out(&compile));
+  ASSERT_EQ(0,    deps.num_in(&compile));
+  ASSERT_EQ(0,    deps.num_in(&link));
+  ASSERT_EQ(0,    deps.num_out(&doc));
+  ASSERT_EQ(NULL, deps.from(&d1));
+  ASSERT_EQ(1,    deps.num_in(&test));
+}
+
+int main(int argc, char **argv){
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
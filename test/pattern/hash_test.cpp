@@ -5,6 +5,8 @@ NAME
 
 #include <stdio.h>
 #include <string.h>
+#include <algorithm>
+#include <vector>
 #include "gtest/gtest.h"
 #include "jj/pattern.h"
 #include "hash_test.b" /* include Part-B */
@@ -86,6 +88,264 @@ TEST(Hash, many_entry_to_expand){
   ASSERT_STREQ("atom-0123", hit->str());
 }
 
+TEST(Hash, range){
+  App   app;
+  char  buf[16];
+
+  ASSERT_TRUE(atom_hash.begin(&app) == atom_hash.end(&app));
+  for(int i=1; i <= 100; i++){
+    sprintf(buf, "atom-%04d", i);
+    atom_hash.add(&app, new Atom(buf));
+  }
+
+  int n = 0;
+  for(Atom* a : atom_hash.range(&app)){
+    ASSERT_EQ(0, strncmp("atom-", a->str(), 5));
+    n++;
+  }
+  ASSERT_EQ(100, n);
+
+  /* same order as Iter */
+  atom_hash_class::Iter     i(&app);
+  atom_hash_class::iterator it = atom_hash.begin(&app);
+  for(Atom* a; (a = (Atom*)++i); ++it) ASSERT_EQ(a, *it);
+  ASSERT_TRUE(it == atom_hash.end(&app));
+
+  Atom key("atom-0042");
+  ASSERT_EQ(1, std::count_if(atom_hash.begin(&app), atom_hash.end(&app),
+      [&](Atom* a){ return strcmp(a->str(), key.str())==0; }));
+}
+
+TEST(Hash, multimap){
+  App   app;
+  Atom  k1("dup"), k2("dup"), k3("dup"), other("other"), key("dup"), none("none");
+  char  buf[16];
+
+  ASSERT_EQ(0, atom_hash.count(&app, &key));
+  atom_hash.add(&app, &k1);
+  atom_hash.add(&app, &other);
+  atom_hash.add(&app, &k2);
+  atom_hash.add(&app, &k3);
+  ASSERT_EQ(3, atom_hash.count(&app, &key));
+  ASSERT_EQ(0, atom_hash.count(&app, &none));
+
+  /* equal ones survive expand() */
+  std::vector<Atom*> filler;
+  for(int i=0; i < 1000; i++){
+    sprintf(buf, "f-%04d", i);
+    filler.push_back(new Atom(buf));
+    atom_hash.add(&app, filler.back());
+  }
+  atom_hash_class::Iter i;
+  std::vector<Atom*>    got;
+  atom_hash.sel_all(&app, &key, &i);
+  for(Atom* a; (a = (Atom*)++i); ) got.push_back(a);
+  std::sort(got.begin(), got.end());
+  std::vector<Atom*>    expect = {&k1, &k2, &k3};
+  std::sort(expect.begin(), expect.end());
+  ASSERT_EQ(expect, got);
+
+  /* current one may be deleted while walking */
+  atom_hash.sel_all(&app, &key, &i);
+  for(Atom* a; (a = (Atom*)++i); ) if( a != &k2 ) atom_hash.del(&app, a);
+  ASSERT_EQ(1, atom_hash.count(&app, &key));
+  ASSERT_EQ(&k2, atom_hash.sel(&app, &key));
+  atom_hash.del(&app, &k1);                 /* ignored: not added */
+  ASSERT_EQ(1002, atom_hash.num(&app));
+
+  for(Atom* a : filler){ atom_hash.del(&app, a); delete a; }
+}
+
+/* del() the current one and add() while walking, through expand()s */
+TEST(Hash, iter_del_and_add){
+  App                 app;
+  std::vector<Atom*>  all, more;
+  std::vector<int>    seen(200, 0);
+  char                buf[16];
+
+  for(int i=0; i < 200; i++){
+    sprintf(buf, "a-%03d", i);
+    all.push_back(new Atom(buf));
+    atom_hash.add(&app, all.back());
+  }
+  int size = app._size;
+  {
+    atom_hash_class::Iter i(&app);
+    for(Atom* a; (a = (Atom*)++i); ){
+      int k = std::find(all.begin(), all.end(), a) - all.begin();
+      if( k < 200 ){
+        seen[k]++;
+        if( k % 2 ) i.del();
+      }
+      if( more.size() < 1000 ){             /* expand()s several times */
+        sprintf(buf, "m-%04d", (int)more.size());
+        more.push_back(new Atom(buf));
+        atom_hash.add(&app, more.back());
+      }
+    }
+  }
+  ASSERT_LE(size * 4, app._size);
+  int again = 0;
+  for(int k=0; k < 200; k++){
+    ASSERT_LE(1, seen[k]);                  /* none missed */
+    if( k % 2 ) ASSERT_EQ(1, seen[k]);      /* del()-ed at once */
+    again += seen[k] - 1;
+  }
+  ASSERT_GT(20, again);                     /* a slot's worth per expand() */
+  ASSERT_EQ(100 + (int)more.size(), atom_hash.num(&app));
+  for(int k=0; k < 200; k++)
+    ASSERT_EQ(k % 2 ? NULL : all[k], atom_hash.sel(&app, all[k]));
+  for(Atom* a : more) ASSERT_EQ(a, atom_hash.sel(&app, a));
+
+  /* without add(): each once, in the order of iterator */
+  {
+    std::vector<Atom*>    got;
+    atom_hash_class::Iter i(&app);
+    for(Atom* a; (a = (Atom*)++i); ) got.push_back(a);
+    ASSERT_EQ(std::vector<Atom*>(atom_hash.begin(&app), atom_hash.end(&app)), got);
+  }
+
+  /* an Iter left in the middle, or copied, holds nothing */
+  atom_hash_class::Iter left(&app), copy;
+  ++left;
+  copy = left;
+  size = app._size;
+  for(int n=0; n < 2 * size; n++){
+    sprintf(buf, "z-%05d", n);
+    more.push_back(new Atom(buf));
+    atom_hash.add(&app, more.back());
+  }
+  ASSERT_LT(size, app._size);
+  int n = 1;
+  while( ++copy ) n++;
+  ASSERT_LE(atom_hash.num(&app) - 2 * size, n);   /* at least those before */
+
+  /* del() all in one pass */
+  atom_hash_class::Iter i(&app);
+  while( ++i ) i.del();
+  ASSERT_EQ(0, atom_hash.num(&app));
+  for(Atom* a : all)  delete a;
+  for(Atom* a : more) delete a;
+}
+
+/* entries in the slot of a, in bucket order */
+static std::vector<Atom*> slot_of(App* app, Atom* a){
+  std::vector<Atom*>    v;
+  int                   ix = jj::hash_str(a->str()) % app->_size;
+  atom_hash_class::Iter i(app);
+  for(Atom* e; (e = (Atom*)++i); )
+    if( jj::hash_str(e->str()) % app->_size == ix ) v.push_back(e);
+  return v;
+}
+
+TEST(Hash, move_to_front){
+  App                 app;
+  std::vector<Atom*>  all;
+  char                buf[16];
+
+  for(int i=0; i < 30; i++){               /* 30 in 16 slots; no expand() */
+    sprintf(buf, "mtf-%02d", i);
+    all.push_back(new Atom(buf));
+    atom_hash.add(&app, all.back());
+  }
+
+/* sel(): order stays */
+  for(Atom* a : all){
+    std::vector<Atom*> before = slot_of(&app, a);
+    ASSERT_EQ(a, atom_hash.sel(&app, a));
+    ASSERT_EQ(before, slot_of(&app, a));
+  }
+
+/* sel_mtf(): a hit comes first, the others keep their order */
+  for(Atom* a : all){
+    std::vector<Atom*> expect = slot_of(&app, a);
+    expect.erase(std::find(expect.begin(), expect.end(), a));
+    expect.insert(expect.begin(), a);
+    Atom key(a->str());
+    ASSERT_EQ(a, atom_hash.sel_mtf(&app, &key));
+    ASSERT_EQ(expect, slot_of(&app, a));
+  }
+  Atom none("mtf-none");
+  ASSERT_EQ(NULL, atom_hash.sel_mtf(&app, &none));
+
+/* an Iter walking the slot takes it again: none missed */
+  {
+    Atom*                 last = NULL;
+    for(Atom* a : all) if( slot_of(&app, a).size() > 1 ) last = slot_of(&app, a).back();
+    ASSERT_TRUE(last != NULL);
+    std::vector<Atom*>    slot = slot_of(&app, last), got;
+    atom_hash_class::Iter i(&app);
+    for(Atom* a; (a = (Atom*)++i); ){
+      got.push_back(a);
+      if( a == slot[0] ) ASSERT_EQ(last, atom_hash.sel_mtf(&app, last));
+    }
+    for(Atom* a : all) ASSERT_NE(got.end(), std::find(got.begin(), got.end(), a));
+    ASSERT_EQ(31u, got.size());             /* slot[0] once more */
+  }
+  ASSERT_EQ(30, atom_hash.num(&app));
+  for(Atom* a : all){ atom_hash.del(&app, a); delete a; }
+}
+
+/* no false negative through add(), expand(), del(), Iter::del() */
+TEST(Hash, filter){
+  App                 app;
+  std::vector<Atom*>  all, none;
+  char                buf[16];
+
+  atom_hash.filter(&app, true);             /* before the array */
+  ASSERT_TRUE(atom_hash.filter(&app));
+  for(int i=0; i < 3000; i++){
+    sprintf(buf, "b-%05d", i);
+    all.push_back(new Atom(buf));
+    atom_hash.add(&app, all.back());
+    sprintf(buf, "n-%05d", i);
+    none.push_back(new Atom(buf));
+  }
+  int absent = 0;
+  for(Atom* a : all)  ASSERT_EQ(a, atom_hash.sel(&app, a));
+  for(Atom* a : none) absent += atom_hash.sel(&app, a) == NULL;
+  ASSERT_EQ(3000, absent);
+
+/* most misses end at the filter; without it, all go on to the chain */
+  int passed = 0;
+  for(Atom* a : all)  ASSERT_TRUE(atom_hash.maybe(&app, a));
+  for(Atom* a : none) passed += atom_hash.maybe(&app, a);
+  ASSERT_LT(passed, 3000 / 20);             /* < 5% false positive */
+  {
+    App   plain;
+    Atom  one("one");
+    for(Atom* a : none) ASSERT_FALSE(atom_hash.maybe(&plain, a));   /* empty */
+    atom_hash.add(&plain, &one);
+    for(Atom* a : none) ASSERT_TRUE(atom_hash.maybe(&plain, a));
+    atom_hash.del(&plain, &one);
+  }
+
+/* del() half, Iter::del() a quarter */
+  for(int i=0; i < 3000; i += 2) atom_hash.del(&app, all[i]);
+  {
+    atom_hash_class::Iter i(&app);
+    for(Atom* a; (a = (Atom*)++i); )
+      if( (std::find(all.begin(), all.end(), a) - all.begin()) % 4 == 1 ) i.del();
+  }
+  for(int i=0; i < 3000; i++){
+    ASSERT_EQ(i % 4 == 3 ? all[i] : NULL, atom_hash.sel(&app, all[i]));
+    ASSERT_EQ(i % 4 == 3 ? 1 : 0, atom_hash.count(&app, all[i]));
+  }
+
+/* off and on again rebuilds from the entries */
+  atom_hash.filter(&app, false);
+  ASSERT_FALSE(atom_hash.filter(&app));
+  atom_hash.filter(&app, true);
+  for(int i=0; i < 3000; i++) ASSERT_EQ(i % 4 == 3 ? all[i] : NULL, atom_hash.sel(&app, all[i]));
+  for(int i=0; i < 3000; i += 4) atom_hash.add(&app, all[i]);
+  for(int i=0; i < 3000; i++)
+    ASSERT_EQ(i % 4 == 0 || i % 4 == 3 ? all[i] : NULL, atom_hash.sel(&app, all[i]));
+
+  for(Atom* a : all){ atom_hash.del(&app, a); delete a; }
+  for(Atom* a : none) delete a;
+  ASSERT_EQ(0, atom_hash.num(&app));
+}
+
 int main(int argc, char **argv){
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
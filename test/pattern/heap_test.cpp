@@ -0,0 +1,160 @@
+/*
+NAME
+  heap_test  - pairing heap pattern test
+*/
+
+#include <stdio.h>
+#include <random>
+#include <set>
+#include <vector>
+#include "gtest/gtest.h"
+#include "jj/heap.h"
+#include "heap_test.b" /* include Part-B */
+
+// define models
+class Sched : INHERIT_Sched {
+};
+
+class Job : INHERIT_Job {
+public:
+  int   key;
+  int   no;
+  Job(int k=0, int n=0) { key=k; no=n; }
+};
+
+// define pattern between models
+jjHeap (runq, Sched, Job);
+runq_class runq;
+
+int runq_class::cmp_base(Entry *e1, Entry *e2){
+  return ((Job*)e1)->key < ((Job*)e2)->key ? -1 : ((Job*)e1)->key > ((Job*)e2)->key;
+}
+
+static std::vector<int> drain(Sched* s){
+  std::vector<int> v;
+  for(Job* j; (j = runq.pop(s)); ) v.push_back(j->key);
+  return v;
+}
+
+/*----------------------------------------------------------------------------
+Test Section
+----------------------------------------------------------------------------*/
+TEST(Heap, basic){
+  Sched s;
+  Job   j5(5), j3(3), j8(8), j1(1), j9(9);
+
+  ASSERT_EQ(NULL, runq.top(&s));
+  ASSERT_EQ(NULL, runq.pop(&s));
+
+  runq.add(&s, &j5);  runq.add(&s, &j3);  runq.add(&s, &j8);
+  runq.add(&s, &j1);  runq.add(&s, &j9);
+  runq.add(&s, &j9);                        /* ignored: already added */
+  ASSERT_EQ(5, runq.num(&s));
+  ASSERT_EQ(&j1, runq.top(&s));
+
+// decrease, update, del
+  j8.key = 0;   runq.decrease(&s, &j8);
+  ASSERT_EQ(&j8, runq.top(&s));
+  j8.key = 7;   runq.update(&s, &j8);
+  ASSERT_EQ(&j1, runq.top(&s));
+  runq.del(&s, &j3);
+  runq.del(&s, &j3);                        /* ignored: not added */
+  ASSERT_FALSE(runq.added(&j3));
+  ASSERT_TRUE(runq.added(&j5));
+  ASSERT_EQ(4, runq.num(&s));
+
+  ASSERT_EQ((std::vector<int>{1, 5, 7, 9}), drain(&s));
+  ASSERT_EQ(0, runq.num(&s));
+  ASSERT_FALSE(runq.added(&j1));
+
+// entries popped can be added again
+  runq.add(&s, &j1);
+  ASSERT_EQ(&j1, runq.pop(&s));
+}
+
+TEST(Heap, meld){
+  Sched s1, s2;
+  Job   j[6] = {Job(4), Job(2), Job(6), Job(1), Job(5), Job(3)};
+
+  for(int i=0; i < 3; i++) runq.add(&s1, &j[i]);
+  for(int i=3; i < 6; i++) runq.add(&s2, &j[i]);
+  runq.meld(&s1, &s2);
+  ASSERT_EQ(6, runq.num(&s1));
+  ASSERT_EQ(0, runq.num(&s2));
+  ASSERT_EQ(NULL, runq.top(&s2));
+  runq.meld(&s1, &s2);                      /* empty: nothing */
+  ASSERT_EQ((std::vector<int>{1, 2, 3, 4, 5, 6}), drain(&s1));
+}
+
+TEST(Heap, root_of_other_heap){
+  Sched s1, s2;
+  Job   j1(1), j2(2), j3(3);
+
+  runq.add(&s1, &j1);  runq.add(&s1, &j3);
+  runq.add(&s2, &j2);
+  runq.del(&s1, &j2);                       /* ignored: root of s2 */
+  j2.key = 0;  runq.decrease(&s1, &j2);     /* ignored: root of s2 */
+  ASSERT_EQ(2, runq.num(&s1));
+  ASSERT_EQ(1, runq.num(&s2));
+  ASSERT_EQ(&j2, runq.top(&s2));
+  ASSERT_EQ((std::vector<int>{1, 3}), drain(&s1));
+  ASSERT_EQ((std::vector<int>{0}), drain(&s2));
+}
+
+/* random add / del / decrease / update / pop against std::multiset */
+TEST(Heap, random){
+  const int                   N = 3000;
+  Sched                       s;
+  std::vector<Job>            j(N);
+  std::multiset<std::pair<int, int> > ref;    /* key, no */
+  std::mt19937                rnd(7);
+
+  for(int i=0; i < N; i++) j[i].no = i;
+
+  for(int round=0; round < 200000; round++){
+    int i = rnd() % N;
+    switch( rnd() % 6 ){
+    case 0: case 1:
+      if( !runq.added(&j[i]) ){
+        j[i].key = rnd() % 100000;
+        runq.add(&s, &j[i]);
+        ref.insert(std::make_pair(j[i].key, i));
+      }
+      break;
+    case 2:
+      if( runq.added(&j[i]) ){
+        runq.del(&s, &j[i]);
+        ref.erase(ref.find(std::make_pair(j[i].key, i)));
+      }
+      break;
+    case 3:
+      if( runq.added(&j[i]) ){
+        ref.erase(ref.find(std::make_pair(j[i].key, i)));
+        j[i].key -= rnd() % 1000;
+        runq.decrease(&s, &j[i]);
+        ref.insert(std::make_pair(j[i].key, i));
+      }
+      break;
+    case 4:
+      if( runq.added(&j[i]) ){
+        ref.erase(ref.find(std::make_pair(j[i].key, i)));
+        j[i].key = rnd() % 100000;
+        runq.update(&s, &j[i]);
+        ref.insert(std::make_pair(j[i].key, i));
+      }
+      break;
+    case 5:
+      if( Job* t = runq.pop(&s) ){
+        ASSERT_EQ(ref.begin()->first, t->key);
+        ref.erase(ref.find(std::make_pair(t->key, t->no)));
+      }else
+        ASSERT_TRUE(ref.empty());
+      break;
+    }
+    ASSERT_EQ((int)ref.size(), runq.num(&s));
+  }
+
+  std::vector<int> expect;
+  for(auto& p : ref) expect.push_back(p.first);
+  ASSERT_EQ(expect, drain(&s));
+}
@@ -0,0 +1,106 @@
+/*
+NAME
+  lhash_test  - linked Hash pattern test
+*/
+
+#include <stdio.h>
+#include <deque>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "jj/lhash.h"
+#include "lhash_test.b" /* include Part-B */
+
+// define models
+class Conf : INHERIT_Conf {
+};
+
+class Item : INHERIT_Item {
+public:
+  int   key;
+  Item(int k=0) { key=k; }
+};
+
+// define pattern between models
+jjLHash (items, Conf, Item);
+items_class items;
+
+int items_class::hash_base(Entry *e)            { return ((Item*)e)->key & 0x7fffffff; }
+int items_class::cmp_base(Entry *e1, Entry *e2) { return ((Item*)e1)->key - ((Item*)e2)->key; }
+
+static std::vector<int> order(Conf* c){
+  std::vector<int> v;
+  items_class::Iter i(c);
+  for(Item* p; (p = ++i); ) v.push_back(p->key);
+  return v;
+}
+
+/*----------------------------------------------------------------------------
+Test Section
+----------------------------------------------------------------------------*/
+TEST(LHash, basic){
+  Conf  c;
+  Item  i5(5), i3(3), i9(9), i1(1), k9(9), k7(7);
+
+  ASSERT_EQ(NULL, items.first(&c));
+  ASSERT_EQ(NULL, items.pop(&c));
+
+  items.add(&c, &i5);  items.add(&c, &i3);  items.add(&c, &i9);  items.add(&c, &i1);
+  items.add(&c, &i3);                       /* ignored: already added */
+  ASSERT_EQ(4, items.num(&c));
+  ASSERT_EQ((std::vector<int>{5, 3, 9, 1}), order(&c));
+  ASSERT_EQ(&i9, items.sel(&c, &k9));
+  ASSERT_EQ(NULL, items.sel(&c, &k7));
+  ASSERT_EQ(&i5, items.first(&c));
+  ASSERT_EQ(&i1, items.last(&c));
+
+// del and add again moves to the newest
+  items.del(&c, &i3);
+  items.del(&c, &i3);                       /* ignored: not added */
+  ASSERT_EQ((std::vector<int>{5, 9, 1}), order(&c));
+  items.add(&c, &i3);
+  ASSERT_EQ((std::vector<int>{5, 9, 1, 3}), order(&c));
+
+// FIFO
+  ASSERT_EQ(&i5, items.pop(&c));
+  ASSERT_EQ(&i9, items.pop(&c));
+  ASSERT_EQ(NULL, items.sel(&c, &k9));
+  ASSERT_EQ((std::vector<int>{1, 3}), order(&c));
+}
+
+/* order survives expand() of the Hash; random del/pop against a deque */
+TEST(LHash, stable_order){
+  const int         N = 20000;
+  Conf              c;
+  std::vector<Item> it(N);
+  std::deque<int>   ref;
+  std::mt19937      rnd(11);
+
+  for(int i=0; i < N; i++){
+    it[i].key = (int)((i * 2654435761UL) & 0x3fffffff);   /* distinct, scattered */
+    items.add(&c, &it[i]);
+    ref.push_back(i);
+  }
+  for(int round=0; round < 5000; round++){
+    if( rnd() % 2 ){
+      Item* p = items.pop(&c);
+      ASSERT_EQ(&it[ref.front()], p);
+      ref.pop_front();
+      items.add(&c, p);
+      ref.push_back(p - &it[0]);
+    }else{
+      int k = rnd() % ref.size();
+      items.del(&c, &it[ref[k]]);
+      ASSERT_EQ(NULL, items.sel(&c, &it[ref[k]]));
+      items.add(&c, &it[ref[k]]);
+      ref.push_back(ref[k]);
+      ref.erase(ref.begin() + k);
+    }
+  }
+  std::vector<int> expect;
+  for(int i : ref) expect.push_back(it[i].key);
+  ASSERT_EQ(expect, order(&c));
+  for(int i=0; i < N; i += 97) ASSERT_EQ(&it[i], items.sel(&c, &it[i]));
+  while( items.pop(&c) ) ;
+  ASSERT_EQ(0, items.num(&c));
+}
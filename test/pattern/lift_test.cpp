@@ -0,0 +1,113 @@
+/*
+NAME
+  lift_test  - binary lifting (LCA, k-th ancestor) index test
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "jj/tree.h"
+#include "lift_test.b" /* include Part-B */
+
+// define models
+class Node : INHERIT_Node {
+};
+
+class Org : INHERIT_Org {
+};
+
+// define pattern between models
+jjAggregate (tree, Node, Node);
+jjLift      (lift, Org,  Node);
+tree_class  tree;
+lift_class  lift;
+
+/* O(depth) answers by parent links */
+static int naive_depth(Node* root, Node* n){
+  int d = 0;
+  for(; n != root; n = tree.parent(n)) d++;
+  return d;
+}
+
+static Node* naive_lca(Node* root, Node* a, Node* b){
+  int da = naive_depth(root, a), db = naive_depth(root, b);
+  for(; da > db; da--) a = tree.parent(a);
+  for(; db > da; db--) b = tree.parent(b);
+  while( a != b ){ a = tree.parent(a); b = tree.parent(b); }
+  return a;
+}
+
+/*----------------------------------------------------------------------------
+Test Section
+----------------------------------------------------------------------------*/
+TEST(Lift, basic){
+  Org   org;
+  Node  root, n1, n2, n1a, n1b, n1bA, n2a;
+
+  tree.add(&root, &n1);   tree.add(&root, &n2);
+  tree.add(&n1,   &n1a);  tree.add(&n1,   &n1b);
+  tree.add(&n1b,  &n1bA); tree.add(&n2,   &n2a);
+
+  lift.build(&org, &tree, &root);
+  ASSERT_EQ(7, lift.num(&org));
+  ASSERT_EQ(0, lift.depth(&org, &root));
+  ASSERT_EQ(3, lift.depth(&org, &n1bA));
+
+  ASSERT_EQ(&n1bA, lift.ancestor(&org, &n1bA, 0));
+  ASSERT_EQ(&n1b,  lift.ancestor(&org, &n1bA, 1));
+  ASSERT_EQ(&root, lift.ancestor(&org, &n1bA, 3));
+  ASSERT_EQ(NULL,  lift.ancestor(&org, &n1bA, 4));
+
+  ASSERT_EQ(&n1,   lift.lca(&org, &n1a, &n1bA));
+  ASSERT_EQ(&root, lift.lca(&org, &n1bA, &n2a));
+  ASSERT_EQ(&n1b,  lift.lca(&org, &n1b, &n1bA));
+  ASSERT_EQ(&n2a,  lift.lca(&org, &n2a, &n2a));
+
+// lazy rebuild
+  Node n2aA;
+  tree.add(&n2a, &n2aA);
+  ASSERT_EQ(&n2,   lift.ancestor(&org, &n2aA, 2));
+  ASSERT_EQ(2,     lift.builds(&org));
+  tree.del(&n2aA);
+  ASSERT_EQ(-1,    lift.depth(&org, &n2aA));
+  ASSERT_EQ(NULL,  lift.lca(&org, &n2aA, &root));
+
+  tree.del(&n2a);   tree.del(&n1bA);  tree.del(&n1b);
+  tree.del(&n1a);   tree.del(&n2);    tree.del(&n1);
+}
+
+TEST(Lift, random_and_deep_trees_by_threads){
+  const int n = 100000;
+  std::vector<Node> nodes(n);
+  std::mt19937      rnd(1);
+
+  for(int shape=0; shape < 2; shape++){
+    for(int i=1; i < n; i++){
+      int p = shape == 0 ? rnd() % i : i - 1 - rnd() % (i < 3 ? i : 3);
+      tree.add(&nodes[p], &nodes[i]);
+    }
+    Org org;
+    lift.build(&org, &tree, &nodes[0], 4);
+    ASSERT_EQ(n, lift.num(&org));
+    for(int k=0; k < 300; k++){
+      Node* a = &nodes[rnd() % n];
+      Node* b = &nodes[rnd() % n];
+      int   d = naive_depth(&nodes[0], a);
+      ASSERT_EQ(d, lift.depth(&org, a));
+      ASSERT_EQ(naive_lca(&nodes[0], a, b), lift.lca(&org, a, b));
+
+      int   up = d ? rnd() % d : 0;
+      Node* p  = a;
+      for(int j=0; j < up; j++) p = tree.parent(p);
+      ASSERT_EQ(p, lift.ancestor(&org, a, up));
+    }
+    for(int i=n-1; i > 0; i--) tree.del(&nodes[i]);
+  }
+}
+
+int main(int argc, char **argv){
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,135 @@
+/*
+NAME
+  lru_test  - LRU cache pattern test
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <list>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include "gtest/gtest.h"
+#include "jj/lru.h"
+#include "lru_test.b" /* include Part-B */
+
+// define models
+class Store : INHERIT_Store {
+};
+
+class Page : INHERIT_Page {
+public:
+  int   no;
+  bool  evicted;
+  Page(int n=0) { no=n; evicted=false; }
+};
+
+// define pattern between models
+jjLRU (pages, Store, Page);
+pages_class pages;
+
+int pages_class::hash_base(Entry *e)            { return ((Page*)e)->no & 0x7fffffff; }
+int pages_class::cmp_base(Entry *e1, Entry *e2) { return ((Page*)e1)->no - ((Page*)e2)->no; }
+void pages_class::evict_base(Cache *c, Entry *e){ ((Page*)e)->evicted = true; }
+
+static std::vector<int> order(Store* s){
+  std::vector<int> v;
+  pages_class::Iter i(s);
+  for(Page* p; (p = ++i); ) v.push_back(p->no);
+  return v;
+}
+
+/*----------------------------------------------------------------------------
+Test Section
+----------------------------------------------------------------------------*/
+TEST(LRU, basic){
+  Store s;
+  Page  p1(1), p2(2), p3(3), p4(4), k2(2), k9(9);
+
+  pages.capacity(&s, 3);
+
+  pages.add(&s, &p1);   pages.add(&s, &p2);   pages.add(&s, &p3);
+  pages.add(&s, &p3);                       /* ignored: already added */
+  ASSERT_EQ(3, pages.num(&s));
+  ASSERT_EQ((std::vector<int>{1, 2, 3}), order(&s));
+
+// sel() touches; peek() doesn't
+  ASSERT_EQ(&p2, pages.sel(&s, &k2));
+  ASSERT_EQ(NULL, pages.sel(&s, &k9));
+  ASSERT_EQ(&p2, pages.peek(&s, &k2));
+  ASSERT_EQ((std::vector<int>{1, 3, 2}), order(&s));
+  ASSERT_EQ(1, pages.hits(&s));
+  ASSERT_EQ(1, pages.misses(&s));
+  ASSERT_EQ(&p1, pages.oldest(&s));
+  ASSERT_EQ(&p2, pages.newest(&s));
+
+// add() over capacity evicts the oldest
+  pages.add(&s, &p4);
+  ASSERT_TRUE(p1.evicted);
+  ASSERT_EQ(1, pages.evictions(&s));
+  ASSERT_EQ((std::vector<int>{3, 2, 4}), order(&s));
+  ASSERT_EQ(NULL, pages.peek(&s, &p1));
+
+  pages.touch(&s, &p3);
+  ASSERT_EQ((std::vector<int>{2, 4, 3}), order(&s));
+
+// cost budget; the added one is kept even if too large alone
+  pages.add(&s, &p1, 5);
+  ASSERT_EQ((std::vector<int>{1}), order(&s));
+  ASSERT_EQ(5, pages.cost(&s));
+  ASSERT_EQ(4, pages.evictions(&s));
+
+  pages.capacity(&s, 10);
+  p2.evicted = false;
+  pages.add(&s, &p2, 4);
+  ASSERT_FALSE(p2.evicted);
+  ASSERT_EQ(9, pages.cost(&s));
+  pages.capacity(&s, 4);                    /* shrink evicts */
+  ASSERT_EQ((std::vector<int>{2}), order(&s));
+
+  pages.del(&s, &p2);                       /* no evict_base() */
+  ASSERT_EQ(0, pages.num(&s));
+  ASSERT_EQ(0, pages.cost(&s));
+  ASSERT_EQ(NULL, pages.evict(&s));
+
+  pages.reset_stat(&s);
+  ASSERT_EQ(0, pages.hits(&s) + pages.misses(&s) + pages.evictions(&s));
+}
+
+TEST(LRU, random_vs_list){
+  const int           npage = 1000, cap = 100;
+  Store               s;
+  std::vector<Page>   all(npage);
+  std::list<int>      ref;                  /* oldest first */
+  std::unordered_map<int, std::list<int>::iterator> where;
+  std::mt19937        rnd(1);
+  long                hit = 0;
+
+  pages.capacity(&s, cap);
+  for(int i=0; i < npage; i++) all[i].no = i;
+  for(int k=0; k < 100000; k++){
+    int   no = (rnd() % 2) ? rnd() % (cap * 2) : rnd() % npage;
+    Page  key(no);
+    Page* p = pages.sel(&s, &key);
+    auto  w = where.find(no);
+    ASSERT_EQ(w != where.end(), p != NULL);
+    if( p ){
+      hit++;
+      ref.erase(w->second);
+    }else{
+      pages.add(&s, &all[no]);
+      if( (int)ref.size() == cap ){ where.erase(ref.front()); ref.pop_front(); }
+    }
+    ref.push_back(no);
+    where[no] = std::prev(ref.end());
+  }
+  ASSERT_EQ(hit, pages.hits(&s));
+  ASSERT_EQ((std::vector<int>(ref.begin(), ref.end())), order(&s));
+  while( pages.evict(&s) );
+  ASSERT_EQ(0, pages.num(&s));
+}
+
+int main(int argc, char **argv){
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,177 @@
+/*
+NAME
+  parallel_test  - Parallel traversal over tree and Graph test
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "jj/parallel.h"
+#include "parallel_test.b" /* include Part-B */
+
+// define models
+class Node : INHERIT_Node {
+public:
+  int   depth;
+  Node() {depth=-1;}
+};
+
+class Host : INHERIT_Host {
+public:
+  std::atomic<int>  seen;
+  Host() {seen=0;}
+};
+
+class Link : INHERIT_Link {
+};
+
+// define pattern between models
+jjAggregate (tree, Node, Node);
+jjGraph     (net,  Host, Link);
+tree_class tree;
+net_class  net;
+
+/* record level in the models */
+class Walk : public jj::Parallel {
+public:
+  std::atomic<long> visited;
+  Walk(int threads) : jj::Parallel(threads) { visited = 0; }
+protected:
+  void visit_base(jj::Aggregate::Parent* p, int level){
+    static_cast<Node*>(static_cast<tree_Parent*>(p))->depth = level;
+    visited++;
+  }
+  void visit_base(jj::Graph::Node* n, int level){
+    static_cast<Host*>(static_cast<net_Node*>(n))->seen++;
+    visited++;
+  }
+};
+
+/* subtree size by fold(); also stored in the models */
+class Size : public jj::Parallel {
+public:
+  std::atomic<long> pre;
+  Size(int threads) : jj::Parallel(threads) { pre = 0; }
+protected:
+  void pre_base(jj::Aggregate::Parent* ){ pre++; }
+  long post_base(jj::Aggregate::Parent* p, long children){
+    static_cast<Node*>(static_cast<tree_Parent*>(p))->depth = children + 1;
+    return children + 1;
+  }
+};
+
+static long seq_size(Node* n){
+  long s = 1;
+  for(Node* c : tree.range(n)) s += seq_size(c);
+  return s;
+}
+
+/*----------------------------------------------------------------------------
+Test Section
+----------------------------------------------------------------------------*/
+TEST(Parallel, tree){
+  const int n = 5000;
+  std::vector<Node> nodes(n);
+  std::mt19937      rnd(1);
+
+  for(int i=1; i < n; i++) tree.add(&nodes[rnd() % i], &nodes[i]);
+
+  Walk w(4);
+  ASSERT_EQ(n, w.bfs(&tree, &nodes[0]));
+  ASSERT_EQ(n, w.visited.load());
+
+  int max = 0;
+  ASSERT_EQ(0, nodes[0].depth);
+  for(int i=1; i < n; i++){
+    Node* p = tree.parent(&nodes[i]);
+    ASSERT_EQ(p->depth + 1, nodes[i].depth);
+    if( nodes[i].depth > max ) max = nodes[i].depth;
+  }
+  ASSERT_EQ(max + 1, w.levels());
+
+// subtree only
+  jj::CSR s;
+  tree.freeze(&s, &nodes[1]);
+  w.visited = 0;
+  ASSERT_EQ(s.num(), w.bfs(&tree, &nodes[1]));
+  ASSERT_EQ(s.num(), w.visited.load());
+
+  for(int i=n-1; i > 0; i--) tree.del(&nodes[i]);
+}
+
+TEST(Parallel, fold){
+  const int n = 20000;
+  std::vector<Node> nodes(n);
+  std::mt19937      rnd(3);
+
+  for(int i=1; i < n; i++) tree.add(&nodes[rnd() % i], &nodes[i]);
+
+  for(int threads : {1, 4}){
+    for(int cutoff : {0, 3}){
+      Size f(threads);
+      ASSERT_EQ(n, f.fold(&tree, &nodes[0], cutoff));
+      ASSERT_EQ(n, f.pre.load());
+      for(int i=0; i < n; i += 97) ASSERT_EQ(seq_size(&nodes[i]), nodes[i].depth);
+    }
+  }
+  for(int i=n-1; i > 0; i--) tree.del(&nodes[i]);
+
+// deep chain is not a recursion
+  for(int i=1; i < n; i++) tree.add(&nodes[i-1], &nodes[i]);
+  Size f(4);
+  ASSERT_EQ(n, f.fold(&tree, &nodes[0], 5));
+  ASSERT_EQ(1, nodes[n-1].depth);
+  ASSERT_EQ(n / 2, nodes[n / 2].depth);
+  for(int i=n-1; i > 0; i--) tree.del(&nodes[i]);
+}
+
+TEST(Parallel, graph){
+  const int n = 20000, degree = 6;
+  std::vector<Host>   hosts(n);
+  std::vector<Link>   links(n * degree);
+  std::vector<Host*>  all(n);
+  std::mt19937        rnd(2);
+
+  for(int i=0; i < n; i++) all[i] = &hosts[i];
+  for(int k=0; k < n * degree; k++)
+    net.add(&hosts[rnd() % (n / 2)], &hosts[rnd() % n], &links[k]);   /* upper half has no out-edge */
+
+// reference by sequential CSR bfs
+  jj::CSR     s;
+  std::vector<int> dist(n);
+  net.freeze(&s, all.data(), n);
+  int reach = s.bfs(0, dist.data());
+
+  const int modes[] = { jj::Parallel::top_down, jj::Parallel::bottom_up,
+                        jj::Parallel::direction_optimizing };
+  std::vector<jj::Graph::Node*> base(n);
+  for(int i=0; i < n; i++) base[i] = (net_Node *)all[i];
+
+  for(int mode : modes){
+    for(int threads : {1, 3}){
+      Walk w(threads);
+      for(auto& h : hosts) h.seen = 0;
+      ASSERT_EQ(reach, w.bfs(&net, base[0], base.data(), n, mode));
+      ASSERT_EQ(reach, w.visited.load());
+      for(int i=0; i < n; i++){
+        ASSERT_EQ(dist[i], w.level((net_Node *)&hosts[i]));
+        ASSERT_EQ(dist[i] < 0 ? 0 : 1, hosts[i].seen.load());
+      }
+    }
+  }
+
+// without all[], top-down only
+  Walk w(2);
+  ASSERT_EQ(reach, w.bfs(&net, base[0]));
+  ASSERT_EQ(dist[n-1], w.level((net_Node *)&hosts[n-1]));
+
+  for(auto& h : hosts) net.isolate(&h);
+}
+
+int main(int argc, char **argv){
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,89 @@
+/*
+NAME
+  queue_test  - Queue (lock-free MPSC) pattern test
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "jj/queue.h"
+#include "queue_test.b" /* include Part-B */
+
+// define models
+class Worker : INHERIT_Worker {
+};
+
+class Job : INHERIT_Job {
+public:
+  int producer;
+  int seq;
+  Job(int p=0, int s=0) { producer=p; seq=s; }
+};
+
+// define pattern between models
+jjQueue (jobs, Worker, Job);
+jobs_class jobs;
+
+/*----------------------------------------------------------------------------
+Test Section
+----------------------------------------------------------------------------*/
+TEST(Queue, fifo){
+  Worker  w;
+  Job     j1(0, 1), j2(0, 2), j3(0, 3);
+
+  ASSERT_TRUE(jobs.empty(&w));
+  ASSERT_EQ(NULL, jobs.get(&w));
+
+  jobs.add(&w, &j1);
+  jobs.add(&w, &j2);
+  ASSERT_FALSE(jobs.empty(&w));
+  ASSERT_EQ(&j1, jobs.get(&w));
+
+  jobs.add(&w, &j3);
+  ASSERT_EQ(&j2, jobs.get(&w));
+  ASSERT_EQ(&j3, jobs.get(&w));
+  ASSERT_EQ(NULL, jobs.get(&w));
+  ASSERT_TRUE(jobs.empty(&w));
+
+  /* re-add after got */
+  jobs.add(&w, &j1);
+  ASSERT_EQ(&j1, jobs.get(&w));
+  ASSERT_EQ(NULL, jobs.get(&w));
+}
+
+TEST(Queue, multi_producer){
+  const int         nproducer = 4, njob = 20000;
+  Worker            w;
+  std::vector<Job>  all(nproducer * njob);
+  std::vector<std::thread> producers;
+
+  for(int p=0; p < nproducer; p++){
+    producers.emplace_back([&, p]{
+      for(int s=0; s < njob; s++){
+        Job* j = &all[p * njob + s];
+        j->producer = p;
+        j->seq      = s;
+        jobs.add(&w, j);
+      }
+    });
+  }
+
+  std::vector<int>  last(nproducer, -1);
+  int               got = 0;
+  while( got < nproducer * njob ){
+    Job* j = jobs.get(&w);
+    if( j == NULL ){ std::this_thread::yield(); continue; }
+    ASSERT_EQ(last[j->producer] + 1, j->seq);   /* FIFO per producer */
+    last[j->producer] = j->seq;
+    got++;
+  }
+  for(auto& t : producers) t.join();
+  ASSERT_EQ(NULL, jobs.get(&w));
+}
+
+int main(int argc, char **argv){
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
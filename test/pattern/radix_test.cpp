@@ -0,0 +1,175 @@
+/*
+NAME
+  radix_test  - Radix (adaptive radix tree by string key) pattern test
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "jj/radix.h"
+#include "radix_test.b" /* include Part-B */
+
+// define models
+class App : INHERIT_App {
+};
+
+class Atom : INHERIT_Atom {
+public:
+  std::string   name;
+  Atom(const std::string& s="") : name(s) {}
+  const char*   str() { return name.c_str(); }
+};
+
+// define pattern between models
+jjRadix (atoms, App, Atom);
+atoms_class atoms;
+
+const char* atoms_class::key_base(Entry *e){
+  return ((Atom*)e)->str();
+}
+
+static std::string names(atoms_class::Range r){
+  std::string s;
+  for(Atom* a : r) s += a->name + " ";
+  return s;
+}
+
+/*----------------------------------------------------------------------------
+Test Section
+----------------------------------------------------------------------------*/
+TEST(Radix, basic){
+  App   app;
+  Atom  a("atom"), a1("atom-01"), a12("atom-012"), a13("atom-013"),
+        a2("atom-02"), b("b"), empty(""), dup("atom-01");
+
+  ASSERT_EQ(NULL, atoms.first(&app));
+  atoms.add(&app, &a13);  atoms.add(&app, &a);    atoms.add(&app, &a2);
+  atoms.add(&app, &b);    atoms.add(&app, &a12);  atoms.add(&app, &a1);
+  atoms.add(&app, &empty);
+  atoms.add(&app, &dup);                    /* ignored: same key */
+  atoms.add(&app, &a1);                     /* ignored: already added */
+  ASSERT_EQ(7, atoms.num(&app));
+
+// exact lookup
+  ASSERT_EQ(&a1,    atoms.sel(&app, "atom-01"));
+  ASSERT_EQ(&a,     atoms.sel(&app, "atom"));
+  ASSERT_EQ(&empty, atoms.sel(&app, ""));
+  ASSERT_EQ(NULL,   atoms.sel(&app, "atom-0"));
+  ASSERT_EQ(NULL,   atoms.sel(&app, "atom-0123"));
+  ASSERT_EQ(NULL,   atoms.sel(&app, "c"));
+
+// key order
+  ASSERT_EQ(" atom atom-01 atom-012 atom-013 atom-02 b ", names(atoms.range(&app)));
+  ASSERT_EQ(&empty, atoms.first(&app));
+  ASSERT_EQ(&a12,   atoms.next(&a1));
+  ASSERT_EQ(NULL,   atoms.next(&b));
+
+// prefix
+  ASSERT_EQ("atom-01 atom-012 atom-013 ", names(atoms.range(&app, "atom-01")));
+  ASSERT_EQ("atom-012 ",  names(atoms.range(&app, "atom-012")));
+  ASSERT_EQ("atom-02 ",   names(atoms.range(&app, "atom-02")));
+  ASSERT_EQ("",           names(atoms.range(&app, "atom-03")));
+  ASSERT_EQ("",           names(atoms.range(&app, "atom-0123")));
+  ASSERT_EQ("b ",         names(atoms.range(&app, "b")));
+  ASSERT_EQ(names(atoms.range(&app)), names(atoms.range(&app, "")));
+
+  atoms_class::Iter i;
+  atoms.scan(&app, "atom-", &i);
+  ASSERT_EQ(&a1,  ++i);
+  ASSERT_EQ(&a12, ++i);
+
+// del while iterating all
+  i.start(&app);
+  for(Atom* x; (x = ++i); ) if( x->name.size() == 8 ) atoms.del(&app, x);
+  ASSERT_EQ(" atom atom-01 atom-02 b ", names(atoms.range(&app)));
+  ASSERT_EQ(NULL, atoms.sel(&app, "atom-012"));
+  atoms.del(&app, &a12);                    /* ignored: not added */
+  ASSERT_EQ(5, atoms.num(&app));
+
+  atoms.add(&app, &dup);
+  ASSERT_EQ(5, atoms.num(&app));
+  atoms.del(&app, &a1);
+  atoms.add(&app, &dup);
+  ASSERT_EQ(&dup, atoms.sel(&app, "atom-01"));
+
+  atoms.del(&app, &dup);  atoms.del(&app, &a);  atoms.del(&app, &a2);
+  atoms.del(&app, &b);    atoms.del(&app, &empty);
+  ASSERT_EQ(0, atoms.num(&app));
+  ASSERT_EQ(NULL, atoms.first(&app));
+}
+
+TEST(Radix, random_vs_set){
+  const int           n = 20000;
+  App                 app;
+  std::vector<Atom>   all(n);
+  std::vector<bool>   in(n);
+  std::set<std::string> ref;
+  std::mt19937        rnd(1);
+
+  /* short keys over a few letters share long prefixes; some use all bytes
+     to grow nodes to 256 children */
+  for(int j=0; j < n; j++){
+    int len = 1 + rnd() % 8;
+    for(int k=0; k < len; k++){
+      all[j].name += (j % 10) ? (char)('a' + rnd() % 4) : (char)(1 + rnd() % 255);
+    }
+  }
+  for(int round=0; round < 4; round++){
+    for(int j=0; j < n; j++){
+      if( !in[j] && rnd() % 3 ){
+        if( ref.count(all[j].name) ){
+          atoms.add(&app, &all[j]);         /* same key: ignored */
+          ASSERT_NE(&all[j], atoms.sel(&app, all[j].str()));
+          continue;
+        }
+        atoms.add(&app, &all[j]);
+        ref.insert(all[j].name);
+        in[j] = true;
+      }else if( in[j] && rnd() % 2 ){
+        atoms.del(&app, &all[j]);
+        ref.erase(all[j].name);
+        in[j] = false;
+      }
+    }
+    ASSERT_EQ((int)ref.size(), atoms.num(&app));
+
+    auto r = ref.begin();
+    for(Atom* a : atoms.range(&app)) ASSERT_EQ(*r++, a->name);
+    ASSERT_EQ(ref.end(), r);
+
+    for(int j=0; j < n; j += 7){
+      Atom* a = atoms.sel(&app, all[j].str());
+      ASSERT_EQ(ref.count(all[j].name) == 1, a != NULL);
+      if( a ){ ASSERT_EQ(all[j].name, a->name); }
+    }
+    for(const char* p : {"a", "ab", "abc", "abca", "d", "dd", "dcba"}){
+      std::string s;
+      for(auto& k : ref) if( k.compare(0, strlen(p), p) == 0 ) s += k + " ";
+      ASSERT_EQ(s, names(atoms.range(&app, p)));
+    }
+  }
+  for(int j=0; j < n; j++) if( in[j] ) atoms.del(&app, &all[j]);
+  ASSERT_EQ(0, atoms.num(&app));
+}
+
+TEST(Radix, holder_frees_nodes){
+  std::vector<Atom> all;
+  for(int j=0; j < 1000; j++) all.push_back(Atom("k" + std::to_string(j)));
+  {
+    App app;
+    for(auto& a : all) atoms.add(&app, &a);
+  }
+  App app2;                                 /* detached; can be added again */
+  for(auto& a : all) atoms.add(&app2, &a);
+  ASSERT_EQ(1000, atoms.num(&app2));
+  for(auto& a : all) atoms.del(&app2, &a);
+}
+
+int main(int argc, char **argv){
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,163 @@
+/*
+NAME
+  rbtree_test  - RBTree (ordered holder-entry) pattern test
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+#include "gtest/gtest.h"
+#include "jj/rbtree.h"
+#include "rbtree_test.b" /* include Part-B */
+
+// define models
+class Calendar : INHERIT_Calendar {
+};
+
+class Event : INHERIT_Event {
+public:
+  int time;
+  Event(int t=0) { time=t; }
+};
+
+// define pattern between models
+jjRBTree (events, Calendar, Event);
+events_class events;
+
+int events_class::cmp_base(Entry *e1, Entry *e2){
+  return ((Event*)e1)->time - ((Event*)e2)->time;
+}
+
+/*----------------------------------------------------------------------------
+Test Section
+----------------------------------------------------------------------------*/
+TEST(RBTree, basic){
+  Calendar  cal;
+  Event     e30(30), e10(10), e20(20), e20b(20), e40(40);
+
+  ASSERT_EQ(NULL, events.first(&cal));
+  ASSERT_EQ(0, events.check(&cal));
+
+  events.add(&cal, &e30);   events.add(&cal, &e10);
+  events.add(&cal, &e20);   events.add(&cal, &e40);
+  events.add(&cal, &e20b);  /* same key after e20 */
+  events.add(&cal, &e20b);  /* ignored: already added */
+  ASSERT_EQ(5, events.num(&cal));
+  ASSERT_LT(0, events.check(&cal));
+
+// in-order
+  std::vector<Event*> got;
+  for(Event* e : events.range(&cal)) got.push_back(e);
+  ASSERT_EQ((std::vector<Event*>{&e10, &e20, &e20b, &e30, &e40}), got);
+
+  events_class::Iter i(&cal);
+  ASSERT_EQ(&e10, ++i);
+  ASSERT_EQ(&e20, ++i);
+  ASSERT_EQ(&e40, events.last(&cal));
+  ASSERT_EQ(&e30, events.prev(&e40));
+  ASSERT_EQ(NULL, events.next(&e40));
+
+// find and bounds
+  Event k(20), k25(25), k5(5), k50(50);
+  ASSERT_EQ(&e20,  events.sel(&cal, &k));
+  ASSERT_EQ(NULL,  events.sel(&cal, &k25));
+  ASSERT_EQ(&e20,  events.lower_bound(&cal, &k));
+  ASSERT_EQ(&e30,  events.upper_bound(&cal, &k));
+  ASSERT_EQ(&e30,  events.lower_bound(&cal, &k25));
+  ASSERT_EQ(&e10,  events.lower_bound(&cal, &k5));
+  ASSERT_EQ(NULL,  events.lower_bound(&cal, &k50));
+
+// range of 20 <= time <= 30
+  got.clear();
+  for(Event* e : events.range(&cal, &k, &e30)) got.push_back(e);
+  ASSERT_EQ((std::vector<Event*>{&e20, &e20b, &e30}), got);
+  got.clear();
+  for(Event* e : events.range(&cal, &k25, &k25)) got.push_back(e);
+  ASSERT_TRUE(got.empty());
+  for(Event* e : events.range(&cal, &e30, &k5)) got.push_back(e);  /* lo > hi */
+  ASSERT_TRUE(got.empty());
+  for(Event* e : events.range(&cal, &k50, &k5)) got.push_back(e);
+  ASSERT_TRUE(got.empty());
+
+  auto it = events.begin(&cal);
+  ++it; ++it;
+  ASSERT_EQ(&e20b, *it);
+  --it;
+  ASSERT_EQ(&e20,  *it);
+
+// backward from end()
+  auto back = events.end(&cal);
+  --back;
+  ASSERT_EQ(&e40,  *back);
+  got.clear();
+  auto r = events.range(&cal);
+  for(auto j = std::make_reverse_iterator(r.end()); j != std::make_reverse_iterator(r.begin()); ++j)
+    got.push_back(*j);
+  ASSERT_EQ((std::vector<Event*>{&e40, &e30, &e20b, &e20, &e10}), got);
+  got.clear();
+  auto r2 = events.range(&cal, &k, &k50);   /* end() of the range is NULL */
+  for(auto j = std::make_reverse_iterator(r2.end()); j != std::make_reverse_iterator(r2.begin()); ++j)
+    got.push_back(*j);
+  ASSERT_EQ((std::vector<Event*>{&e40, &e30, &e20b, &e20}), got);
+
+// del while iterating
+  i.start(&cal);
+  for(Event* e; (e = ++i); ) if( e->time == 20 ) events.del(&cal, e);
+  ASSERT_EQ(3, events.num(&cal));
+  ASSERT_EQ(NULL, events.sel(&cal, &k));
+  ASSERT_LT(0, events.check(&cal));
+  events.del(&cal, &e20);   /* ignored: not added */
+  ASSERT_EQ(3, events.num(&cal));
+
+  events.del(&cal, &e10); events.del(&cal, &e30); events.del(&cal, &e40);
+  ASSERT_EQ(0, events.num(&cal));
+  ASSERT_EQ(NULL, events.first(&cal));
+}
+
+TEST(RBTree, random_vs_multiset){
+  const int           n = 20000;
+  Calendar            cal;
+  std::vector<Event>  ev(n);
+  std::vector<bool>   in(n);
+  std::multiset<int>  ref;
+  std::mt19937        rnd(1);
+
+  for(int round=0; round < 4; round++){
+    for(int j=0; j < n; j++){
+      if( !in[j] && rnd() % 3 ){
+        ev[j].time = rnd() % (n / 2);
+        events.add(&cal, &ev[j]);
+        ref.insert(ev[j].time);
+        in[j] = true;
+      }else if( in[j] && rnd() % 2 ){
+        events.del(&cal, &ev[j]);
+        ref.erase(ref.find(ev[j].time));
+        in[j] = false;
+      }
+    }
+    ASSERT_LT(0, events.check(&cal));
+    ASSERT_EQ((int)ref.size(), events.num(&cal));
+
+    auto r = ref.begin();
+    for(Event* e : events.range(&cal)) ASSERT_EQ(*r++, e->time);
+
+    for(int q=0; q < 1000; q++){
+      Event k(rnd() % (n / 2));
+      auto    lb = ref.lower_bound(k.time), ub = ref.upper_bound(k.time);
+      Event*  l  = events.lower_bound(&cal, &k);
+      Event*  u  = events.upper_bound(&cal, &k);
+      ASSERT_EQ(lb == ref.end() ? -1 : *lb, l ? l->time : -1);
+      ASSERT_EQ(ub == ref.end() ? -1 : *ub, u ? u->time : -1);
+    }
+  }
+  while( Event* e = events.first(&cal) ) events.del(&cal, e);
+  ASSERT_EQ(0, events.check(&cal));
+}
+
+int main(int argc, char **argv){
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
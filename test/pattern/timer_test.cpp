@@ -0,0 +1,150 @@
+/*
+NAME
+  timer_test  - hierarchical timer wheel pattern test
+*/
+
+#include <stdio.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "jj/timer.h"
+#include "timer_test.b" /* include Part-B */
+
+// define models
+class Loop : INHERIT_Loop {
+};
+
+class Conn : INHERIT_Conn {
+public:
+  int   no;
+  Conn(int n=0) { no=n; }
+};
+
+// define pattern between models
+jjTimerWheel (timeouts, Loop, Conn);
+timeouts_class timeouts;
+
+/* take all expired by now, in batches of n */
+static std::vector<int> expire(Loop* l, unsigned long now, int n=4){
+  std::vector<int>  v;
+  Conn*             buf[16];
+  int               k;
+  while( (k = timeouts.advance(l, now, buf, n)) > 0 ){
+    for(int i=0; i < k; i++){
+      EXPECT_FALSE(timeouts.pending(buf[i]));
+      EXPECT_LE(timeouts.when(buf[i]), now);
+      v.push_back(buf[i]->no);
+    }
+  }
+  std::sort(v.begin(), v.end());
+  return v;
+}
+
+/*----------------------------------------------------------------------------
+Test Section
+----------------------------------------------------------------------------*/
+TEST(TimerWheel, basic){
+  Loop  l;
+  Conn  c1(1), c2(2), c3(3), c4(4);
+
+  timeouts.schedule(&l, &c1, 10);
+  timeouts.schedule(&l, &c2, 100);
+  timeouts.schedule(&l, &c3, 5000);
+  timeouts.schedule(&l, &c4, 5000);
+  ASSERT_EQ(4, timeouts.num(&l));
+  ASSERT_TRUE(timeouts.pending(&c1));
+
+  ASSERT_EQ((std::vector<int>{}), expire(&l, 9));
+  ASSERT_EQ(9UL, timeouts.now(&l));
+  ASSERT_EQ((std::vector<int>{1}), expire(&l, 10));
+
+// cancel, reschedule
+  timeouts.cancel(&l, &c3);
+  timeouts.cancel(&l, &c3);                 /* ignored: not pending */
+  ASSERT_FALSE(timeouts.pending(&c3));
+  timeouts.schedule(&l, &c2, 6000);         /* moved later */
+  ASSERT_EQ(2, timeouts.num(&l));
+  ASSERT_EQ((std::vector<int>{}), expire(&l, 4999));
+  ASSERT_EQ((std::vector<int>{4}), expire(&l, 5999));
+  ASSERT_EQ((std::vector<int>{2}), expire(&l, 6000));
+  ASSERT_EQ(0, timeouts.num(&l));
+
+// past deadline is due at once
+  timeouts.schedule(&l, &c1, 3);
+  ASSERT_EQ((std::vector<int>{1}), expire(&l, timeouts.now(&l)));
+}
+
+TEST(TimerWheel, batch){
+  Loop              l;
+  std::vector<Conn> c(100);
+  Conn*             buf[10];
+
+  for(int i=0; i < 100; i++){
+    c[i].no = i;
+    timeouts.schedule(&l, &c[i], 1000 + i % 3);
+  }
+  ASSERT_EQ(10, timeouts.advance(&l, 2000, buf, 10));
+  ASSERT_EQ(100, timeouts.num(&l) + 10);
+  ASSERT_EQ(90U, expire(&l, 2000).size());
+  ASSERT_EQ(0, timeouts.num(&l));
+}
+
+TEST(TimerWheel, overflow){
+  Loop  l;
+  Conn  c1(1), c2(2), c3(3);
+  unsigned long far = 1UL << 40;
+
+  timeouts.schedule(&l, &c1, far + 7);
+  timeouts.schedule(&l, &c2, far * 3);
+  timeouts.schedule(&l, &c3, 64);
+  ASSERT_EQ((std::vector<int>{3}), expire(&l, far));
+  ASSERT_EQ((std::vector<int>{}), expire(&l, far + 6));
+  ASSERT_EQ((std::vector<int>{1}), expire(&l, far + 7));
+  ASSERT_EQ((std::vector<int>{}), expire(&l, far * 3 - 1));
+  ASSERT_EQ((std::vector<int>{2}), expire(&l, far * 3));
+}
+
+/* random schedule / cancel / advance against a naive model */
+TEST(TimerWheel, random){
+  const int           N = 2000;
+  Loop                l;
+  std::vector<Conn>   c(N);
+  std::vector<long>   when(N, -1);        /* model: -1 if not pending */
+  std::mt19937_64     rnd(42);
+  unsigned long       now = 0;
+
+  for(int i=0; i < N; i++) c[i].no = i;
+
+  for(int round=0; round < 300; round++){
+    for(int j=0; j < 50; j++){
+      int           i     = rnd() % N;
+      unsigned long range = 1UL << (rnd() % 44);
+      switch( rnd() % 3 ){
+      case 0:
+        timeouts.cancel(&l, &c[i]);
+        when[i] = -1;
+        break;
+      default: {
+        unsigned long w = (rnd() % 8 == 0) ? now - (rnd() % (now + 1)) : now + rnd() % range;
+        timeouts.schedule(&l, &c[i], w);
+        when[i] = w;
+      }}
+    }
+    now += (rnd() % 4 == 0) ? rnd() % (1UL << (rnd() % 44)) : rnd() % 200;
+
+    std::vector<int> expect;
+    int              pending = 0;
+    for(int i=0; i < N; i++){
+      if( when[i] >= 0 && (unsigned long)when[i] <= now ){
+        expect.push_back(i);
+        when[i] = -1;
+      }
+      if( when[i] >= 0 ) pending++;
+    }
+    ASSERT_EQ(expect, expire(&l, now, 1 + rnd() % 16));
+    ASSERT_EQ(pending, timeouts.num(&l));
+    for(int i=0; i < N; i++)
+      ASSERT_EQ(when[i] >= 0, timeouts.pending(&c[i]));
+  }
+}
@@ -0,0 +1,101 @@
+/*
+NAME
+  unionfind_test  - disjoint-set pattern test
+*/
+
+#include <stdio.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "jj/unionfind.h"
+#include "unionfind_test.b" /* include Part-B */
+
+// define models
+class Net : INHERIT_Net {
+};
+
+class Host : INHERIT_Host {
+public:
+  int   no;
+  Host(int n=0) { no=n; }
+};
+
+// define pattern between models
+jjUnionFind (comps, Net, Host);
+comps_class comps;
+
+static std::vector<int> members(Host* h){
+  std::vector<int> v;
+  comps_class::Iter i(h);
+  for(Host* p; (p = ++i); ) v.push_back(p->no);
+  std::sort(v.begin(), v.end());
+  return v;
+}
+
+/*----------------------------------------------------------------------------
+Test Section
+----------------------------------------------------------------------------*/
+TEST(UnionFind, basic){
+  Net   n;
+  Host  h[6] = {Host(0), Host(1), Host(2), Host(3), Host(4), Host(5)};
+  Host  other(9);
+
+  for(int i=0; i < 6; i++) comps.add(&n, &h[i]);
+  comps.add(&n, &h[0]);                     /* ignored: already added */
+  ASSERT_EQ(6, comps.num(&n));
+  ASSERT_EQ(6, comps.sets(&n));
+  ASSERT_EQ(&h[3], comps.find(&h[3]));
+  ASSERT_EQ((std::vector<int>{3}), members(&h[3]));
+
+  ASSERT_TRUE(comps.unite(&n, &h[0], &h[1]));
+  ASSERT_TRUE(comps.unite(&n, &h[2], &h[3]));
+  ASSERT_TRUE(comps.unite(&n, &h[1], &h[3]));
+  ASSERT_FALSE(comps.unite(&n, &h[0], &h[2]));  /* already same */
+  ASSERT_EQ(3, comps.sets(&n));
+  ASSERT_TRUE(comps.same(&h[0], &h[3]));
+  ASSERT_FALSE(comps.same(&h[0], &h[4]));
+  ASSERT_EQ(4, comps.size(&h[2]));
+  ASSERT_EQ((std::vector<int>{0, 1, 2, 3}), members(&h[2]));
+  ASSERT_EQ((std::vector<int>{5}), members(&h[5]));
+
+// not added
+  ASSERT_EQ(NULL, comps.find(&other));
+  ASSERT_FALSE(comps.unite(&n, &h[0], &other));
+  ASSERT_FALSE(comps.same(&other, &other));
+  ASSERT_EQ(0, comps.size(&other));
+  ASSERT_EQ((std::vector<int>{}), members(&other));
+}
+
+/* random unions against a naive component labelling */
+TEST(UnionFind, random){
+  const int         N = 2000;
+  Net               n;
+  std::vector<Host> h(N);
+  std::vector<int>  label(N);
+  std::mt19937      rnd(5);
+  long              sets = N;
+
+  for(int i=0; i < N; i++){
+    h[i].no   = i;
+    label[i]  = i;
+    comps.add(&n, &h[i]);
+  }
+  for(int round=0; round < 3000; round++){
+    int a = rnd() % N, b = rnd() % N;
+    bool merged = label[a] != label[b];
+    if( merged ){
+      int from = label[b];
+      for(int i=0; i < N; i++) if( label[i] == from ) label[i] = label[a];
+      sets--;
+    }
+    ASSERT_EQ(merged, comps.unite(&n, &h[a], &h[b]));
+    ASSERT_EQ(sets, comps.sets(&n));
+
+    int c = rnd() % N;
+    std::vector<int> expect;
+    for(int i=0; i < N; i++) if( label[i] == label[c] ) expect.push_back(i);
+    ASSERT_EQ((int)expect.size(), comps.size(&h[c]));
+    if( round % 100 == 0 ){ ASSERT_EQ(expect, members(&h[c])); }
+  }
+}